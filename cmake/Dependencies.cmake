@@ -99,6 +99,8 @@ set(TARGET_SAMPLES OFF CACHE BOOL "" FORCE)
 set(TARGET_VIEWER OFF CACHE BOOL "" FORCE)
 set(BUILD_SHARED_LIBS OFF CACHE BOOL "" FORCE)
 set(INTERPROCEDURAL_OPTIMIZATION OFF CACHE BOOL "" FORCE)
+# Jolt's built-in profiler is replaced by the external hooks (JPH_EXTERNAL_PROFILE) routed into vortex::core::Profiler.
+set(PROFILER_IN_DEBUG_AND_RELEASE OFF CACHE BOOL "" FORCE)
 
 FetchContent_Declare(
     jolt_physics
@@ -115,11 +117,13 @@ endif()
 
 # Robust target check and alias creation
 if(TARGET Jolt)
+    target_compile_definitions(Jolt PUBLIC JPH_EXTERNAL_PROFILE)
     if(NOT TARGET JoltPhysics)
         add_library(JoltPhysics ALIAS Jolt)
     endif()
     message(STATUS "VORTEX: Jolt Physics target 'Jolt' successfully aliased.")
 elseif(TARGET jolt)
+    target_compile_definitions(jolt PUBLIC JPH_EXTERNAL_PROFILE)
     if(NOT TARGET JoltPhysics)
         add_library(JoltPhysics ALIAS jolt)
     endif()
@@ -4,7 +4,7 @@
 /**
  * @brief Voxel Raymarching Fragment Shader.
  * @details Supports Global Inter-Object Shadows via BVH TLAS Traversal.
- * Includes Domain-Aware Cache Optimization (Morton Encoding) and Stochastic Sampling.
+ * Includes Domain-Aware Cache Optimization (Morton / Brick layouts) and Stochastic Sampling.
  * Optimized for performance on integrated graphics.
  */
 
@@ -16,8 +16,21 @@ layout(location = 1) in vec3 v_LocalPos;
 layout(location = 0) out vec4 outColor;
 
 // --- Configuration ---
-// ENABLED: Z-Order Curve memory layout for better cache locality.
-#define USE_MORTON_LAYOUT 
+// Chunk memory layout and dimensions are injected by ShaderCompiler from the C++ build
+// (VORTEX_CHUNK_LAYOUT, VORTEX_CHUNK_SIZE). Fallback for standalone compilation (e.g. glslangValidator): Morton, 32^3.
+#ifndef VORTEX_CHUNK_LAYOUT
+    #define CHUNK_LAYOUT_LINEAR 0
+    #define CHUNK_LAYOUT_MORTON 1
+    #define CHUNK_LAYOUT_BRICK 2
+    #define VORTEX_CHUNK_LAYOUT CHUNK_LAYOUT_MORTON
+#endif
+#ifndef VORTEX_CHUNK_SIZE
+    #define VORTEX_CHUNK_SIZE 32
+    #define CHUNK_BLOCKS 8
+    #define CHUNK_WORDS 8192
+    #define CHUNK_FLAG_WORDS 2048
+    #define HIERARCHY_WORDS 16
+#endif
 
 // --- Structures ---
 
@@ -35,12 +48,14 @@ struct Object {
     uint paletteOffset;
     uint flags;
     uint _pad;
+    vec4 boundsMin; // xyz: tight occupied bounds in chunk-local voxels
+    vec4 boundsMax;
 };
 
 struct Chunk {
-    uint voxelIDs[8192];  
-    uint voxelFlags[2048]; 
-    uint hierarchy[16];    
+    uint voxelIDs[CHUNK_WORDS];  
+    uint voxelFlags[CHUNK_FLAG_WORDS]; 
+    uint hierarchy[HIERARCHY_WORDS];    
 };
 
 struct BVHNode {
@@ -109,20 +124,29 @@ float InterleavedGradientNoise(vec2 position) {
 bool IsBlockOccupied(uint chunkIdx, ivec3 mapPos) {
     // Hierarchy uses LINEAR layout (as per C++ implementation)
     ivec3 bPos = mapPos >> 2; 
-    uint hIndex = bPos.x + bPos.y * 8 + bPos.z * 64;
+    uint hIndex = bPos.x + bPos.y * CHUNK_BLOCKS + bPos.z * CHUNK_BLOCKS * CHUNK_BLOCKS;
     return (chunkBuffer.chunks[chunkIdx].hierarchy[hIndex >> 5] & (1u << (hIndex & 31))) != 0;
 }
 
-uint GetVoxel(uint chunkIdx, ivec3 pos) {
-    #ifdef USE_MORTON_LAYOUT
-        uint mIndex = Morton3D(uvec3(pos));
-        return (chunkBuffer.chunks[chunkIdx].voxelIDs[mIndex >> 2] >> ((mIndex & 3) << 3)) & 0xFF;
+// Storage index of a voxel, must match ActiveLayout::VoxelIndex in Chunk.cppm.
+uint VoxelIndex(ivec3 pos) {
+    #if VORTEX_CHUNK_LAYOUT == CHUNK_LAYOUT_MORTON
+        return Morton3D(uvec3(pos));
+    #elif VORTEX_CHUNK_LAYOUT == CHUNK_LAYOUT_BRICK
+        // 4x4x4 bricks in hierarchy order, 64 bytes (one cache line) each.
+        ivec3 b = pos >> 2;
+        ivec3 l = pos & 3;
+        return uint((b.x + b.y * CHUNK_BLOCKS + b.z * CHUNK_BLOCKS * CHUNK_BLOCKS) * 64 + l.x + l.y * 4 + l.z * 16);
     #else
-        uint index = pos.x + pos.y * 32 + pos.z * 1024;
-        return (chunkBuffer.chunks[chunkIdx].voxelIDs[index >> 2] >> ((index & 3) << 3)) & 0xFF;
+        return uint(pos.x + pos.y * VORTEX_CHUNK_SIZE + pos.z * VORTEX_CHUNK_SIZE * VORTEX_CHUNK_SIZE);
     #endif
 }
 
+uint GetVoxel(uint chunkIdx, ivec3 pos) {
+    uint index = VoxelIndex(pos);
+    return (chunkBuffer.chunks[chunkIdx].voxelIDs[index >> 2] >> ((index & 3) << 3)) & 0xFF;
+}
+
 // Improved AABB intersection
 bool IntersectAABB(vec3 ro, vec3 rd, vec3 boxMin, vec3 boxMax, out float tNear, out float tFar, out vec3 normal) {
     vec3 invDir = 1.0 / rd;
@@ -159,13 +183,10 @@ bool IntersectAABB_Shadow(vec3 ro, vec3 rd, vec3 boxMin, vec3 boxMax, out float
     return t1 >= t0 && t1 > 0.0;
 }
 
-bool TraceShadowChunk(vec3 ro, vec3 rd, uint chunkIdx, float maxDist) {
+// bmin/bmax: the object's occupied voxel bounds; the march stops as soon as it leaves them.
+bool TraceShadowChunk(vec3 ro, vec3 rd, uint chunkIdx, float maxDist, ivec3 bmin, ivec3 bmax) {
     ivec3 mapPos = ivec3(floor(ro));
-    
-    // Safety check for start pos
-    if (mapPos.x < 0 || mapPos.x >= 32 || mapPos.y < 0 || mapPos.y >= 32 || mapPos.z < 0 || mapPos.z >= 32) {
-       // Should rely on AABB intersection to provide valid entry
-    }
+    // Entry comes from the AABB intersection, so mapPos starts inside the bounds (up to rounding).
 
     vec3 deltaDist = abs(1.0 / rd);
     ivec3 stepDir = ivec3(sign(rd));
@@ -175,10 +196,10 @@ bool TraceShadowChunk(vec3 ro, vec3 rd, uint chunkIdx, float maxDist) {
     sideDist.y = (sign(rd.y) * (vec3(mapPos).y - ro.y) + (sign(rd.y) * 0.5) + 0.5) * deltaDist.y;
     sideDist.z = (sign(rd.z) * (vec3(mapPos).z - ro.z) + (sign(rd.z) * 0.5) + 0.5) * deltaDist.z;
 
-    const int MAX_SHADOW_STEPS = 32; 
+    const int MAX_SHADOW_STEPS = VORTEX_CHUNK_SIZE; 
 
     for (int i = 0; i < MAX_SHADOW_STEPS; i++) {
-        if (mapPos.x < 0 || mapPos.x >= 32 || mapPos.y < 0 || mapPos.y >= 32 || mapPos.z < 0 || mapPos.z >= 32) return false;
+        if (any(lessThan(mapPos, bmin)) || any(greaterThanEqual(mapPos, bmax))) return false;
         
         if (IsBlockOccupied(chunkIdx, mapPos)) {
             uint voxel = GetVoxel(chunkIdx, mapPos);
@@ -244,12 +265,12 @@ float CalculateGlobalShadow(vec3 worldPos, vec3 lightDir, float noise) {
                 vec3 localRd = normalize(mat3(obj.invModel) * lightDir);
 
                 float tn, tf;
-                if (IntersectAABB_Shadow(localRo, localRd, vec3(0.0), vec3(32.0), tn, tf)) {
+                if (IntersectAABB_Shadow(localRo, localRd, obj.boundsMin.xyz, obj.boundsMax.xyz, tn, tf)) {
                     vec3 marchStart = localRo;
                     if (tn > 0.0) marchStart += localRd * (tn + 1e-4);
                     float maxDist = (tn > 0.0) ? (tf - tn) : tf;
 
-                    if (TraceShadowChunk(marchStart, localRd, obj.chunkIndex, maxDist)) {
+                    if (TraceShadowChunk(marchStart, localRd, obj.chunkIndex, maxDist, ivec3(obj.boundsMin.xyz), ivec3(obj.boundsMax.xyz))) {
                         return 0.0; 
                     }
                 }
@@ -276,7 +297,9 @@ void main() {
 
     float tNear, tFar;
     vec3 entryNormal;
-    if (!IntersectAABB(localCamPos, localDir, vec3(0.0), vec3(32.0), tNear, tFar, entryNormal)) {
+    ivec3 boundsMin = ivec3(obj.boundsMin.xyz);
+    ivec3 boundsMax = ivec3(obj.boundsMax.xyz);
+    if (!IntersectAABB(localCamPos, localDir, obj.boundsMin.xyz, obj.boundsMax.xyz, tNear, tFar, entryNormal)) {
         discard;
     }
     
@@ -284,7 +307,7 @@ void main() {
     vec3 rayPos = localCamPos + localDir * (tStart + 1e-4);
     
     ivec3 mapPos = ivec3(floor(rayPos));
-    mapPos = clamp(mapPos, ivec3(0), ivec3(31));
+    mapPos = clamp(mapPos, boundsMin, boundsMax - 1);
 
     vec3 safeDir = localDir;
     if (abs(safeDir.x) < 1e-5) safeDir.x = 1e-5;
@@ -303,10 +326,10 @@ void main() {
 
     mat3 normalMatrix = transpose(mat3(obj.invModel));
 
-    const int MAX_STEPS = 96; 
+    const int MAX_STEPS = VORTEX_CHUNK_SIZE * 3; 
     
     for (int i = 0; i < MAX_STEPS; i++) {
-        if (mapPos.x < 0 || mapPos.x >= 32 || mapPos.y < 0 || mapPos.y >= 32 || mapPos.z < 0 || mapPos.z >= 32) break;
+        if (any(lessThan(mapPos, boundsMin)) || any(greaterThanEqual(mapPos, boundsMax))) break;
 
         if (IsBlockOccupied(obj.chunkIndex, mapPos)) {
             uint voxel = GetVoxel(obj.chunkIndex, mapPos);
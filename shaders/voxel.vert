@@ -19,6 +19,8 @@ struct Object {
     uint paletteOffset;
     uint flags;
     uint _pad;
+    vec4 boundsMin; // xyz: tight occupied bounds in chunk-local voxels
+    vec4 boundsMax;
 };
 
 /**
@@ -37,10 +39,21 @@ layout(binding = 2, std430) readonly buffer Objects {
     Object objects[];
 } objBuffer;
 
-// Cube vertices (0..32 range)
+// Object index per instance, nearest first.
+layout(binding = 6, std430) readonly buffer DrawOrder {
+    uint objectIndices[];
+} drawOrder;
+
+// Chunk edge length, injected by ShaderCompiler (fallback for standalone compilation).
+#ifndef VORTEX_CHUNK_SIZE
+    #define VORTEX_CHUNK_SIZE 32
+#endif
+
+// Cube vertices (0..VORTEX_CHUNK_SIZE range)
+const float CHUNK_EXTENT = float(VORTEX_CHUNK_SIZE);
 const vec3 CUBE_VERTS[8] = vec3[](
-    vec3(0, 0, 0), vec3(32, 0, 0), vec3(0, 32, 0), vec3(32, 32, 0),
-    vec3(0, 0, 32), vec3(32, 0, 32), vec3(0, 32, 32), vec3(32, 32, 32)
+    vec3(0, 0, 0), vec3(CHUNK_EXTENT, 0, 0), vec3(0, CHUNK_EXTENT, 0), vec3(CHUNK_EXTENT, CHUNK_EXTENT, 0),
+    vec3(0, 0, CHUNK_EXTENT), vec3(CHUNK_EXTENT, 0, CHUNK_EXTENT), vec3(0, CHUNK_EXTENT, CHUNK_EXTENT), vec3(CHUNK_EXTENT, CHUNK_EXTENT, CHUNK_EXTENT)
 );
 
 /**
@@ -63,12 +76,13 @@ const int CUBE_INDICES[36] = int[](
 );
 
 void main() {
-    v_InstanceIndex = gl_InstanceIndex;
+    v_InstanceIndex = drawOrder.objectIndices[gl_InstanceIndex];
     
     Object obj = objBuffer.objects[v_InstanceIndex];
     
     int vertexIndex = CUBE_INDICES[gl_VertexIndex];
-    vec3 localPos = CUBE_VERTS[vertexIndex];
+    // Shrink the proxy cube to the occupied bounds, so empty space is neither rasterized nor marched.
+    vec3 localPos = mix(obj.boundsMin.xyz, obj.boundsMax.xyz, CUBE_VERTS[vertexIndex] / CHUNK_EXTENT);
     v_LocalPos = localPos;
 
     vec4 worldPos = obj.model * vec4(localPos, 1.0);
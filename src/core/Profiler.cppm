@@ -9,7 +9,8 @@ namespace vortex::core {
     /**
      * @brief Static class for performance profiling and timing.
      * @details Collects execution times of named sections and renders them using ImGui.
-     * Stores history for real-time graphing.
+     * Stores history for real-time graphing. Thread-safe: scopes may be opened on job threads.
+     * Names of the form "Group: Section" are displayed under a collapsible group.
      */
     export class Profiler {
     public:
@@ -39,6 +40,14 @@ namespace vortex::core {
          */
         static void AddSample(const std::string& name, float timeMs);
 
+        /**
+         * @brief Adds a sample of a metric that is not a time (counts, sizes, ratios).
+         * @param name Name of the metric.
+         * @param value Sample value.
+         * @param unit Shown after the value instead of "ms" (e.g. "slots", "%").
+         */
+        static void AddValue(const std::string& name, float value, const std::string& unit);
+
         /**
          * @brief Renders the profiling data as ImGui graphs.
          * @details Creates a new ImGui window "Performance Profiler".
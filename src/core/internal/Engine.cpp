@@ -7,10 +7,12 @@ module;
 #include <vector> 
 #include <string> 
 #include <algorithm> 
+#include <unordered_map>
 #include <GLFW/glfw3.h>
 #include <imgui.h> 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 module vortex.core;
 
@@ -19,6 +21,7 @@ import vortex.graphics;
 import vortex.voxel;
 import vortex.editor; 
 import vortex.physics; 
+import vortex.jobs;
 import :camera;
 import :profiller;
 
@@ -28,6 +31,11 @@ namespace vortex {
         physics::BodyHandle bodyHandle;
         bool lastStaticState;
         bool lastTriggerState;
+        bool lastKinematicState = false;
+
+        // Range of SceneManager object slots owned by this entity (one per chunked part).
+        uint32_t renderSlot = 0;
+        uint32_t renderSlotCount = 0;
 
         SimulationObject(std::shared_ptr<voxel::VoxelEntity> e, physics::BodyHandle h, bool isStatic, bool isTrigger)
             : entity(e), bodyHandle(h), lastStaticState(isStatic), lastTriggerState(isTrigger) {}
@@ -41,8 +49,147 @@ namespace vortex {
         physics::PhysicsSystem physicsSystem;
         std::vector<SimulationObject> simObjects;
 
+        // --- Transform Sync ---
+        physics::ActiveTransformBuffer activeTransforms;
+        std::unordered_map<uint32_t, size_t> bodyToSimObject;
+        bool renderSlotsDirty = true;
+
+        // Scratch buffers for forwarding Jolt profile zones.
+        std::vector<physics::PhysicsProfileZone> physicsZones;
+        std::vector<physics::PhysicsThreadTime> physicsThreads;
+
+        /**
+         * @brief Recomputes render slot ranges and the body -> simObject lookup.
+         * @details Slots follow simObjects order, matching the order objects are uploaded in.
+         */
+        void RebuildRenderSlots() {
+            bodyToSimObject.clear();
+            uint32_t slot = 0;
+            for (size_t i = 0; i < simObjects.size(); ++i) {
+                auto& simObj = simObjects[i];
+                simObj.renderSlot = slot;
+                simObj.renderSlotCount = 0;
+                if (simObj.entity) {
+                    for (const auto& part : simObj.entity->parts) {
+                        if (part->chunk) simObj.renderSlotCount++;
+                    }
+                }
+                slot += simObj.renderSlotCount;
+                if (simObj.bodyHandle.IsValid()) bodyToSimObject[simObj.bodyHandle.id] = i;
+            }
+            renderSlotsDirty = false;
+        }
+
+        void WriteRenderSlots(graphics::SceneManager& sceneManager, const SimulationObject& simObj) {
+            glm::mat4 rootTransform = simObj.entity->transform;
+            uint32_t slot = simObj.renderSlot;
+            for (const auto& part : simObj.entity->parts) {
+                if (part->chunk) {
+                    sceneManager.SetObjectTransform(slot++, rootTransform * part->GetTransformMatrix());
+                }
+            }
+        }
+
+        // --- Scene Sync ---
+        // Editor changes that need an upload; Transform is served by the render slot writes in UpdateSystems.
+        static constexpr uint32_t UPLOAD_CHANGES = editor::SceneChange::Voxels | editor::SceneChange::Structure;
+
+        // Scratch for SyncScene. Objects follow editor entity order, which is also render slot order.
+        std::vector<graphics::SceneObject> sceneObjects;
+        std::vector<voxel::Chunk*> sceneChunks;
+        std::vector<voxel::PhysicalMaterial> sceneMaterials;
+        std::vector<uint32_t> entityPaletteOffsets;
+
+        static void ApplyPartShape(graphics::SceneObject& obj, const voxel::VoxelObject& part) {
+            const voxel::ChunkStats& stats = part.chunk->GetStats();
+            obj.boundsMin = glm::vec3(stats.boundsMin);
+            obj.boundsMax = glm::vec3(stats.boundsMax);
+            obj.voxelCount = part.voxelCount;
+            obj.logicalCenter = part.logicalCenter;
+        }
+
+        /**
+         * @brief Global materials followed by each mesh entity's palette; fills entityPaletteOffsets.
+         */
+        void RebuildSceneMaterials() {
+            sceneMaterials = persistentMaterials;
+            if (sceneMaterials.empty()) {
+                voxel::PhysicalMaterial defMat{};
+                defMat.color = glm::vec4(1.0f);
+                sceneMaterials.push_back(defMat);
+            }
+
+            const auto& entities = editor.GetEntities();
+            entityPaletteOffsets.resize(entities.size());
+            for (size_t e = 0; e < entities.size(); ++e) {
+                auto dynMesh = std::dynamic_pointer_cast<voxel::DynamicMeshObject>(entities[e]);
+                if (dynMesh && !dynMesh->materials.empty()) {
+                    // Palette index 1 is the mesh's first material (0 is air).
+                    entityPaletteOffsets[e] = (uint32_t)sceneMaterials.size() - 1;
+                    sceneMaterials.insert(sceneMaterials.end(), dynMesh->materials.begin(), dynMesh->materials.end());
+                } else {
+                    entityPaletteOffsets[e] = 0;
+                }
+            }
+        }
+
+        void CollectSceneChunks() {
+            sceneChunks.clear();
+            for (const auto& entity : editor.GetEntities()) {
+                for (const auto& part : entity->parts) {
+                    if (part->chunk) sceneChunks.push_back(part->chunk.get());
+                }
+            }
+        }
+
+        /**
+         * @brief Uploads pending editor changes, taking the cheapest path for each change class.
+         * @details Structure rebuilds the object list and materials (palettes only change with the entities that
+         * own them); otherwise Voxels only sends dirty chunk ranges and refreshes object bounds.
+         */
+        void SyncScene() {
+            auto& sceneManager = graphicsContext->GetSceneManager();
+            const auto& entities = editor.GetEntities();
+
+            if (editor.HasSceneChange(editor::SceneChange::Structure)) {
+                RebuildSceneMaterials();
+                sceneObjects.clear();
+                for (size_t e = 0; e < entities.size(); ++e) {
+                    glm::mat4 root = entities[e]->transform;
+                    for (const auto& part : entities[e]->parts) {
+                        if (!part->chunk) continue;
+                        graphics::SceneObject obj;
+                        obj.model = root * part->GetTransformMatrix();
+                        ApplyPartShape(obj, *part);
+                        obj.chunk = part->chunk.get();
+                        obj.paletteOffset = entityPaletteOffsets[e];
+                        sceneObjects.push_back(obj);
+                    }
+                }
+                CollectSceneChunks();
+                graphicsContext->UploadScene(sceneObjects, sceneMaterials, sceneChunks);
+                renderSlotsDirty = true;
+            } else if (editor.HasSceneChange(editor::SceneChange::Voxels)) {
+                int slot = 0;
+                graphics::SceneObject shape;
+                for (const auto& entity : entities) {
+                    for (const auto& part : entity->parts) {
+                        if (!part->chunk) continue;
+                        // Only edited chunks can have a new shape; UploadChunks below clears their dirty masks.
+                        if (!part->chunk->IsDirty()) { slot++; continue; }
+                        ApplyPartShape(shape, *part);
+                        sceneManager.SetObjectShape(slot++, shape.boundsMin, shape.boundsMax, shape.voxelCount, shape.logicalCenter);
+                    }
+                }
+                // Unchanged chunks cost a mask check; edited ones send only their dirty blocks.
+                CollectSceneChunks();
+                sceneManager.UploadChunks(sceneChunks);
+            }
+
+            editor.ClearSceneChanges(UPLOAD_CHANGES);
+        }
+
         std::vector<graphics::SceneObject> persistentObjects;
-        std::vector<voxel::Chunk> persistentChunks;
         std::vector<voxel::PhysicalMaterial> persistentMaterials;
         
         // --- Lighting Settings (Restored) ---
@@ -65,6 +212,7 @@ namespace vortex {
 
     bool Engine::Initialize(const std::string& title, uint32_t width, uint32_t height) {
         if (!m_State->graphicsContext->Initialize(title, width, height)) return false;
+        jobs::JobSystem::Initialize();
         m_State->physicsSystem.Initialize();
         return true;
     }
@@ -113,7 +261,7 @@ namespace vortex {
 
         entity->isStatic = isStatic;
         m_State->editor.GetEntities().push_back(entity);
-        m_State->editor.MarkDirty();
+        m_State->editor.MarkChanged(editor::SceneChange::Structure);
         
         auto handle = m_State->physicsSystem.AddBody(entity, isStatic);
         
@@ -128,6 +276,7 @@ namespace vortex {
         }
 
         m_State->simObjects.emplace_back(entity, handle, isStatic, entity->isTrigger);
+        m_State->renderSlotsDirty = true;
     }
 
     void Engine::Run(std::function<void()> onGuiRender) {
@@ -176,48 +325,9 @@ namespace vortex {
                 UpdateSystems(deltaTime);
             }
 
-            if (m_State->editor.IsSceneDirty()) {
+            if (m_State->editor.GetSceneChanges() & InternalState::UPLOAD_CHANGES) {
                 core::ProfileScope p("CPU: Scene Upload");
-                
-                std::vector<graphics::SceneObject> objects;
-                std::vector<voxel::Chunk> chunks; 
-                
-                std::vector<voxel::PhysicalMaterial> finalMaterials = m_State->persistentMaterials; 
-                
-                if (finalMaterials.empty()) {
-                    voxel::PhysicalMaterial defMat{};
-                    defMat.color = glm::vec4(1.0f);
-                    finalMaterials.push_back(defMat);
-                }
-
-                for (const auto& entity : m_State->editor.GetEntities()) {
-                    glm::mat4 root = entity->transform;
-                    uint32_t currentPaletteOffset = 0; 
-                    
-                    auto dynMesh = std::dynamic_pointer_cast<voxel::DynamicMeshObject>(entity);
-                    if (dynMesh && !dynMesh->materials.empty()) {
-                        currentPaletteOffset = (uint32_t)finalMaterials.size() - 1;
-                        finalMaterials.insert(finalMaterials.end(), dynMesh->materials.begin(), dynMesh->materials.end());
-                    } else {
-                        currentPaletteOffset = 0; 
-                    }
-
-                    for (const auto& part : entity->parts) {
-                        if (!part->chunk) continue;
-                        
-                        graphics::SceneObject obj;
-                        obj.model = root * part->GetTransformMatrix();
-                        obj.logicalCenter = part->logicalCenter;
-                        obj.voxelCount = part->voxelCount;
-                        obj.chunkIndex = (uint32_t)chunks.size(); 
-                        chunks.push_back(*part->chunk);
-                        obj.paletteOffset = currentPaletteOffset;
-                        objects.push_back(obj);
-                    }
-                }
-
-                m_State->graphicsContext->UploadScene(objects, finalMaterials, chunks);
-                m_State->editor.ResetSceneDirty();
+                m_State->SyncScene();
             }
 
             m_State->graphicsContext->BeginRecording();
@@ -228,6 +338,7 @@ namespace vortex {
                 core::ProfileScope p("CPU: GUI Render");
                 ImGui::Begin("Voxel Stats");
                 if (onGuiRender) onGuiRender();
+                ImGui::Text("Last Chunk Upload: %.1f KB", m_State->graphicsContext->GetSceneManager().GetLastChunkUploadBytes() / 1024.0f);
                 ImGui::Separator();
                 
                 if (ImGui::CollapsingHeader("Lighting", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -238,11 +349,30 @@ namespace vortex {
                     ImGui::ColorEdit3("Sun Color", m_State->sunColor);
                 }
 
+                if (ImGui::CollapsingHeader("Physics")) {
+                    physics::PhysicsStats stats = m_State->physicsSystem.GetStats();
+                    const physics::PhysicsConfig& config = m_State->physicsSystem.GetConfig();
+                    ImGui::Text("Bodies: %u / %u (active %u)", stats.bodyCount, config.maxBodies, stats.activeBodyCount);
+                    ImGui::Text("Body Pairs: %u (peak %u / %u)", stats.bodyPairs, stats.bodyPairsPeak, config.maxBodyPairs);
+                    ImGui::Text("Contacts: %u (peak %u / %u)", stats.contactConstraints, stats.contactConstraintsPeak, config.maxContactConstraints);
+                    ImGui::Text("Temp Alloc Peak: %.2f / %.2f MB", stats.tempAllocatorUsagePeak / (1024.0f * 1024.0f), stats.tempAllocatorCapacity / (1024.0f * 1024.0f));
+                    if (stats.tempAllocatorFallbacks > 0 || stats.capacityErrors > 0) {
+                        ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.2f, 1.0f), "Overflows: %u temp, %u capacity", stats.tempAllocatorFallbacks, stats.capacityErrors);
+                    }
+                }
+
                 static int currentAA = 1;
                 const char* aaModes[] = { "None", "FXAA", "TAA" };
                 if (ImGui::Combo("Anti-Aliasing", &currentAA, aaModes, IM_ARRAYSIZE(aaModes))) {
                     m_State->graphicsContext->SetAAMode((vortex::graphics::AntiAliasingMode)currentAA);
                 }
+
+                auto& sceneManager = m_State->graphicsContext->GetSceneManager();
+                int drawOrder = (int)sceneManager.GetDrawOrderMode();
+                const char* drawOrderModes[] = { "Exact", "Buckets" };
+                if (ImGui::Combo("Draw Order", &drawOrder, drawOrderModes, IM_ARRAYSIZE(drawOrderModes))) {
+                    sceneManager.SetDrawOrderMode((vortex::graphics::DepthSortMode)drawOrder);
+                }
                 ImGui::End();
 
                 core::Profiler::Render();
@@ -255,6 +385,26 @@ namespace vortex {
             float gpuAA = m_State->graphicsContext->GetAAGPUTime();
             core::Profiler::AddSample("GPU: Geometry (Raymarch)", gpuScene);
             core::Profiler::AddSample("GPU: AA/Post", gpuAA);
+
+            graphics::ChunkSlotStats slots = m_State->graphicsContext->GetSceneManager().GetChunkSlotStats();
+            core::Profiler::AddValue("Chunks: Slots Used", (float)slots.used, "/ " + std::to_string(slots.capacity));
+            core::Profiler::AddValue("Chunks: Fragmentation", slots.Fragmentation() * 100.0f, "%");
+
+            graphics::TLASUpdateStats tlas = m_State->graphicsContext->GetSceneManager().GetTLASStats();
+            core::Profiler::AddSample("CPU: TLAS Update", tlas.updateMs);
+            core::Profiler::AddValue("TLAS: Refit Objects", (float)tlas.refitObjects, tlas.rebuilt ? "(rebuilt)" : "objects");
+            core::Profiler::AddValue("TLAS: Nodes Written", (float)tlas.nodesWritten, "nodes");
+            core::Profiler::AddValue("TLAS: Degradation", tlas.degradation, "x SAH");
+
+            graphics::CullStats cull = m_State->graphicsContext->GetSceneManager().GetCullStats();
+            core::Profiler::AddSample("CPU: Frustum Cull", cull.cullMs);
+            core::Profiler::AddValue("Culling: Visible Objects", (float)cull.visible, "/ " + std::to_string(cull.total));
+
+            graphics::StagingStats upload = m_State->graphicsContext->GetUploadStats();
+            core::Profiler::AddValue("Upload: Bandwidth", deltaTime > 0.0f ? upload.bytes / (1024.0f * 1024.0f) / deltaTime : 0.0f, "MB/s");
+            core::Profiler::AddValue("Upload: Staged", upload.bytes / 1024.0f, "KB");
+            core::Profiler::AddValue("Upload: Ring Stalls", (float)upload.stalls, "waits");
+            core::Profiler::AddSample("Upload: Stall Time", upload.stallMs);
         }
     }
 
@@ -268,6 +418,27 @@ namespace vortex {
         std::vector<physics::BodyHandle> bodiesToRemove;
         std::vector<size_t> indicesToRemove;
 
+        // --- SIT pass (parallel) ---
+        // Each entity's structural check only reads/writes its own chunks, so they run as independent tasks.
+        std::vector<uint8_t> sitFailed(m_State->simObjects.size(), 0);
+        {
+            core::ProfileScope p("CPU: SHRED Integrity");
+            std::vector<size_t> sitCandidates;
+            for (size_t i = 0; i < m_State->simObjects.size(); ++i) {
+                const auto& simObj = m_State->simObjects[i];
+                const auto& entity = simObj.entity;
+                if (!entity || !entity->isDestructible || entity == selectedEntity || entity->shouldCheckConnectivity) continue;
+                sitCandidates.push_back(i);
+            }
+
+            jobs::JobSystem::ParallelFor(sitCandidates.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; ++c) {
+                    size_t i = sitCandidates[c];
+                    sitFailed[i] = voxel::SHREDSystem::ValidateStructuralIntegrity(m_State->simObjects[i].entity, tempPalette) ? 1 : 0;
+                }
+            });
+        }
+
         for (size_t i = 0; i < m_State->simObjects.size(); ++i) {
             auto& simObj = m_State->simObjects[i];
             auto& entity = simObj.entity;
@@ -277,14 +448,8 @@ namespace vortex {
             // --- Check for Destruction or Disconnects ---
             if (entity->isDestructible && entity != selectedEntity) {
                 
-                bool needsConnectivityCheck = entity->shouldCheckConnectivity;
-                
-                // If not manually triggered, check load/stress (SIT)
-                if (!needsConnectivityCheck) {
-                     if (voxel::SHREDSystem::ValidateStructuralIntegrity(entity, tempPalette)) {
-                         needsConnectivityCheck = true;
-                     }
-                }
+                // Manually triggered, or load/stress (SIT) broke voxels in the pass above.
+                bool needsConnectivityCheck = entity->shouldCheckConnectivity || sitFailed[i];
 
                 if (needsConnectivityCheck) {
                     entity->shouldCheckConnectivity = false; // Clear flag
@@ -341,7 +506,7 @@ namespace vortex {
                         // This handles the case where ValidateStructuralIntegrity failed (broken voxels) but object stayed in one piece
                         // OR editor modified it but it's still one piece.
                         entity->shouldRebuildPhysics = true;
-                        m_State->editor.MarkDirty();
+                        m_State->editor.MarkChanged(editor::SceneChange::Voxels);
                     }
                 }
             }
@@ -354,11 +519,14 @@ namespace vortex {
                 entity->shouldRebuildPhysics = false;
                 simObj.lastStaticState = entity->isStatic;
                 simObj.lastTriggerState = entity->isTrigger;
+                simObj.lastKinematicState = false;
+                m_State->renderSlotsDirty = true;
             }
 
             if (entity->isStatic != simObj.lastStaticState) {
                 m_State->physicsSystem.SetBodyType(simObj.bodyHandle, entity->isStatic);
                 simObj.lastStaticState = entity->isStatic;
+                simObj.lastKinematicState = false;
             }
 
             if (entity->isTrigger != simObj.lastTriggerState) {
@@ -368,7 +536,11 @@ namespace vortex {
 
             if (!entity->isStatic) {
                 bool isSelected = (entity == selectedEntity);
-                m_State->physicsSystem.SetBodyKinematic(simObj.bodyHandle, isSelected);
+                // Only touch the motion type on selection changes; doing it every frame keeps bodies awake.
+                if (isSelected != simObj.lastKinematicState) {
+                    m_State->physicsSystem.SetBodyKinematic(simObj.bodyHandle, isSelected);
+                    simObj.lastKinematicState = isSelected;
+                }
 
                 if (isSelected) {
                     m_State->physicsSystem.SetBodyTransform(simObj.bodyHandle, entity->transform);
@@ -384,9 +556,10 @@ namespace vortex {
             auto newEnd = std::remove(editorEntities.begin(), editorEntities.end(), entityPtr);
             if (newEnd != editorEntities.end()) {
                 editorEntities.erase(newEnd, editorEntities.end());
-                m_State->editor.MarkDirty();
+                m_State->editor.MarkChanged(editor::SceneChange::Structure);
             }
         }
+        if (!indicesToRemove.empty()) m_State->renderSlotsDirty = true;
         
         for(auto b : bodiesToRemove) m_State->physicsSystem.RemoveBody(b);
 
@@ -394,28 +567,57 @@ namespace vortex {
             AddEntity(newE, newE->isStatic);
         }
 
-        m_State->physicsSystem.Update(deltaTime);
+        {
+            core::ProfileScope p("CPU: Physics Step");
+            m_State->physicsSystem.Update(deltaTime);
+        }
+
+        // Forward Jolt's internal zones so a slow step can be attributed (broadphase, narrowphase, solver, ...).
+        m_State->physicsSystem.ConsumeProfileData(m_State->physicsZones, m_State->physicsThreads);
+        for (const auto& zone : m_State->physicsZones) {
+            core::Profiler::AddSample("Physics: " + zone.name, zone.timeMs);
+        }
+        for (const auto& thread : m_State->physicsThreads) {
+            std::string label = thread.workerIndex < 0 ? "Main" : "Worker " + std::to_string(thread.workerIndex);
+            core::Profiler::AddSample("Physics: [Thread] " + label, thread.timeMs);
+        }
 
+        core::ProfileScope p("CPU: Transform Sync");
         auto& sceneManager = m_State->graphicsContext->GetSceneManager();
-        int renderIndex = 0;
-        
-        for (const auto& simObj : m_State->simObjects) {
-            auto& entity = simObj.entity;
-            if (!entity) { renderIndex++; continue; }
 
-            if (!entity->isStatic && entity != selectedEntity) {
-                m_State->physicsSystem.SyncBodyTransform(entity, simObj.bodyHandle);
+        // Slot layout changed (add/remove/rebuild): every object has to be rewritten once.
+        bool fullSync = m_State->renderSlotsDirty;
+        if (fullSync) m_State->RebuildRenderSlots();
+
+        // Only awake dynamic bodies, and those that just fell asleep, can have moved since the last frame.
+        auto& active = m_State->activeTransforms;
+        m_State->physicsSystem.ReadActiveTransforms(active);
+
+        for (size_t i = 0; i < active.Size(); ++i) {
+            auto it = m_State->bodyToSimObject.find(active.bodies[i].id);
+            if (it == m_State->bodyToSimObject.end()) continue;
+
+            auto& simObj = m_State->simObjects[it->second];
+            if (!simObj.entity || simObj.entity == selectedEntity) continue;
+
+            simObj.entity->transform = glm::translate(glm::mat4(1.0f), active.positions[i]) * glm::mat4_cast(active.rotations[i]);
+            if (!fullSync) m_State->WriteRenderSlots(sceneManager, simObj);
+        }
+
+        if (fullSync) {
+            for (const auto& simObj : m_State->simObjects) {
+                if (simObj.entity) m_State->WriteRenderSlots(sceneManager, simObj);
             }
-            
-            glm::mat4 rootTransform = entity->transform;
-            for (const auto& part : entity->parts) {
-                if (part->chunk) {
-                    glm::mat4 finalModel = rootTransform * part->GetTransformMatrix();
-                    sceneManager.SetObjectTransform(renderIndex, finalModel);
-                    renderIndex++;
+        } else if (selectedEntity && m_State->editor.HasSceneChange(editor::SceneChange::Transform)) {
+            // The gizmo drives the selected entity directly, bypassing the physics state.
+            for (const auto& simObj : m_State->simObjects) {
+                if (simObj.entity == selectedEntity) {
+                    m_State->WriteRenderSlots(sceneManager, simObj);
+                    break;
                 }
             }
         }
+        m_State->editor.ClearSceneChanges(editor::SceneChange::Transform);
     }
 
     void Engine::UploadScene(
@@ -424,7 +626,6 @@ namespace vortex {
         const std::vector<voxel::Chunk>& chunks
     ) {
         m_State->persistentObjects = objects;
-        m_State->persistentChunks = chunks;
         m_State->persistentMaterials = materials;
         m_State->graphicsContext->UploadScene(objects, materials, chunks);
     }
@@ -432,6 +633,7 @@ namespace vortex {
     void Engine::Shutdown() {
         if (m_State) {
             m_State->physicsSystem.Shutdown();
+            jobs::JobSystem::Shutdown();
             if (m_State->graphicsContext) m_State->graphicsContext->Shutdown();
         }
     }
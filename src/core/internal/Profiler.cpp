@@ -16,11 +16,14 @@ namespace vortex::core {
     struct ProfilerData {
         using Clock = std::chrono::high_resolution_clock;
         
-        // Active timers for the current frame
-        std::unordered_map<std::string, Clock::time_point> startTimes;
+        // Guards history; Begin/End may be called from job threads.
+        std::mutex mutex;
         
         // History of durations for graphs (Name -> Array of milliseconds)
         std::map<std::string, std::vector<float>> history;
+
+        // Unit of metrics added through AddValue; everything else is in milliseconds.
+        std::unordered_map<std::string, std::string> units;
         
         // Max frames to keep in history graph
         static constexpr int HISTORY_SIZE = 100;
@@ -28,26 +31,30 @@ namespace vortex::core {
 
     static ProfilerData s_Data;
 
+    // Active timers are per thread, so the same scope name can be open on several workers at once.
+    static thread_local std::unordered_map<std::string, ProfilerData::Clock::time_point> t_StartTimes;
+
     void Profiler::BeginFrame() {
         // Optional: Reset per-frame counters if needed
     }
 
     void Profiler::Begin(const std::string& name) {
-        s_Data.startTimes[name] = ProfilerData::Clock::now();
+        t_StartTimes[name] = ProfilerData::Clock::now();
     }
 
     void Profiler::End(const std::string& name) {
         auto endTime = ProfilerData::Clock::now();
-        auto it = s_Data.startTimes.find(name);
+        auto it = t_StartTimes.find(name);
         
-        if (it != s_Data.startTimes.end()) {
+        if (it != t_StartTimes.end()) {
             float duration = std::chrono::duration<float, std::milli>(endTime - it->second).count();
             AddSample(name, duration);
-            s_Data.startTimes.erase(it);
+            t_StartTimes.erase(it);
         }
     }
 
     void Profiler::AddSample(const std::string& name, float timeMs) {
+        std::lock_guard<std::mutex> lock(s_Data.mutex);
         auto& histVec = s_Data.history[name];
         if (histVec.size() >= ProfilerData::HISTORY_SIZE) {
             histVec.erase(histVec.begin());
@@ -55,14 +62,37 @@ namespace vortex::core {
         histVec.push_back(timeMs);
     }
 
+    void Profiler::AddValue(const std::string& name, float value, const std::string& unit) {
+        {
+            std::lock_guard<std::mutex> lock(s_Data.mutex);
+            s_Data.units[name] = unit;
+        }
+        AddSample(name, value);
+    }
+
     void Profiler::Render() {
+        std::lock_guard<std::mutex> lock(s_Data.mutex);
+
         if (ImGui::Begin("Performance Profiler")) {
             if (s_Data.history.empty()) {
                 ImGui::Text("No profiling data available.");
             } else {
+                // Samples are grouped by their "Group: " prefix (CPU, GPU, Physics, ...).
+                // std::map keeps names sorted, so each group is contiguous.
+                std::string currentGroup;
+                bool groupOpen = true;
+
                 for (const auto& [name, values] : s_Data.history) {
                     if (values.empty()) continue;
 
+                    size_t sep = name.find(": ");
+                    std::string group = sep != std::string::npos ? name.substr(0, sep) : "Other";
+                    if (group != currentGroup) {
+                        currentGroup = group;
+                        groupOpen = ImGui::CollapsingHeader(group.c_str(), group == "Physics" ? 0 : ImGuiTreeNodeFlags_DefaultOpen);
+                    }
+                    if (!groupOpen) continue;
+
                     float current = values.back();
                     float avg = 0.0f;
                     float maxVal = 0.0f;
@@ -72,7 +102,12 @@ namespace vortex::core {
                     }
                     avg /= values.size();
 
-                    ImGui::Text("%s: %.3f ms (Avg: %.3f ms)", name.c_str(), current, avg);
+                    auto unit = s_Data.units.find(name);
+                    if (unit != s_Data.units.end()) {
+                        ImGui::Text("%s: %.1f %s (Avg: %.1f %s)", name.c_str(), current, unit->second.c_str(), avg, unit->second.c_str());
+                    } else {
+                        ImGui::Text("%s: %.3f ms (Avg: %.3f ms)", name.c_str(), current, avg);
+                    }
                     
                     ImGui::PlotLines(
                         ("##" + name).c_str(), 
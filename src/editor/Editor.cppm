@@ -3,6 +3,7 @@ module;
 #include <glm/glm.hpp>
 #include <imgui.h>
 #include <ImGuizmo.h>
+#include <cstdint>
 #include <vector>
 #include <memory> 
 
@@ -23,6 +24,24 @@ namespace vortex::editor {
         Brush   ///< Voxel painting/erasing.
     };
 
+    /**
+     * @brief Classes of scene changes. Each one has its own upload path in the engine, so a change only
+     * pays for what it touched.
+     */
+    export enum class SceneChange : uint32_t {
+        None      = 0,
+        Transform = 1 << 0, ///< Transform of the selected entity (gizmo). Rewrites its object entries only.
+        Voxels    = 1 << 1, ///< Voxel data of existing parts. Sends dirty chunk ranges and refreshes object bounds.
+        Structure = 1 << 2  ///< Entities, parts or material palettes added, removed or replaced. Rebuilds everything.
+    };
+
+    /**
+     * @brief Helper to combine change classes bitwise.
+     */
+    export inline constexpr uint32_t operator|(SceneChange a, SceneChange b) {
+        return static_cast<uint32_t>(a) | static_cast<uint32_t>(b);
+    }
+
     /**
      * @brief The in-game editor system.
      * @details Handles object selection, Gizmo manipulation, the Importer UI, and Voxel Tools.
@@ -48,9 +67,13 @@ namespace vortex::editor {
 
         std::vector<std::shared_ptr<voxel::VoxelEntity>>& GetEntities() { return m_Entities; }
 
-        bool IsSceneDirty() const { return m_SceneDirty; }
-        void ResetSceneDirty() { m_SceneDirty = false; }
-        void MarkDirty() { m_SceneDirty = true; }
+        /** @brief Pending SceneChange bits. */
+        uint32_t GetSceneChanges() const { return m_SceneChanges; }
+        bool HasSceneChange(SceneChange change) const { return (m_SceneChanges & static_cast<uint32_t>(change)) != 0; }
+        void MarkChanged(SceneChange change) { m_SceneChanges |= static_cast<uint32_t>(change); }
+        void MarkChanged(uint32_t changes) { m_SceneChanges |= changes; }
+        void ClearSceneChanges(uint32_t changes = ~0u) { m_SceneChanges &= ~changes; }
+        void ClearSceneChanges(SceneChange change) { ClearSceneChanges(static_cast<uint32_t>(change)); }
 
         /**
          * @brief Returns the currently selected entity, or nullptr if none.
@@ -77,7 +100,7 @@ namespace vortex::editor {
         
         char m_ImportPathBuffer[256] = "assets/models/frank.glb";
         float m_ImportScale = 10.0f;
-        bool m_SceneDirty = false;
+        uint32_t m_SceneChanges = 0;
 
         // --- Tools State ---
         ToolMode m_CurrentTool = ToolMode::Select;
@@ -54,15 +54,21 @@ namespace vortex::editor {
      * @return Result containing hit position and face normal.
      */
     static RaycastResult RaycastDDA(const Ray& ray, const vortex::voxel::Chunk& chunk) {
+        // Clip the march to the occupied bounds. Dirty bounds are a superset, so this stays exact.
+        const voxel::ChunkStats& stats = chunk.stats;
+        if (stats.solidCount == 0) return {false, 0.0f};
+        const glm::ivec3 boundsMin = stats.boundsMin;
+        const glm::ivec3 boundsMax = stats.boundsMax;
+
         float tNear, tFar;
-        if (!IntersectRayAABB(ray, glm::vec3(0.0f), glm::vec3(32.0f), tNear, tFar)) return {false, 0.0f};
+        if (!IntersectRayAABB(ray, glm::vec3(boundsMin), glm::vec3(boundsMax), tNear, tFar)) return {false, 0.0f};
 
         float tStart = std::max(0.0f, tNear);
         
         // Offset slightly inside to handle boundary conditions
         glm::vec3 rayPos = ray.origin + ray.direction * (tStart + 0.001f);
         glm::ivec3 mapPos = glm::ivec3(glm::floor(rayPos));
-        mapPos = glm::clamp(mapPos, glm::ivec3(0), glm::ivec3(31));
+        mapPos = glm::clamp(mapPos, boundsMin, boundsMax - 1);
 
         glm::vec3 safeDir = ray.direction;
         if (std::abs(safeDir.x) < 1e-6) safeDir.x = 1e-6f;
@@ -85,8 +91,8 @@ namespace vortex::editor {
             }
         }
 
-        for (int i = 0; i < 128; i++) {
-            if (chunk.GetVoxel(mapPos.x, mapPos.y, mapPos.z) != 0) {
+        for (int i = 0; i < (int)voxel::CHUNK_SIZE * 4; i++) {
+            if (chunk.IsSolid(mapPos.x, mapPos.y, mapPos.z)) {
                 glm::ivec3 normal(0);
                 float dist = 0.0f;
 
@@ -129,7 +135,7 @@ namespace vortex::editor {
                 }
             }
             
-            if (mapPos.x < 0 || mapPos.x >= 32 || mapPos.y < 0 || mapPos.y >= 32 || mapPos.z < 0 || mapPos.z >= 32) break;
+            if (glm::any(glm::lessThan(mapPos, boundsMin)) || glm::any(glm::greaterThanEqual(mapPos, boundsMax))) break;
         }
         return {false, 0.0f};
     }
@@ -236,7 +242,7 @@ namespace vortex::editor {
             if (dynMesh) {
                 if (ImGui::Button("Re-Mesh")) {
                     dynMesh->Remesh();
-                    m_SceneDirty = true; 
+                    MarkChanged(SceneChange::Structure); 
                     entity->shouldRebuildPhysics = true; 
                 }
             }
@@ -335,6 +341,10 @@ namespace vortex::editor {
     }
 
     void Editor::HandleBrushAction(const glm::vec3& rayOrigin, const glm::vec3& rayDir) {
+        // Picks against the voxel data rather than PhysicsSystem::CastRays: colliders lag behind edits (an erased
+        // voxel stays in the body until the connectivity pass rebuilds it, which never runs on the selected entity)
+        // and ignore part rotation/scale, so the next stroke would land on voxels that are no longer there.
+
         // If nothing selected, try to find what we are looking at to paint on it.
         // For simplicity, we just raycast against ALL entities and paint on the closest one.
         
@@ -425,8 +435,8 @@ namespace vortex::editor {
                 );
             }
 
-            // Mark for update (Scene Refresh)
-            m_SceneDirty = true;
+            // Voxel data only: the chunk sends its dirty blocks, the object its new bounds.
+            MarkChanged(SceneChange::Voxels);
             
             if (targetEntity) {
                 targetEntity->RecalculateStats(); // Update entity wide bounds
@@ -482,7 +492,7 @@ namespace vortex::editor {
 
         if (ImGuizmo::IsUsing()) {
              entity->transform = glm::translate(visualMatrix, -center);
-             m_SceneDirty = true;
+             MarkChanged(SceneChange::Transform);
              // We don't rebuild physics continuously while dragging to save perf, usually done on mouse release
              // But for now, user might have to toggle static to refresh if colliders desync visually.
              // Ideally: entity->shouldRebuildPhysics = true; (but check ImGuizmo::IsOver or similar to do it only on end)
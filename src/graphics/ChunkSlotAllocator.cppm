@@ -0,0 +1,97 @@
+module;
+
+#include <cstdint>
+#include <set>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+export module vortex.graphics:chunkslots;
+
+import vortex.voxel;
+
+namespace vortex::graphics {
+
+    /**
+     * @brief Occupancy of the GPU chunk buffer.
+     */
+    export struct ChunkSlotStats {
+        uint32_t capacity = 0; ///< Slots the chunk buffer can hold.
+        uint32_t used = 0;     ///< Slots holding a live chunk.
+        uint32_t end = 0;      ///< One past the highest used slot.
+
+        /// @brief Share of [0, end) that is free (holes), 0 when packed.
+        float Fragmentation() const { return end ? 1.0f - (float)used / (float)end : 0.0f; }
+    };
+
+    /**
+     * @brief Persistent assignment of chunks to slots of the GPU chunk buffer.
+     * @details Chunks are identified by address. A chunk keeps its slot for as long as it takes part in uploads;
+     * the slots of chunks that stop appearing are freed and reused lowest-first, which keeps the used range packed.
+     * Compact is the only operation that moves a chunk, and the caller rewrites every chunk it moves.
+     */
+    export class ChunkSlotAllocator {
+    public:
+        static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+        /**
+         * @brief Changes the number of slots. Shrinking below the used range is not allowed (returns false).
+         */
+        bool SetCapacity(uint32_t slots);
+
+        /**
+         * @brief Frees every slot.
+         */
+        void Clear();
+
+        /**
+         * @brief Assigns slots to the chunks of one upload.
+         * @details Slots of chunks missing from `live` are freed first, so new chunks can reuse them right away.
+         * @param outSlots Slot per entry of `live`, INVALID_SLOT if the buffer is full.
+         * @param outResident 1 if the chunk already held its slot before this call, i.e. its GPU copy only
+         * needs the chunk's dirty ranges; 0 if the whole chunk must be written.
+         */
+        void Assign(std::span<vortex::voxel::Chunk* const> live, std::vector<uint32_t>& outSlots, std::vector<uint8_t>& outResident);
+
+        /**
+         * @brief Moves up to maxMoves chunks from the top of the used range into the lowest holes.
+         * @details Must follow Assign with the same arguments; entries of moved chunks get their new slot and are
+         * marked not resident.
+         * @return Number of chunks moved.
+         */
+        uint32_t Compact(std::span<vortex::voxel::Chunk* const> live, uint32_t maxMoves, std::vector<uint32_t>& slots, std::vector<uint8_t>& resident);
+
+        /**
+         * @brief Capacity to shrink to: half the current one once the used range fits in a quarter of it, never
+         * below `minSlots`. Returns the current capacity when no shrink is due.
+         */
+        uint32_t ShrinkTarget(uint32_t minSlots) const;
+
+        /**
+         * @brief Current slot of a chunk, INVALID_SLOT if it has none.
+         */
+        uint32_t SlotOf(const vortex::voxel::Chunk* chunk) const {
+            auto it = m_SlotOf.find(chunk);
+            return it != m_SlotOf.end() ? it->second : INVALID_SLOT;
+        }
+
+        ChunkSlotStats GetStats() const { return {m_Capacity, (uint32_t)m_SlotOf.size(), m_End}; }
+
+    private:
+        uint32_t Allocate();
+        void TrimEnd();
+
+        uint32_t m_Capacity = 0;
+        uint32_t m_End = 0;
+
+        // Per slot: owning chunk (nullptr = free) and the last Assign it appeared in.
+        std::vector<const vortex::voxel::Chunk*> m_Owner;
+        std::vector<uint32_t> m_SeenEpoch;
+        uint32_t m_Epoch = 0;
+
+        std::unordered_map<const vortex::voxel::Chunk*, uint32_t> m_SlotOf;
+
+        // Free slots below m_End, ordered so the lowest hole is reused first.
+        std::set<uint32_t> m_Free;
+    };
+}
@@ -45,6 +45,12 @@ namespace vortex::graphics {
         VkPhysicalDevice GetPhysicalDevice() const { return m_Device.physical_device; }
         VkQueue GetGraphicsQueue() const { return m_GraphicsQueue; }
         uint32_t GetQueueFamily() const { return m_QueueFamily; }
+
+        /**
+         * @brief Queue for buffer uploads: a dedicated transfer queue if the device has one, else the graphics queue.
+         */
+        VkQueue GetTransferQueue() const { return m_TransferQueue; }
+        uint32_t GetTransferQueueFamily() const { return m_TransferQueueFamily; }
         
         vkb::Instance& GetVkbInstance() { return m_Instance; }
         vkb::Device& GetVkbDevice() { return m_Device; }
@@ -58,6 +64,8 @@ namespace vortex::graphics {
         
         VkQueue m_GraphicsQueue{VK_NULL_HANDLE};
         uint32_t m_QueueFamily{0};
+        VkQueue m_TransferQueue{VK_NULL_HANDLE};
+        uint32_t m_TransferQueueFamily{0};
 
         VmaAllocator m_VmaAllocator{VK_NULL_HANDLE};
         std::unique_ptr<memory::MemoryAllocator> m_MemoryAllocator;
@@ -0,0 +1,43 @@
+module;
+
+#include <cstdint>
+#include <vector>
+
+export module vortex.graphics:depthsort;
+
+namespace vortex::graphics {
+
+    /**
+     * @brief How strictly DepthSorter orders its items.
+     */
+    export enum class DepthSortMode : uint8_t {
+        Exact = 0,  ///< Ascending depth, ties in input order.
+        Buckets     ///< Ascending bucket of BUCKET_COUNT equal slices of the depth range; input order inside a bucket.
+    };
+
+    /**
+     * @brief Orders items by a precomputed depth per item in linear time.
+     * @details Exact mode is an LSD radix sort over the float bits of the depths (non-negative floats order like
+     * their bit patterns), with 8-bit digits. All digit histograms come from one pass over the keys, and a digit
+     * that is the same for every key skips its scatter pass, so depths within one order of magnitude usually take
+     * two or three passes. Buckets mode quantizes depths into BUCKET_COUNT slices and does a single counting pass,
+     * which is enough for front-to-back early depth rejection. Scratch arrays are kept between calls.
+     */
+    export class DepthSorter {
+    public:
+        // One radix digit: bucket mode is a single scatter pass.
+        static constexpr uint32_t BUCKET_COUNT = 256;
+
+        /**
+         * @brief Reorders `items` by ascending `depths` (depths[k] belongs to items[k], both the same size).
+         * @details Negative depths count as 0. Stable in both modes.
+         */
+        void Sort(std::vector<uint32_t>& items, const std::vector<float>& depths, DepthSortMode mode);
+
+    private:
+        // Scatters (m_Keys, items) by the digit at `shift` into the scratch arrays and swaps them back in.
+        void Scatter(std::vector<uint32_t>& items, uint32_t* counts, uint32_t shift, uint32_t mask);
+
+        std::vector<uint32_t> m_Keys, m_KeyScratch, m_ItemScratch;
+    };
+}
@@ -0,0 +1,63 @@
+module;
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+export module vortex.graphics:frustum;
+
+namespace vortex::graphics {
+
+    /**
+     * @brief Six clip planes (xyz: normal pointing inside, w: distance), in the space of the matrix they came from.
+     */
+    export struct Frustum {
+        glm::vec4 planes[6];
+
+        /**
+         * @brief Extracts the planes of a view-projection matrix with a 0..1 depth range (Vulkan clip space).
+         * @details Planes are not normalized; the AABB test only compares signs, which scaling does not change.
+         */
+        static Frustum FromViewProj(const glm::mat4& viewProj);
+    };
+
+    /**
+     * @brief Frustum-vs-AABB culling over a contiguous SoA array of object bounds.
+     * @details Bounds are kept as centers and half extents per axis, addressed by a stable object index, so only
+     * moved objects need SetBounds between frames. An AABB is culled when it lies entirely behind one plane
+     * (center distance < -projected radius); boxes straddling a corner of the frustum are kept, which is
+     * conservative. On x86 four boxes are tested per SSE iteration.
+     */
+    export class FrustumCuller {
+    public:
+        /**
+         * @brief Resizes the bounds array to `count` objects. Bounds of objects below the old count are kept.
+         */
+        void Reset(uint32_t count);
+
+        void SetBounds(uint32_t index, const glm::vec3& min, const glm::vec3& max) {
+            glm::vec3 c = (min + max) * 0.5f;
+            glm::vec3 e = (max - min) * 0.5f;
+            m_CenterX[index] = c.x; m_CenterY[index] = c.y; m_CenterZ[index] = c.z;
+            m_ExtentX[index] = e.x; m_ExtentY[index] = e.y; m_ExtentZ[index] = e.z;
+        }
+
+        uint32_t GetCount() const { return m_Count; }
+
+        /**
+         * @brief Replaces `visible` with the indices of all objects intersecting the frustum, in ascending order.
+         */
+        void Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+        /**
+         * @brief Same result as Cull, one box at a time. Used where SSE is unavailable; tests compare against it.
+         */
+        void CullScalar(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+    private:
+        uint32_t m_Count = 0;
+        // Padded to a multiple of 4 so the SIMD loop never reads past the end.
+        std::vector<float> m_CenterX, m_CenterY, m_CenterZ;
+        std::vector<float> m_ExtentX, m_ExtentY, m_ExtentZ;
+    };
+}
@@ -18,6 +18,11 @@ export import :fxaapipeline;
 export import :shader;
 export import :render_resources;
 export import :scenemanager;
+export import :chunkslots;
+export import :staging;
+export import :tlas;
+export import :frustum;
+export import :depthsort;
 export import :camera_struct;
 export import :light; // Import light
 
@@ -56,8 +61,18 @@ namespace vortex::graphics {
         void UploadScene(const std::vector<SceneObject>& objects, 
                          const std::vector<vortex::voxel::PhysicalMaterial>& materials,
                          const std::vector<vortex::voxel::Chunk>& chunks);
+
+        /**
+         * @brief Uploads live chunks in place; unchanged chunks only send their dirty blocks.
+         */
+        void UploadScene(const std::vector<SceneObject>& objects, 
+                         const std::vector<vortex::voxel::PhysicalMaterial>& materials,
+                         const std::vector<vortex::voxel::Chunk*>& chunks);
         
         SceneManager& GetSceneManager();
+
+        /** @brief Upload traffic and ring stalls of the last submitted frame. */
+        StagingStats GetUploadStats() const;
         Camera& GetCamera();
         GLFWwindow* GetWindow();
         
@@ -7,7 +7,12 @@ module;
 export module vortex.graphics:scenemanager;
 
 import :camera_struct;
+import :chunkslots;
 import :light;
+import :staging;
+import :tlas;
+import :frustum;
+import :depthsort;
 import vortex.memory;
 import vortex.voxel; 
 
@@ -24,9 +29,15 @@ namespace vortex::graphics {
         glm::mat4 model{1.0f};
         glm::vec3 logicalCenter{0.0f};
         uint32_t voxelCount = 0;
+        /// @brief Slot in the chunk buffer. Resolved from `chunk` by the Chunk* upload paths.
         uint32_t chunkIndex = 0;
         uint32_t paletteOffset = 0;
         uint32_t flags = 0;
+        /// @brief Tight occupied bounds in chunk-local voxels (see ChunkStats). Defaults to the whole chunk.
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{(float)vortex::voxel::CHUNK_SIZE};
+        /// @brief Live chunk drawn by this object (Chunk* uploads). Its persistent slot becomes chunkIndex.
+        const vortex::voxel::Chunk* chunk = nullptr;
     };
 
     struct GPUObject {
@@ -36,17 +47,28 @@ namespace vortex::graphics {
         uint32_t paletteOffset;
         uint32_t flags;
         uint32_t _pad;
+        glm::vec4 boundsMin; // xyz used; vec4 keeps the std430 layout explicit
+        glm::vec4 boundsMax;
     };
 
     /**
-     * @brief Node for the Top-Level Acceleration Structure (BVH).
-     * @details Aligned to 32 bytes for GPU consumption.
+     * @brief TLAS work done by one CullAndUpload.
      */
-    struct GPUBVHNode {
-        glm::vec3 aabbMin; 
-        uint32_t leftChildOrInstance; // Leaf: Instance Index, Internal: Left Child Index
-        glm::vec3 aabbMax; 
-        uint32_t rightChildOrCount;   // Leaf: Sentinel (0xFFFFFFFF), Internal: Right Child Index
+    export struct TLASUpdateStats {
+        bool rebuilt = false;       ///< Full build (object list replaced, or refits degraded the tree).
+        uint32_t refitObjects = 0;  ///< Objects whose leaves were refit.
+        uint32_t nodesWritten = 0;  ///< Nodes copied into this frame's region.
+        float degradation = 1.0f;   ///< SAH cost relative to the last build (see TLASBuilder::GetRefitDegradation).
+        float updateMs = 0.0f;      ///< Time spent refitting or rebuilding and writing the region.
+    };
+
+    /**
+     * @brief Frustum culling done by one CullAndUpload.
+     */
+    export struct CullStats {
+        uint32_t visible = 0;   ///< Objects drawn by the raster pass.
+        uint32_t total = 0;     ///< Objects in the TLAS (everything, since rays and shadows reach off-screen objects).
+        float cullMs = 0.0f;    ///< Time spent culling and sorting the draw order.
     };
 
     export class SceneManager {
@@ -54,61 +76,243 @@ namespace vortex::graphics {
         SceneManager() = default;
         ~SceneManager();
 
-        void Initialize(memory::MemoryAllocator* allocator);
+        /**
+         * @param uploader Feeds the device-local chunk and material buffers; must outlive the scene manager.
+         * @param offsetAlignment Dynamic offset alignment for the per-frame buffers (uniform and storage).
+         * @param maxStorageBufferRange Device limit on one storage binding; the chunk buffer and the object, TLAS
+         * and draw order regions never grow past it.
+         */
+        void Initialize(memory::MemoryAllocator* allocator, StagingUploader* uploader, uint32_t framesInFlight, VkDeviceSize offsetAlignment,
+                        VkDeviceSize maxStorageBufferRange);
         void Shutdown();
 
+        /**
+         * @brief Call once per frame after waiting for the fence of frame `frameIndex`.
+         * @details Camera, light, object and TLAS writes go to that frame's region until the next call; the region
+         * starts with the latest camera and light, so a frame that skips an upload does not read stale data.
+         * Also releases buffers retired by resizes.
+         */
+        void BeginFrame(uint32_t frameIndex);
+
         void UploadSceneData(const std::vector<SceneObject>& objects, 
                              const std::vector<vortex::voxel::PhysicalMaterial>& materials, 
                              const std::vector<vortex::voxel::Chunk>& chunks);
+
+        /**
+         * @brief Replaces the object list and uploads materials and live chunks (see UploadChunks).
+         * @details Objects reference their chunk through SceneObject::chunk.
+         */
+        void UploadSceneData(const std::vector<SceneObject>& objects, 
+                             const std::vector<vortex::voxel::PhysicalMaterial>& materials, 
+                             const std::vector<vortex::voxel::Chunk*>& chunks);
+
+        /**
+         * @brief Uploads live chunks into their persistent slots (see ChunkSlotAllocator).
+         * @details A chunk that kept its slot only sends its dirty byte ranges (Chunk::CollectDirtyRanges); new,
+         * moved or reallocated chunks are written whole. Dirty masks are cleared once written. Slots of chunks that
+         * are no longer passed are freed. The buffer grows geometrically when full, is compacted a few chunks per
+         * upload once fragmented, and shrinks when mostly empty. chunkIndex of the current objects is re-resolved.
+         */
+        void UploadChunks(const std::vector<vortex::voxel::Chunk*>& chunks);
+
+        /**
+         * @brief Replaces the material list, growing the material buffer geometrically when it does not fit.
+         */
+        void UploadMaterials(const std::vector<vortex::voxel::PhysicalMaterial>& materials);
+
+        /** @brief Bytes staged for the chunk buffer by the last scene upload. */
+        size_t GetLastChunkUploadBytes() const { return m_LastChunkUploadBytes; }
+
+        ChunkSlotStats GetChunkSlotStats() const { return m_ChunkSlots.GetStats(); }
+
+        /**
+         * @brief Incremented whenever one of the buffers returned by the getters below is replaced.
+         * @details Camera, light, object and TLAS buffers hold one region per frame in flight, bound at
+         * PerFrameBuffer::Offset(frameIndex).
+         * Descriptor sets must be rewritten when the generation changes. Replaced buffers stay alive until every
+         * frame in flight that may reference them has completed.
+         */
+        uint32_t GetBufferGeneration() const { return m_BufferGeneration; }
         
         void UploadCameraBuffer(const Camera& camera, uint32_t width, uint32_t height, uint64_t frameCount, bool useJitter);
         void UploadLightBuffer(const DirectionalLight& light);
 
+        /**
+         * @brief Brings this frame's object and TLAS regions up to date and writes the front-to-back draw order of
+         * the objects inside the view frustum.
+         * @details Objects keep their index in the object buffer, so only objects changed through the setters below
+         * are rewritten, and the TLAS is refit over their new bounds. The TLAS is rebuilt when the object list was
+         * replaced or refits have degraded its SAH cost too far. Each region receives exactly the objects and nodes
+         * that changed since it was last written. Buffers grow when the objects do not fit.
+         * The object buffer and the TLAS always hold every object, since rays (shadows, reflections) hit objects
+         * outside the frustum; only the draw order is culled.
+         * @return Number of objects to draw (instance i draws object DrawOrder[i]).
+         */
         size_t CullAndUpload(const Camera& camera, float aspectRatio);
 
         std::vector<SceneObject>& GetObjects() { return m_Objects; }
         void SetObjectTransform(int index, const glm::mat4& transform);
 
-        const memory::AllocatedBuffer& GetCameraBuffer() const { return m_CameraUBO; }
+        /**
+         * @brief Updates what a voxel edit changes on an object: occupied bounds, voxel count and center.
+         * @details The object is only rewritten (and its TLAS leaf refit) when its bounds change.
+         */
+        void SetObjectShape(int index, const glm::vec3& boundsMin, const glm::vec3& boundsMax, uint32_t voxelCount, const glm::vec3& logicalCenter);
+
+        const memory::PerFrameBuffer& GetCameraBuffer() const { return m_CameraUBO; }
         const memory::AllocatedBuffer& GetMaterialBuffer() const { return m_MaterialsSSBO; }
-        const memory::AllocatedBuffer& GetObjectBuffer() const { return m_ObjectsSSBO; }
+        const memory::PerFrameBuffer& GetObjectBuffer() const { return m_ObjectsSSBO; }
         const memory::AllocatedBuffer& GetChunkBuffer() const { return m_ChunksSSBO; }
-        const memory::AllocatedBuffer& GetLightBuffer() const { return m_LightUBO; }
+        const memory::PerFrameBuffer& GetLightBuffer() const { return m_LightUBO; }
         
         /** @brief Returns the TLAS BVH buffer. */
-        const memory::AllocatedBuffer& GetTLASBuffer() const { return m_TLASBuffer; }
+        const memory::PerFrameBuffer& GetTLASBuffer() const { return m_TLASBuffer; }
+
+        /** @brief Object index per drawn instance, nearest first. */
+        const memory::PerFrameBuffer& GetDrawOrderBuffer() const { return m_DrawOrderBuffer; }
+
+        /** @brief How the last CullAndUpload brought the TLAS up to date. */
+        TLASUpdateStats GetTLASStats() const { return m_TLASStats; }
+
+        /** @brief Visible and total object counts of the last CullAndUpload. */
+        CullStats GetCullStats() const { return m_CullStats; }
+
+        /**
+         * @brief Exact or bucketed front-to-back draw order. Buckets skip most radix passes and only cost depth
+         * rejection between objects at almost the same distance.
+         */
+        void SetDrawOrderMode(DepthSortMode mode) { m_DrawOrderMode = mode; }
+        DepthSortMode GetDrawOrderMode() const { return m_DrawOrderMode; }
 
     private:
         memory::MemoryAllocator* m_Allocator{nullptr};
+        StagingUploader* m_Uploader{nullptr};
         
         std::vector<SceneObject> m_Objects;
         std::vector<SceneObject> m_CachedObjects;
         
-        memory::AllocatedBuffer m_CameraUBO;
-        memory::AllocatedBuffer m_LightUBO;
+        memory::PerFrameBuffer m_CameraUBO;
+        memory::PerFrameBuffer m_LightUBO;
         memory::AllocatedBuffer m_MaterialsSSBO;
-        memory::AllocatedBuffer m_ObjectsSSBO;
+        memory::PerFrameBuffer m_ObjectsSSBO;
         memory::AllocatedBuffer m_ChunksSSBO;
-        
-        // New TLAS Buffer
-        memory::AllocatedBuffer m_TLASBuffer; 
 
-        void* m_MappedObjectBuffer{nullptr};
-        void* m_MappedTLASBuffer{nullptr}; // Mapped pointer for TLAS
+        // Frame whose regions the CPU is writing, and the latest values carried into each new region.
+        uint32_t m_FrameIndex = 0;
+        CameraUBO m_CameraData{};
+        DirectionalLight m_LightData{};
+        VkDeviceSize m_OffsetAlignment = 0;
+
+        // Capacities grow geometrically; high-water marks are logged on growth and at shutdown.
+        uint32_t m_ObjectCapacity = 0;
+        uint32_t m_MaterialCapacity = 0;
+        uint32_t m_ObjectHighWater = 0;
+        uint32_t m_MaterialHighWater = 0;
+        uint32_t m_ChunkSlotHighWater = 0;
+
+        // Largest capacities one storage binding can address, and the objects dropped last frame for lack of room.
+        uint32_t m_MaxObjects = 0;
+        uint32_t m_MaxChunkSlots = 0;
+        uint32_t m_DroppedObjects = 0;
+
+        ChunkSlotAllocator m_ChunkSlots;
+        uint32_t m_InitialChunkSlots = 0;
+        std::vector<uint32_t> m_SlotScratch;
+        std::vector<uint8_t> m_ResidentScratch;
+        std::vector<vortex::voxel::ChunkByteRange> m_DirtyRanges;
+        size_t m_LastChunkUploadBytes = 0;
+
+        // Buffers replaced while frames in flight may still read them, with frames left until release.
+        struct RetiredBuffer {
+            memory::AllocatedBuffer buffer;
+            uint32_t framesLeft;
+        };
+        std::vector<RetiredBuffer> m_RetiredBuffers;
+        uint32_t m_FramesInFlight = 1;
+        uint32_t m_BufferGeneration = 0;
+        
+        // TLAS nodes; a binary BVH over n objects has 2n - 1 of them.
+        memory::PerFrameBuffer m_TLASBuffer; 
         
+        // World bounds of every object by index; the draw order holds the visible ones, nearest first.
+        FrustumCuller m_Culler;
+        CullStats m_CullStats;
+        memory::PerFrameBuffer m_DrawOrderBuffer;
+        std::vector<uint32_t> m_DrawOrder;
+        std::vector<float> m_DrawDepths;
+        DepthSorter m_DepthSorter;
+        DepthSortMode m_DrawOrderMode = DepthSortMode::Exact;
+
         glm::mat4 m_PrevViewProj{1.0f};
-        std::vector<GPUObject> m_VisibleGPUObjects;
-
-        // BVH Building Helpers
-        struct BVHBuildNode {
-            glm::vec3 min;
-            glm::vec3 max;
-            int left = -1;
-            int right = -1;
-            int objectIndex = -1; // -1 if internal
+
+        // CPU copies of the object buffer and the TLAS, which per-frame regions are patched from.
+        std::vector<GPUObject> m_GPUObjects;
+        std::vector<GPUBVHNode> m_TLASNodes;
+        TLASBuilder m_TLASBuilder;
+        TLASUpdateStats m_TLASStats;
+
+        // Objects changed through the setters since the last CullAndUpload; a replaced list rebuilds everything.
+        std::vector<uint32_t> m_ChangedObjects;
+        std::vector<uint8_t> m_ObjectChanged;
+        bool m_ObjectsReplaced = true;
+        std::vector<uint32_t> m_TouchedNodes;
+
+        // Elements a frame region has missed while other regions were written: listed, or all of them.
+        struct RegionDelta {
+            std::vector<uint32_t> indices;
+            bool full = true;
         };
-        
-        void BuildTLAS(const std::vector<SceneObject*>& visibleObjects);
-        int BuildBVHRecursive(std::vector<int>& objIndices, std::vector<BVHBuildNode>& nodes, const std::vector<SceneObject*>& objects);
+        std::vector<RegionDelta> m_ObjectDeltas;
+        std::vector<RegionDelta> m_TLASDeltas;
+
+        /**
+         * @brief Stages a whole chunk for every valid slots[i] and calls write(i, dst) to fill it (Chunk::GPU_SIZE bytes).
+         */
+        template<typename WriteFn>
+        void WriteChunks(const std::vector<uint32_t>& slots, const WriteFn& write);
+
+        /**
+         * @brief Replaces the chunk buffer with one of `slots` slots. The new buffer starts empty.
+         */
+        void ResizeChunkBuffer(uint32_t slots);
+
+        /**
+         * @brief Assigns slots 0..count-1 to anonymous chunk copies (growing the buffer if needed) and forgets every
+         * persistent slot.
+         */
+        void ResetChunkSlots(size_t count);
+
+        /**
+         * @brief Replaces the object, TLAS and draw order buffers with ones for `objects` objects per frame.
+         * @details Every region of the new buffers is refilled from the CPU copies when it is next written.
+         */
+        void ResizeObjectBuffers(uint32_t objects);
+
+        /**
+         * @brief Replaces the material buffer with one of `materials` entries. The new buffer starts empty.
+         */
+        void ResizeMaterialBuffer(uint32_t materials);
+
+        void RetireBuffer(memory::AllocatedBuffer& buffer);
+        void RetireBuffer(memory::PerFrameBuffer& buffer);
+
+        void MarkObjectChanged(int index);
+        void WriteGPUObject(uint32_t index);
+
+        /**
+         * @brief Rebuilds m_TLASNodes over all objects (leaf instance = object index) and resets the culler's bounds.
+         */
+        void BuildTLAS();
+
+        /**
+         * @brief Records a changed element for every region (a region that would take most of them is marked full).
+         */
+        static void PublishChange(std::vector<RegionDelta>& deltas, uint32_t index, size_t count);
+        static void PublishAll(std::vector<RegionDelta>& deltas);
+
+        /**
+         * @brief Copies this frame's missed elements of `src` (stride bytes each) into its region and clears the delta.
+         */
+        void WriteRegion(memory::PerFrameBuffer& buffer, RegionDelta& delta, const void* src, size_t stride, size_t count);
     };
 }
\ No newline at end of file
@@ -37,6 +37,7 @@ namespace vortex::graphics {
 
         /**
          * @brief Compiles GLSL source code into SPIR-V binary.
+         * @details Engine-wide defines (CHUNK_LAYOUT_*, VORTEX_CHUNK_LAYOUT) are injected as a preamble.
          * @param stage The shader stage (Compute, Vertex, etc.).
          * @param source The GLSL source code string.
          * @return A vector of uint32_t containing SPIR-V bytecode.
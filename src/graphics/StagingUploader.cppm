@@ -0,0 +1,120 @@
+module;
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+export module vortex.graphics:staging;
+
+import vortex.memory;
+
+namespace vortex::graphics {
+
+    /**
+     * @brief Upload traffic since the last TakeStats call.
+     */
+    export struct StagingStats {
+        uint64_t bytes = 0;      ///< Bytes copied into device-local buffers.
+        uint32_t batches = 0;    ///< Transfer submissions.
+        uint32_t stalls = 0;     ///< Times the CPU waited for the ring to drain.
+        float stallMs = 0.0f;    ///< Total time spent in those waits.
+    };
+
+    /**
+     * @brief Streams CPU data into device-local buffers through a persistently mapped staging ring.
+     * @details Writes are copied into the ring immediately and recorded as buffer copies; Flush submits them on the
+     * transfer queue (a dedicated one when the device has it, the graphics queue otherwise). Every batch signals the
+     * next value of a timeline semaphore: ring space is recycled once that value is reached, and the graphics submit
+     * waits on it before reading the destinations. A batch itself waits on the last submitted frame, so copies never
+     * overwrite data that a frame in flight still reads. Only when the ring is full does the CPU block (a stall).
+     * Destination buffers must be created with SharedQueueFamilies() when the two queues differ.
+     */
+    export class StagingUploader {
+    public:
+        StagingUploader() = default;
+        ~StagingUploader();
+
+        /**
+         * @param frameTimeline Timeline semaphore signaled by graphics submits (see SetFrameWaitValue).
+         */
+        void Initialize(VkDevice device, memory::MemoryAllocator* allocator, VkQueue queue, uint32_t queueFamily,
+                        uint32_t graphicsQueueFamily, VkSemaphore frameTimeline, VkDeviceSize ringSize);
+        void Shutdown();
+
+        /**
+         * @brief Reserves `size` bytes of ring space for a copy to dst at dstOffset and returns where to write them.
+         * @details `size` must not exceed the ring; use Write for arbitrary sizes. Blocks if the ring is full.
+         */
+        void* Stage(VkBuffer dst, VkDeviceSize dstOffset, VkDeviceSize size);
+
+        /**
+         * @brief Copies `size` bytes from src to dst at dstOffset, splitting them into ring-sized pieces.
+         */
+        void Write(VkBuffer dst, VkDeviceSize dstOffset, const void* src, VkDeviceSize size);
+
+        /**
+         * @brief Frame timeline value of the last graphics submit. Later batches wait for it on the GPU.
+         */
+        void SetFrameWaitValue(uint64_t value) { m_FrameWaitValue = value; }
+
+        /**
+         * @brief Submits the pending copies.
+         * @return Timeline value the graphics queue must wait for (the last batch's, 0 if nothing was ever sent).
+         */
+        uint64_t Flush();
+
+        /** @brief Timeline semaphore signaled by transfer batches. */
+        VkSemaphore GetTimeline() const { return m_Timeline; }
+
+        /**
+         * @brief Queue families that access destination buffers (one entry when uploads share the graphics queue).
+         */
+        const std::vector<uint32_t>& SharedQueueFamilies() const { return m_QueueFamilies; }
+
+        /** @brief Returns and resets the traffic counters. */
+        StagingStats TakeStats();
+
+    private:
+        struct PendingCopy {
+            VkBuffer dst;
+            VkBufferCopy region;
+        };
+
+        // A submitted batch: its ring bytes (including wrap padding) are free once the timeline reaches `value`.
+        struct Batch {
+            uint64_t value;
+            VkDeviceSize bytes;
+            VkCommandBuffer cmd;
+        };
+
+        void Reclaim(bool waitOldest);
+        VkCommandBuffer AcquireCommandBuffer();
+
+        VkDevice m_Device{VK_NULL_HANDLE};
+        memory::MemoryAllocator* m_Allocator{nullptr};
+        VkQueue m_Queue{VK_NULL_HANDLE};
+        std::vector<uint32_t> m_QueueFamilies;
+
+        memory::AllocatedBuffer m_Ring;
+        char* m_Mapped{nullptr};
+        VkDeviceSize m_Capacity = 0;
+        VkDeviceSize m_Head = 0;         // Next free byte.
+        VkDeviceSize m_Used = 0;         // Bytes not yet released, pending or in flight.
+        VkDeviceSize m_PendingBytes = 0; // Share of m_Used that belongs to the unsubmitted batch.
+
+        std::vector<PendingCopy> m_Pending;
+        std::deque<Batch> m_InFlight;
+
+        VkCommandPool m_CommandPool{VK_NULL_HANDLE};
+        std::vector<VkCommandBuffer> m_FreeCommandBuffers;
+
+        VkSemaphore m_Timeline{VK_NULL_HANDLE};
+        uint64_t m_LastSignaled = 0;
+
+        VkSemaphore m_FrameTimeline{VK_NULL_HANDLE};
+        uint64_t m_FrameWaitValue = 0;
+
+        StagingStats m_Stats;
+    };
+}
@@ -0,0 +1,125 @@
+module;
+
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+export module vortex.graphics:tlas;
+
+namespace vortex::graphics {
+
+    /**
+     * @brief Node for the Top-Level Acceleration Structure (BVH).
+     * @details Aligned to 32 bytes for GPU consumption.
+     */
+    export struct GPUBVHNode {
+        glm::vec3 aabbMin;
+        uint32_t leftChildOrInstance; // Leaf: Instance Index, Internal: Left Child Index
+        glm::vec3 aabbMax;
+        uint32_t rightChildOrCount;   // Leaf: Sentinel (0xFFFFFFFF), Internal: Right Child Index
+    };
+
+    /**
+     * @brief Binned SAH builder for the TLAS, one instance per leaf.
+     * @details Instance bounds are set once into SoA arrays, which the build then partitions in place. Each split
+     * bins centroids into BIN_COUNT bins along the widest centroid axis and takes the plane with the lowest surface
+     * area heuristic cost. A range of n instances always occupies exactly 2n - 1 consecutive nodes in depth-first
+     * order (left child right after its parent, right child after the left subtree), so large subtrees are built
+     * as parallel jobs without any shared allocation. Depth never exceeds MAX_DEPTH: close to it, ranges are split
+     * at the median instead, which keeps the shader's fixed traversal stack from overflowing.
+     * Between builds, Refit moves single instances and tracks how far the tree's SAH cost drifts from the built one.
+     */
+    export class TLASBuilder {
+    public:
+        static constexpr uint32_t LEAF_SENTINEL = 0xFFFFFFFF;
+        static constexpr uint32_t BIN_COUNT = 16;
+        // voxel.frag traverses with a 32-entry stack, which holds at most depth + 1 entries.
+        static constexpr uint32_t MAX_DEPTH = 30;
+
+        /** @brief Nodes written by Build for `instances` instances. */
+        static constexpr uint32_t NodeCount(uint32_t instances) { return instances ? 2 * instances - 1 : 0; }
+
+        /**
+         * @brief Starts a build over `count` instances; every one must get SetBounds before Build.
+         */
+        void Reset(uint32_t count);
+
+        /**
+         * @brief World-space bounds of instance `index`; leaves refer to instances by this index.
+         */
+        void SetBounds(uint32_t index, const glm::vec3& min, const glm::vec3& max) {
+            m_MinX[index] = min.x; m_MinY[index] = min.y; m_MinZ[index] = min.z;
+            m_MaxX[index] = max.x; m_MaxY[index] = max.y; m_MaxZ[index] = max.z;
+        }
+
+        /**
+         * @brief Writes the tree to out[0, NodeCount(count)), root first. Each node is written exactly once, so
+         * `out` may point into mapped GPU memory.
+         * @details Reorders the stored bounds; the next Build needs a Reset and fresh SetBounds calls.
+         */
+        void Build(GPUBVHNode* out);
+
+        /**
+         * @brief Gives `instance` new bounds in the tree written by the last Build and updates its ancestors.
+         * @details Ancestors are recomputed from both children, up to the first one whose bounds stay the same.
+         * Every rewritten node index is appended to `touched`. The topology is kept, so the tree stays valid but
+         * loosens as instances move away from where they were built (see GetRefitDegradation).
+         */
+        void Refit(GPUBVHNode* nodes, uint32_t instance, const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& touched);
+
+        /**
+         * @brief Current SAH cost over the cost right after Build: 1 for a fresh tree, growing as refits loosen it.
+         */
+        float GetRefitDegradation() const;
+
+        /**
+         * @brief SAH cost of a built tree relative to its root area (traversal and intersection cost 1 each).
+         */
+        static float SAHCost(const GPUBVHNode* nodes, uint32_t nodeCount);
+
+    private:
+        struct Bounds {
+            glm::vec3 min{FLT_MAX};
+            glm::vec3 max{-FLT_MAX};
+
+            void Grow(const glm::vec3& p) { min = glm::min(min, p); max = glm::max(max, p); }
+            void Grow(const glm::vec3& lo, const glm::vec3& hi) { min = glm::min(min, lo); max = glm::max(max, hi); }
+            void Grow(const Bounds& b) { Grow(b.min, b.max); }
+            float HalfArea() const {
+                glm::vec3 e = max - min;
+                return e.x * e.y + e.y * e.z + e.z * e.x;
+            }
+        };
+
+        struct Bin {
+            Bounds bounds;
+            uint32_t count = 0;
+        };
+
+        // Instances m_Indices[begin, end) with their bounds and the bounds of their doubled centroids (min + max).
+        struct Range {
+            uint32_t begin = 0, end = 0;
+            Bounds bounds, centroids;
+        };
+
+        Range MakeRange(uint32_t begin, uint32_t end) const;
+        void Swap(uint32_t a, uint32_t b);
+        // Reorders [begin, end) so that `mid` holds the median centroid on the given axis, smaller ones before it.
+        void SelectMedian(const float* axisMin, const float* axisMax, uint32_t begin, uint32_t mid, uint32_t end);
+        void BuildRange(GPUBVHNode* out, uint32_t nodeIndex, const Range& range, uint32_t depth);
+
+        uint32_t m_Count = 0;
+        std::vector<float> m_MinX, m_MinY, m_MinZ;
+        std::vector<float> m_MaxX, m_MaxY, m_MaxZ;
+        std::vector<uint32_t> m_Indices;
+
+        // Refit state of the last Build: parent per node (root: LEAF_SENTINEL), leaf per instance, and the sum of
+        // all node half areas, which refits keep up to date.
+        std::vector<uint32_t> m_Parents;
+        std::vector<uint32_t> m_LeafOf;
+        double m_AreaSum = 0.0;
+        float m_RootArea = 0.0f;
+        float m_BuiltCost = 0.0f;
+    };
+}
@@ -0,0 +1,131 @@
+module;
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+module vortex.graphics;
+
+import :chunkslots;
+import vortex.voxel;
+
+namespace vortex::graphics {
+
+    bool ChunkSlotAllocator::SetCapacity(uint32_t slots) {
+        if (slots < m_End) return false;
+        m_Capacity = slots;
+        m_Owner.resize(slots, nullptr);
+        m_SeenEpoch.resize(slots, 0);
+        return true;
+    }
+
+    uint32_t ChunkSlotAllocator::ShrinkTarget(uint32_t minSlots) const {
+        // Halving at a quarter leaves the buffer half full, so growth and shrinking do not alternate.
+        if (m_Capacity <= minSlots || m_End > m_Capacity / 4) return m_Capacity;
+        return std::max(minSlots, m_Capacity / 2);
+    }
+
+    void ChunkSlotAllocator::Clear() {
+        std::fill(m_Owner.begin(), m_Owner.end(), nullptr);
+        m_SlotOf.clear();
+        m_Free.clear();
+        m_End = 0;
+    }
+
+    uint32_t ChunkSlotAllocator::Allocate() {
+        if (!m_Free.empty()) {
+            uint32_t slot = *m_Free.begin();
+            m_Free.erase(m_Free.begin());
+            return slot;
+        }
+        if (m_End < m_Capacity) return m_End++;
+        return INVALID_SLOT;
+    }
+
+    void ChunkSlotAllocator::TrimEnd() {
+        // Free slots at the top of the range are not holes; keep m_Free limited to [0, m_End).
+        while (m_End > 0 && m_Owner[m_End - 1] == nullptr) {
+            m_Free.erase(m_End - 1);
+            --m_End;
+        }
+    }
+
+    void ChunkSlotAllocator::Assign(std::span<vortex::voxel::Chunk* const> live, std::vector<uint32_t>& outSlots, std::vector<uint8_t>& outResident) {
+        ++m_Epoch;
+        outSlots.assign(live.size(), INVALID_SLOT);
+        outResident.assign(live.size(), 0);
+
+        // 1. Chunks that already own a slot keep it.
+        for (size_t i = 0; i < live.size(); ++i) {
+            auto it = m_SlotOf.find(live[i]);
+            if (it == m_SlotOf.end()) continue;
+            m_SeenEpoch[it->second] = m_Epoch;
+            outSlots[i] = it->second;
+            outResident[i] = 1;
+        }
+
+        // 2. Chunks that are gone release theirs.
+        for (uint32_t slot = 0; slot < m_End; ++slot) {
+            if (m_Owner[slot] && m_SeenEpoch[slot] != m_Epoch) {
+                m_SlotOf.erase(m_Owner[slot]);
+                m_Owner[slot] = nullptr;
+                m_Free.insert(slot);
+            }
+        }
+        TrimEnd();
+
+        // 3. New chunks fill the lowest holes, then extend the range.
+        for (size_t i = 0; i < live.size(); ++i) {
+            if (outSlots[i] != INVALID_SLOT) continue;
+
+            // The same chunk listed twice: the first entry already placed (and will write) it.
+            auto it = m_SlotOf.find(live[i]);
+            if (it != m_SlotOf.end()) {
+                outSlots[i] = it->second;
+                outResident[i] = 1;
+                continue;
+            }
+
+            uint32_t slot = Allocate();
+            if (slot == INVALID_SLOT) continue;
+            m_Owner[slot] = live[i];
+            m_SeenEpoch[slot] = m_Epoch;
+            m_SlotOf[live[i]] = slot;
+            outSlots[i] = slot;
+        }
+    }
+
+    uint32_t ChunkSlotAllocator::Compact(std::span<vortex::voxel::Chunk* const> live, uint32_t maxMoves, std::vector<uint32_t>& slots, std::vector<uint8_t>& resident) {
+        uint32_t moved = 0;
+        while (moved < maxMoves && !m_Free.empty()) {
+            // TrimEnd keeps the top slot owned, and every hole lies below it.
+            uint32_t hole = *m_Free.begin();
+            uint32_t top = m_End - 1;
+            m_Free.erase(m_Free.begin());
+
+            const vortex::voxel::Chunk* chunk = m_Owner[top];
+            m_Owner[hole] = chunk;
+            m_SeenEpoch[hole] = m_SeenEpoch[top];
+            m_SlotOf[chunk] = hole;
+
+            m_Owner[top] = nullptr;
+            m_Free.insert(top);
+            TrimEnd();
+            ++moved;
+        }
+        if (moved == 0) return 0;
+
+        for (size_t i = 0; i < live.size(); ++i) {
+            if (slots[i] == INVALID_SLOT) continue;
+            uint32_t slot = m_SlotOf.at(live[i]);
+            if (slot != slots[i]) {
+                slots[i] = slot;
+                resident[i] = 0;
+            }
+        }
+        return moved;
+    }
+}
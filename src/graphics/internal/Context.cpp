@@ -39,6 +39,7 @@ namespace vortex::graphics {
         VkPhysicalDeviceVulkan12Features features12{};
         features12.scalarBlockLayout = VK_TRUE; 
         features12.bufferDeviceAddress = VK_TRUE;
+        features12.timelineSemaphore = VK_TRUE;
 
         vkb::PhysicalDeviceSelector selector{m_Instance};
         auto phys_ret = selector.set_surface(surface)
@@ -62,6 +63,16 @@ namespace vortex::graphics {
         m_GraphicsQueue = m_Device.get_queue(vkb::QueueType::graphics).value();
         m_QueueFamily = m_Device.get_queue_index(vkb::QueueType::graphics).value();
 
+        // A transfer-only family maps to the copy engines; without one, uploads share the graphics queue.
+        auto transferQueue = m_Device.get_dedicated_queue(vkb::QueueType::transfer);
+        if (transferQueue) {
+            m_TransferQueue = transferQueue.value();
+            m_TransferQueueFamily = m_Device.get_dedicated_queue_index(vkb::QueueType::transfer).value();
+        } else {
+            m_TransferQueue = m_GraphicsQueue;
+            m_TransferQueueFamily = m_QueueFamily;
+        }
+
         VmaAllocatorCreateInfo allocatorInfo = {};
         allocatorInfo.physicalDevice = m_Device.physical_device;
         allocatorInfo.device = m_Device.device;
@@ -0,0 +1,98 @@
+module;
+
+#include <algorithm>
+#include <bit>
+#include <cfloat>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+module vortex.graphics;
+
+import :depthsort;
+
+namespace vortex::graphics {
+
+    // Below this, insertion sort beats clearing and scanning radix histograms.
+    static constexpr size_t INSERTION_SORT_MAX = 64;
+    static constexpr uint32_t RADIX_BITS = 8;
+    static constexpr uint32_t RADIX = 1u << RADIX_BITS;
+
+    void DepthSorter::Sort(std::vector<uint32_t>& items, const std::vector<float>& depths, DepthSortMode mode) {
+        const size_t n = items.size();
+        m_Keys.resize(n);
+
+        if (mode == DepthSortMode::Exact) {
+            // Non-negative floats compare like their bit patterns; negatives and NaN are clamped to 0.
+            for (size_t k = 0; k < n; ++k) m_Keys[k] = std::bit_cast<uint32_t>(depths[k] > 0.0f ? depths[k] : 0.0f);
+        } else {
+            float lo = FLT_MAX, hi = 0.0f;
+            for (float d : depths) {
+                d = d > 0.0f ? d : 0.0f;
+                lo = std::min(lo, d);
+                hi = std::max(hi, d);
+            }
+            float scale = hi > lo ? (float)BUCKET_COUNT / (hi - lo) : 0.0f;
+            for (size_t k = 0; k < n; ++k) {
+                float d = depths[k] > 0.0f ? depths[k] : 0.0f;
+                m_Keys[k] = std::min(BUCKET_COUNT - 1, (uint32_t)((d - lo) * scale));
+            }
+        }
+
+        if (n <= INSERTION_SORT_MAX) {
+            for (size_t k = 1; k < n; ++k) {
+                uint32_t key = m_Keys[k], item = items[k];
+                size_t j = k;
+                for (; j > 0 && m_Keys[j - 1] > key; --j) {
+                    m_Keys[j] = m_Keys[j - 1];
+                    items[j] = items[j - 1];
+                }
+                m_Keys[j] = key;
+                items[j] = item;
+            }
+            return;
+        }
+
+        m_KeyScratch.resize(n);
+        m_ItemScratch.resize(n);
+
+        if (mode == DepthSortMode::Buckets) {
+            uint32_t counts[BUCKET_COUNT] = {};
+            for (uint32_t key : m_Keys) counts[key]++;
+            Scatter(items, counts, 0, BUCKET_COUNT - 1);
+            return;
+        }
+
+        uint32_t counts[4][RADIX] = {};
+        for (uint32_t key : m_Keys) {
+            for (uint32_t d = 0; d < 4; ++d) counts[d][(key >> (d * RADIX_BITS)) & (RADIX - 1)]++;
+        }
+        for (uint32_t d = 0; d < 4; ++d) {
+            // All keys share this digit: the pass would not move anything.
+            if (counts[d][(m_Keys[0] >> (d * RADIX_BITS)) & (RADIX - 1)] == n) continue;
+            Scatter(items, counts[d], d * RADIX_BITS, RADIX - 1);
+        }
+    }
+
+    void DepthSorter::Scatter(std::vector<uint32_t>& items, uint32_t* counts, uint32_t shift, uint32_t mask) {
+        // Counts become write offsets.
+        uint32_t offset = 0;
+        for (uint32_t b = 0; b <= mask; ++b) {
+            uint32_t c = counts[b];
+            counts[b] = offset;
+            offset += c;
+        }
+        // Raw pointers: stores into the scratch arrays would otherwise force reloads of the other arrays' data.
+        const uint32_t* keys = m_Keys.data();
+        const uint32_t* src = items.data();
+        uint32_t* keyDst = m_KeyScratch.data();
+        uint32_t* itemDst = m_ItemScratch.data();
+        for (size_t k = 0, n = items.size(); k < n; ++k) {
+            uint32_t dst = counts[(keys[k] >> shift) & mask]++;
+            keyDst[dst] = keys[k];
+            itemDst[dst] = src[k];
+        }
+        std::swap(m_Keys, m_KeyScratch);
+        std::swap(items, m_ItemScratch);
+    }
+}
@@ -0,0 +1,92 @@
+module;
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define VORTEX_FRUSTUM_SSE 1
+    #include <immintrin.h>
+#endif
+
+module vortex.graphics;
+
+import :frustum;
+
+namespace vortex::graphics {
+
+    Frustum Frustum::FromViewProj(const glm::mat4& m) {
+        // Clip-space rows (glm is column-major). A point is inside when -w <= x, y <= w and 0 <= z <= w.
+        auto row = [&](int r) { return glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]); };
+        glm::vec4 x = row(0), y = row(1), z = row(2), w = row(3);
+        return {{w + x, w - x, w + y, w - y, z, w - z}};
+    }
+
+    void FrustumCuller::Reset(uint32_t count) {
+        m_Count = count;
+        size_t padded = ((size_t)count + 3) & ~(size_t)3;
+        m_CenterX.resize(padded); m_CenterY.resize(padded); m_CenterZ.resize(padded);
+        m_ExtentX.resize(padded); m_ExtentY.resize(padded); m_ExtentZ.resize(padded);
+    }
+
+    void FrustumCuller::CullScalar(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+        visible.clear();
+        for (uint32_t i = 0; i < m_Count; ++i) {
+            bool inside = true;
+            for (const glm::vec4& p : frustum.planes) {
+                // Summed in the same order as the SSE path, so both agree on boxes touching a plane.
+                float d = (p.x * m_CenterX[i] + p.y * m_CenterY[i]) + (p.z * m_CenterZ[i] + p.w);
+                float r = (std::abs(p.x) * m_ExtentX[i] + std::abs(p.y) * m_ExtentY[i]) + std::abs(p.z) * m_ExtentZ[i];
+                if (d + r < 0.0f) { inside = false; break; }
+            }
+            if (inside) visible.push_back(i);
+        }
+    }
+
+#if defined(VORTEX_FRUSTUM_SSE)
+
+    void FrustumCuller::Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+        visible.clear();
+        // Plane components and their absolute values, broadcast once for the whole array.
+        __m128 nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+        for (int p = 0; p < 6; ++p) {
+            const glm::vec4& plane = frustum.planes[p];
+            nx[p] = _mm_set1_ps(plane.x); ny[p] = _mm_set1_ps(plane.y);
+            nz[p] = _mm_set1_ps(plane.z); nw[p] = _mm_set1_ps(plane.w);
+            ax[p] = _mm_set1_ps(std::abs(plane.x)); ay[p] = _mm_set1_ps(std::abs(plane.y));
+            az[p] = _mm_set1_ps(std::abs(plane.z));
+        }
+        const __m128 zero = _mm_setzero_ps();
+
+        for (uint32_t i = 0; i < m_Count; i += 4) {
+            __m128 cx = _mm_loadu_ps(&m_CenterX[i]), cy = _mm_loadu_ps(&m_CenterY[i]), cz = _mm_loadu_ps(&m_CenterZ[i]);
+            __m128 ex = _mm_loadu_ps(&m_ExtentX[i]), ey = _mm_loadu_ps(&m_ExtentY[i]), ez = _mm_loadu_ps(&m_ExtentZ[i]);
+
+            __m128 outside = zero;
+            for (int p = 0; p < 6; ++p) {
+                __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+                                      _mm_add_ps(_mm_mul_ps(nz[p], cz), nw[p]));
+                __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)), _mm_mul_ps(az[p], ez));
+                outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(d, r), zero));
+            }
+
+            uint32_t mask = ~(uint32_t)_mm_movemask_ps(outside) & 0xF;
+            // Lanes past m_Count are padding.
+            if (m_Count - i < 4) mask &= (1u << (m_Count - i)) - 1;
+            while (mask) {
+                visible.push_back(i + (uint32_t)std::countr_zero(mask));
+                mask &= mask - 1;
+            }
+        }
+    }
+
+#else
+
+    void FrustumCuller::Cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+        CullScalar(frustum, visible);
+    }
+
+#endif
+}
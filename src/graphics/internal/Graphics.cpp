@@ -1,6 +1,7 @@
 module;
 
 #include <vulkan/vulkan.h>
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <vk_mem_alloc.h>
@@ -13,6 +14,7 @@ import vortex.memory;
 import vortex.voxel;
 import :render_resources;
 import :scenemanager; 
+import :staging;
 import :taapipeline; 
 import :fxaapipeline;
 
@@ -20,6 +22,8 @@ namespace vortex::graphics {
 
     constexpr int FRAMES_IN_FLIGHT = 2;
     constexpr int QUERY_COUNT = 4;
+    // Holds a full rewrite of the initial chunk buffer's worth of edits between frames without stalling.
+    constexpr VkDeviceSize STAGING_RING_SIZE = 1024 * 1024 * 32;
 
     struct GraphicsInternal {
         Window window;
@@ -28,6 +32,7 @@ namespace vortex::graphics {
         UIOverlay ui;
         
         RenderResources resources;
+        StagingUploader uploader;
         SceneManager sceneManager;
         
         RasterPipeline rasterPipeline;
@@ -40,6 +45,11 @@ namespace vortex::graphics {
         std::vector<VkSemaphore> renderFinishedSemaphores;
         std::vector<VkFence> inFlightFences;
 
+        // Signaled with frameTimelineValue by every frame submit; upload batches wait on it.
+        VkSemaphore frameTimeline{VK_NULL_HANDLE};
+        uint64_t frameTimelineValue = 0;
+        StagingStats lastUploadStats;
+
         VkQueryPool queryPools[FRAMES_IN_FLIGHT];
         float timestampPeriod = 1.0f;
         float lastSceneTime = 0.0f;
@@ -48,6 +58,7 @@ namespace vortex::graphics {
         uint32_t currentFrame = 0;
         uint32_t imageIndex = 0;
         uint64_t frameCounter = 0;
+        uint32_t boundBufferGeneration = 0;
 
         Camera camera;
         float renderScale = 0.6f; 
@@ -101,7 +112,13 @@ namespace vortex::graphics {
         vkCreateSampler(i.context.GetDevice(), &samplerInfo, nullptr, &i.defaultSampler);
 
         i.resources.Initialize(i.context.GetAllocator(), width, height);
-        i.sceneManager.Initialize(i.context.GetAllocator());
+        i.uploader.Initialize(i.context.GetDevice(), i.context.GetAllocator(), i.context.GetTransferQueue(), i.context.GetTransferQueueFamily(),
+                              i.context.GetQueueFamily(), i.frameTimeline, STAGING_RING_SIZE);
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(i.context.GetPhysicalDevice(), &props);
+        VkDeviceSize offsetAlignment = std::max(props.limits.minUniformBufferOffsetAlignment, props.limits.minStorageBufferOffsetAlignment);
+        i.sceneManager.Initialize(i.context.GetAllocator(), &i.uploader, FRAMES_IN_FLIGHT, offsetAlignment,
+                                 props.limits.maxStorageBufferRange);
 
         i.rasterPipeline.Initialize(i.context.GetDevice(), 
                                     VK_FORMAT_R8G8B8A8_UNORM,
@@ -113,7 +130,8 @@ namespace vortex::graphics {
                                     i.sceneManager.GetObjectBuffer(), 
                                     i.sceneManager.GetChunkBuffer(),
                                     i.sceneManager.GetLightBuffer(),
-                                    i.sceneManager.GetTLASBuffer()); 
+                                    i.sceneManager.GetTLASBuffer(),
+                                    i.sceneManager.GetDrawOrderBuffer()); 
         
         i.ui.Initialize(i.context, i.window, i.swapchain.GetFormat(), i.swapchain.GetExtent(), i.swapchain.GetImageViews());
         
@@ -133,6 +151,13 @@ namespace vortex::graphics {
             vkCreateSemaphore(context.GetDevice(), &s, nullptr, &renderFinishedSemaphores[i]);
             vkCreateFence(context.GetDevice(), &f, nullptr, &inFlightFences[i]);
         }
+
+        VkSemaphoreTypeCreateInfo timelineInfo{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+        timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timelineInfo.initialValue = 0;
+        VkSemaphoreCreateInfo t = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+        t.pNext = &timelineInfo;
+        vkCreateSemaphore(context.GetDevice(), &t, nullptr, &frameTimeline);
     }
 
     void GraphicsInternal::InitQueries() {
@@ -169,6 +194,7 @@ namespace vortex::graphics {
         }
 
         vkWaitForFences(i.context.GetDevice(), 1, &i.inFlightFences[i.currentFrame], VK_TRUE, UINT64_MAX);
+        i.sceneManager.BeginFrame(i.currentFrame);
 
         uint64_t buffer[QUERY_COUNT];
         VkResult res = vkGetQueryPoolResults(i.context.GetDevice(), i.queryPools[i.currentFrame], 0, QUERY_COUNT, 
@@ -206,6 +232,17 @@ namespace vortex::graphics {
         float aspect = (float)i.swapchain.GetExtent().width / (float)i.swapchain.GetExtent().height;
         size_t visibleCount = i.sceneManager.CullAndUpload(i.camera, aspect);
 
+        if (i.sceneManager.GetBufferGeneration() != i.boundBufferGeneration) {
+            i.rasterPipeline.SetBuffers(i.sceneManager.GetCameraBuffer(),
+                                        i.sceneManager.GetMaterialBuffer(),
+                                        i.sceneManager.GetObjectBuffer(),
+                                        i.sceneManager.GetChunkBuffer(),
+                                        i.sceneManager.GetLightBuffer(),
+                                        i.sceneManager.GetTLASBuffer(),
+                                        i.sceneManager.GetDrawOrderBuffer());
+            i.boundBufferGeneration = i.sceneManager.GetBufferGeneration();
+        }
+
         vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, i.queryPools[i.currentFrame], 0);
         i.PassGeometry(cmd, visibleCount);
         vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, i.queryPools[i.currentFrame], 1);
@@ -230,16 +267,30 @@ namespace vortex::graphics {
         i.TransitionLayout(cmd, i.swapchain.GetImages()[i.imageIndex], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
         vkEndCommandBuffer(cmd);
+
+        // Scene uploads of this frame go out first; shaders wait for them, everything else overlaps the copy.
+        uint64_t uploadValue = i.uploader.Flush();
+        i.lastUploadStats = i.uploader.TakeStats();
+        uint64_t frameValue = ++i.frameTimelineValue;
         
         VkSubmitInfo submit{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-        VkSemaphore wait[] = {i.imageAvailableSemaphores[i.currentFrame]};
-        VkPipelineStageFlags stage[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        submit.waitSemaphoreCount = 1; submit.pWaitSemaphores = wait; submit.pWaitDstStageMask = stage;
+        VkSemaphore wait[] = {i.imageAvailableSemaphores[i.currentFrame], i.uploader.GetTimeline()};
+        VkPipelineStageFlags stage[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT};
+        uint64_t waitValues[] = {0, uploadValue};
+        submit.waitSemaphoreCount = uploadValue > 0 ? 2 : 1; submit.pWaitSemaphores = wait; submit.pWaitDstStageMask = stage;
         submit.commandBufferCount = 1; submit.pCommandBuffers = &i.commandBuffers[i.currentFrame];
-        VkSemaphore sig[] = {i.renderFinishedSemaphores[i.currentFrame]};
-        submit.signalSemaphoreCount = 1; submit.pSignalSemaphores = sig;
+        VkSemaphore sig[] = {i.renderFinishedSemaphores[i.currentFrame], i.frameTimeline};
+        uint64_t sigValues[] = {0, frameValue};
+        submit.signalSemaphoreCount = 2; submit.pSignalSemaphores = sig;
+
+        // Binary semaphores ignore their entry in the value arrays.
+        VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        timelineInfo.waitSemaphoreValueCount = submit.waitSemaphoreCount; timelineInfo.pWaitSemaphoreValues = waitValues;
+        timelineInfo.signalSemaphoreValueCount = submit.signalSemaphoreCount; timelineInfo.pSignalSemaphoreValues = sigValues;
+        submit.pNext = &timelineInfo;
         
         vkQueueSubmit(i.context.GetGraphicsQueue(), 1, &submit, i.inFlightFences[i.currentFrame]);
+        i.uploader.SetFrameWaitValue(frameValue);
         i.swapchain.Present(i.context.GetGraphicsQueue(), i.imageIndex, i.renderFinishedSemaphores[i.currentFrame]);
         
         i.currentFrame = (i.currentFrame + 1) % FRAMES_IN_FLIGHT;
@@ -421,10 +472,18 @@ namespace vortex::graphics {
         m_Internal->sceneManager.UploadSceneData(o, m, c); 
     }
 
+    void GraphicsContext::UploadScene(const std::vector<SceneObject>& o, 
+                                      const std::vector<vortex::voxel::PhysicalMaterial>& m, 
+                                      const std::vector<vortex::voxel::Chunk*>& c) { 
+        m_Internal->sceneManager.UploadSceneData(o, m, c); 
+    }
+
     SceneManager& GraphicsContext::GetSceneManager() {
         return m_Internal->sceneManager;
     }
 
+    StagingStats GraphicsContext::GetUploadStats() const { return m_Internal->lastUploadStats; }
+
     void GraphicsContext::SetAAMode(AntiAliasingMode mode) { 
         m_Internal->currentAAMode = mode; 
         m_Internal->resources.InvalidateHistory(); 
@@ -441,6 +500,9 @@ namespace vortex::graphics {
                     vkDestroyQueryPool(m_Internal->context.GetDevice(), m_Internal->queryPools[i], nullptr);
                 }
             }
+            if (m_Internal->frameTimeline) {
+                vkDestroySemaphore(m_Internal->context.GetDevice(), m_Internal->frameTimeline, nullptr);
+            }
             m_Internal.reset(); 
         } 
     }
@@ -9,14 +9,21 @@ module;
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstring>
 #include <iostream> 
 #include <vector>
 #include <limits>
+#include <string>
 
 module vortex.graphics;
 
 import :scenemanager;
+import :chunkslots;
+import :staging;
+import :tlas;
+import :frustum;
+import :depthsort;
 import vortex.memory;
 import :camera_struct;
 import :light;
@@ -25,6 +32,33 @@ import vortex.voxel;
 
 namespace vortex::graphics {
 
+    // Initial objects per frame region (the TLAS region is sized for a full BVH over them) and materials.
+    // Both grow geometrically from here; destruction debris easily multiplies the object count.
+    static constexpr uint32_t INITIAL_OBJECT_CAPACITY = 10000;
+    static constexpr uint32_t INITIAL_MATERIAL_CAPACITY = 2048;
+
+    // Initial chunk buffer size; it grows geometrically from here and never shrinks below it.
+    static constexpr VkDeviceSize CHUNK_BUFFER_SIZE = 1024 * 1024 * 64;
+
+    // Geometric growth towards `needed`, capped at what one storage buffer binding can address.
+    static uint32_t GrownCapacity(size_t needed, uint32_t capacity, uint32_t limit) {
+        return (uint32_t)std::min<size_t>(std::max<size_t>(needed, (size_t)capacity * 2), limit);
+    }
+
+    // Projection range shared by the camera buffer and frustum culling.
+    static constexpr float CAMERA_NEAR = 0.1f;
+    static constexpr float CAMERA_FAR = 400.0f;
+
+    // Compaction runs once a fair share of the used slot range is holes, moving a bounded number of chunks
+    // per upload so a large scene is repacked over several uploads instead of stalling one.
+    static constexpr float COMPACT_FRAGMENTATION = 0.25f;
+    static constexpr uint32_t COMPACT_MIN_SLOTS = 64;
+    static constexpr uint32_t COMPACT_MOVES_PER_UPLOAD = 64;
+
+    // Refits keep the topology of the last build; once they push its SAH cost this far above the built cost,
+    // traversal loses more than a rebuild costs.
+    static constexpr float TLAS_REBUILD_DEGRADATION = 1.5f;
+
     float Halton(int index, int base) {
         float f = 1.0f; float r = 0.0f;
         while (index > 0) { f = f / (float)base; r = r + f * (index % base); index = index / base; }
@@ -46,94 +80,294 @@ namespace vortex::graphics {
             max = glm::max(max, b.max);
         }
         
-        glm::vec3 Center() const { return (min + max) * 0.5f; }
-        
-        // Transform local AABB (0..32) by model matrix
-        static AABB FromMatrix(const glm::mat4& m) {
+        // Transform a local AABB (the object's occupied bounds, within 0..CHUNK_SIZE) by model matrix
+        static AABB FromMatrix(const glm::mat4& m, const glm::vec3& lo, const glm::vec3& hi) {
             AABB box;
-            // The chunk is 0..32 in local space. We transform the 8 corners.
+            // Transform the 8 corners.
             const glm::vec3 corners[8] = {
-                {0,0,0}, {32,0,0}, {0,32,0}, {32,32,0},
-                {0,0,32}, {32,0,32}, {0,32,32}, {32,32,32}
+                {lo.x,lo.y,lo.z}, {hi.x,lo.y,lo.z}, {lo.x,hi.y,lo.z}, {hi.x,hi.y,lo.z},
+                {lo.x,lo.y,hi.z}, {hi.x,lo.y,hi.z}, {lo.x,hi.y,hi.z}, {hi.x,hi.y,hi.z}
             };
             for(const auto& c : corners) {
                 box.Grow(glm::vec3(m * glm::vec4(c, 1.0f)));
             }
             return box;
         }
+
+        static AABB FromObject(const SceneObject& obj) {
+            return FromMatrix(obj.model, obj.boundsMin, obj.boundsMax);
+        }
     };
 
     SceneManager::~SceneManager() { Shutdown(); }
 
-    void SceneManager::Initialize(memory::MemoryAllocator* allocator) {
+    void SceneManager::Initialize(memory::MemoryAllocator* allocator, StagingUploader* uploader, uint32_t framesInFlight, VkDeviceSize offsetAlignment,
+                                  VkDeviceSize maxStorageBufferRange) {
         m_Allocator = allocator;
+        m_Uploader = uploader;
+        m_FramesInFlight = framesInFlight;
+        m_OffsetAlignment = offsetAlignment;
+
+        // Every storage binding (the chunk buffer whole, per-frame regions padded to the offset alignment) must fit
+        // in maxStorageBufferRange; past these limits chunks and objects are dropped instead of growing the buffers.
+        VkDeviceSize range = std::min<VkDeviceSize>(maxStorageBufferRange, UINT32_MAX);
+        VkDeviceSize regionRange = range - range % std::max<VkDeviceSize>(offsetAlignment, 1);
+        m_MaxChunkSlots = (uint32_t)(range / voxel::Chunk::GPU_SIZE);
+        m_MaxObjects = (uint32_t)std::min<VkDeviceSize>({regionRange / sizeof(GPUObject), (regionRange / sizeof(GPUBVHNode) + 1) / 2,
+                                                         regionRange / sizeof(uint32_t)});
         
-        m_CameraUBO = allocator->CreateBuffer(sizeof(CameraUBO), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-        m_LightUBO = allocator->CreateBuffer(sizeof(DirectionalLight), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-
-        m_MaterialsSSBO = allocator->CreateBuffer(sizeof(voxel::PhysicalMaterial) * 2048, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-        m_ObjectsSSBO = allocator->CreateBuffer(sizeof(GPUObject) * 10000, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-        
-        VkResult result = vmaMapMemory(m_Allocator->GetVmaAllocator(), m_ObjectsSSBO.allocation, &m_MappedObjectBuffer);
-        if (result != VK_SUCCESS) Log::Error("Failed to map object buffer!");
-
-        m_ChunksSSBO = allocator->CreateBuffer(1024*1024*64, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-        
-        // Create TLAS Buffer (Size for ~4096 nodes, sufficient for ~2000 objects)
-        m_TLASBuffer = allocator->CreateBuffer(sizeof(GPUBVHNode) * 4096, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-        vmaMapMemory(m_Allocator->GetVmaAllocator(), m_TLASBuffer.allocation, &m_MappedTLASBuffer);
+        // Rewritten every frame: one mapped region per frame in flight, so the CPU never touches what the GPU reads.
+        m_CameraUBO = allocator->CreatePerFrameBuffer(sizeof(CameraUBO), framesInFlight, offsetAlignment, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+        m_LightUBO = allocator->CreatePerFrameBuffer(sizeof(DirectionalLight), framesInFlight, offsetAlignment, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
+        m_ObjectCapacity = std::min(INITIAL_OBJECT_CAPACITY, m_MaxObjects);
+        m_ObjectsSSBO = allocator->CreatePerFrameBuffer(sizeof(GPUObject) * m_ObjectCapacity, framesInFlight, offsetAlignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        m_TLASBuffer = allocator->CreatePerFrameBuffer(sizeof(GPUBVHNode) * (2 * m_ObjectCapacity - 1), framesInFlight, offsetAlignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        m_DrawOrderBuffer = allocator->CreatePerFrameBuffer(sizeof(uint32_t) * m_ObjectCapacity, framesInFlight, offsetAlignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        m_ObjectDeltas.assign(framesInFlight, {});
+        m_TLASDeltas.assign(framesInFlight, {});
+
+        // Materials and chunks change rarely and are read by every ray step: device-local, fed through the uploader.
+        m_MaterialCapacity = INITIAL_MATERIAL_CAPACITY;
+        m_MaterialsSSBO = allocator->CreateBuffer(sizeof(voxel::PhysicalMaterial) * m_MaterialCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                  VMA_MEMORY_USAGE_GPU_ONLY, uploader->SharedQueueFamilies());
+
+        m_InitialChunkSlots = (uint32_t)std::min<VkDeviceSize>(CHUNK_BUFFER_SIZE / voxel::Chunk::GPU_SIZE, m_MaxChunkSlots);
+        m_ChunksSSBO = allocator->CreateBuffer((VkDeviceSize)m_InitialChunkSlots * voxel::Chunk::GPU_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                               VMA_MEMORY_USAGE_GPU_ONLY, uploader->SharedQueueFamilies());
+        m_ChunkSlots.SetCapacity(m_InitialChunkSlots);
     }
 
     void SceneManager::Shutdown() {
         if (m_Allocator) {
-            if (m_MappedObjectBuffer) {
-                vmaUnmapMemory(m_Allocator->GetVmaAllocator(), m_ObjectsSSBO.allocation);
-                m_MappedObjectBuffer = nullptr;
-            }
-            if (m_MappedTLASBuffer) {
-                vmaUnmapMemory(m_Allocator->GetVmaAllocator(), m_TLASBuffer.allocation);
-                m_MappedTLASBuffer = nullptr;
-            }
-            m_Allocator->DestroyBuffer(m_CameraUBO);
-            m_Allocator->DestroyBuffer(m_LightUBO);
+            Log::Info("Scene buffer high-water: " + std::to_string(m_ObjectHighWater) + " / " + std::to_string(m_ObjectCapacity) + " objects, " +
+                      std::to_string(m_MaterialHighWater) + " / " + std::to_string(m_MaterialCapacity) + " materials, " +
+                      std::to_string(m_ChunkSlotHighWater) + " / " + std::to_string(m_ChunkSlots.GetStats().capacity) + " chunk slots");
+            m_Allocator->DestroyPerFrameBuffer(m_CameraUBO);
+            m_Allocator->DestroyPerFrameBuffer(m_LightUBO);
             m_Allocator->DestroyBuffer(m_MaterialsSSBO);
-            m_Allocator->DestroyBuffer(m_ObjectsSSBO);
+            m_Allocator->DestroyPerFrameBuffer(m_ObjectsSSBO);
             m_Allocator->DestroyBuffer(m_ChunksSSBO);
-            m_Allocator->DestroyBuffer(m_TLASBuffer);
+            m_Allocator->DestroyPerFrameBuffer(m_TLASBuffer);
+            m_Allocator->DestroyPerFrameBuffer(m_DrawOrderBuffer);
+            for (auto& retired : m_RetiredBuffers) m_Allocator->DestroyBuffer(retired.buffer);
+            m_RetiredBuffers.clear();
+            m_Allocator = nullptr;
+        }
+    }
+
+    void SceneManager::BeginFrame(uint32_t frameIndex) {
+        m_FrameIndex = frameIndex;
+        memcpy(m_CameraUBO.Region(frameIndex), &m_CameraData, sizeof(CameraUBO));
+        memcpy(m_LightUBO.Region(frameIndex), &m_LightData, sizeof(DirectionalLight));
+
+        // Called after a fence wait: one more frame that could reference each retired buffer has completed.
+        for (size_t i = 0; i < m_RetiredBuffers.size();) {
+            if (--m_RetiredBuffers[i].framesLeft == 0) {
+                m_Allocator->DestroyBuffer(m_RetiredBuffers[i].buffer);
+                m_RetiredBuffers[i] = m_RetiredBuffers.back();
+                m_RetiredBuffers.pop_back();
+            } else {
+                ++i;
+            }
         }
     }
 
+    void SceneManager::RetireBuffer(memory::AllocatedBuffer& buffer) {
+        m_RetiredBuffers.push_back({buffer, m_FramesInFlight});
+        buffer = {};
+        m_BufferGeneration++;
+    }
+
+    void SceneManager::RetireBuffer(memory::PerFrameBuffer& buffer) {
+        if (buffer.mapped) vmaUnmapMemory(m_Allocator->GetVmaAllocator(), buffer.buffer.allocation);
+        RetireBuffer(buffer.buffer);
+        buffer = {};
+    }
+
+    void SceneManager::ResizeObjectBuffers(uint32_t objects) {
+        uint32_t oldObjects = m_ObjectCapacity;
+        RetireBuffer(m_ObjectsSSBO);
+        RetireBuffer(m_TLASBuffer);
+        RetireBuffer(m_DrawOrderBuffer);
+        m_ObjectCapacity = objects;
+        m_ObjectsSSBO = m_Allocator->CreatePerFrameBuffer(sizeof(GPUObject) * objects, m_FramesInFlight, m_OffsetAlignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        m_TLASBuffer = m_Allocator->CreatePerFrameBuffer(sizeof(GPUBVHNode) * (2 * (size_t)objects - 1), m_FramesInFlight, m_OffsetAlignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        m_DrawOrderBuffer = m_Allocator->CreatePerFrameBuffer(sizeof(uint32_t) * objects, m_FramesInFlight, m_OffsetAlignment, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        PublishAll(m_ObjectDeltas);
+        PublishAll(m_TLASDeltas);
+        Log::Info("Object buffers resized: " + std::to_string(oldObjects) + " -> " + std::to_string(objects) +
+                  " objects per frame (high-water " + std::to_string(m_ObjectHighWater) + ")");
+    }
+
+    void SceneManager::ResizeMaterialBuffer(uint32_t materials) {
+        uint32_t oldMaterials = m_MaterialCapacity;
+        RetireBuffer(m_MaterialsSSBO);
+        m_MaterialCapacity = materials;
+        m_MaterialsSSBO = m_Allocator->CreateBuffer(sizeof(voxel::PhysicalMaterial) * materials, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                    VMA_MEMORY_USAGE_GPU_ONLY, m_Uploader->SharedQueueFamilies());
+        Log::Info("Material buffer resized: " + std::to_string(oldMaterials) + " -> " + std::to_string(materials) +
+                  " materials (high-water " + std::to_string(m_MaterialHighWater) + ")");
+    }
+
+    void SceneManager::ResizeChunkBuffer(uint32_t slots) {
+        uint32_t oldSlots = m_ChunkSlots.GetStats().capacity;
+        RetireBuffer(m_ChunksSSBO);
+        m_ChunksSSBO = m_Allocator->CreateBuffer((VkDeviceSize)slots * voxel::Chunk::GPU_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                 VMA_MEMORY_USAGE_GPU_ONLY, m_Uploader->SharedQueueFamilies());
+        m_ChunkSlots.SetCapacity(slots);
+        Log::Info("Chunk buffer resized: " + std::to_string(oldSlots) + " -> " + std::to_string(slots) + " slots (" +
+                  std::to_string(((size_t)slots * voxel::Chunk::GPU_SIZE) >> 20) + " MB, high-water " + std::to_string(m_ChunkSlotHighWater) + ")");
+    }
+
+    void SceneManager::ResetChunkSlots(size_t count) {
+        m_ChunkSlots.Clear();
+        uint32_t capacity = m_ChunkSlots.GetStats().capacity;
+        if (count > capacity && capacity < m_MaxChunkSlots) {
+            capacity = GrownCapacity(count, capacity, m_MaxChunkSlots);
+            ResizeChunkBuffer(capacity);
+        }
+
+        // Chunks past the capacity get no slot and are dropped by WriteChunks.
+        m_SlotScratch.resize(count);
+        for (size_t i = 0; i < count; ++i) m_SlotScratch[i] = i < capacity ? (uint32_t)i : ChunkSlotAllocator::INVALID_SLOT;
+    }
+
+    void SceneManager::UploadMaterials(const std::vector<vortex::voxel::PhysicalMaterial>& materials) {
+        if (materials.empty()) return;
+        m_MaterialHighWater = std::max(m_MaterialHighWater, (uint32_t)materials.size());
+        // Every upload rewrites the whole list, so the replacement needs no copy of the old contents.
+        if (materials.size() > m_MaterialCapacity) ResizeMaterialBuffer(std::max((uint32_t)materials.size(), m_MaterialCapacity * 2));
+        m_Uploader->Write(m_MaterialsSSBO.buffer, 0, materials.data(), materials.size() * sizeof(voxel::PhysicalMaterial));
+    }
+
+    template<typename WriteFn>
+    void SceneManager::WriteChunks(const std::vector<uint32_t>& slots, const WriteFn& write) {
+        if (slots.empty()) return;
+
+        // Only the GPU prefix of each chunk is uploaded; CPU-side caches (occupancy) stay on the host.
+        size_t dropped = 0;
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (slots[i] == ChunkSlotAllocator::INVALID_SLOT) { dropped++; continue; }
+            void* dst = m_Uploader->Stage(m_ChunksSSBO.buffer, (VkDeviceSize)slots[i] * voxel::Chunk::GPU_SIZE, voxel::Chunk::GPU_SIZE);
+            if (dst) write(i, dst);
+        }
+        if (dropped > 0) Log::Warn("Chunk buffer full, dropping " + std::to_string(dropped) + " chunks");
+    }
+
     void SceneManager::UploadSceneData(const std::vector<SceneObject>& objects, 
                                        const std::vector<vortex::voxel::PhysicalMaterial>& materials, 
                                        const std::vector<vortex::voxel::Chunk>& chunks) {
         m_CachedObjects = objects;
+        m_ObjectsReplaced = true;
+        UploadMaterials(materials);
+        ResetChunkSlots(chunks.size());
+        WriteChunks(m_SlotScratch, [&](size_t i, void* dst) {
+            memcpy(dst, &chunks[i], voxel::Chunk::GPU_SIZE);
+        });
+        m_LastChunkUploadBytes = chunks.size() * voxel::Chunk::GPU_SIZE;
+    }
+
+    void SceneManager::UploadSceneData(const std::vector<SceneObject>& objects, 
+                                       const std::vector<vortex::voxel::PhysicalMaterial>& materials, 
+                                       const std::vector<vortex::voxel::Chunk*>& chunks) {
+        m_CachedObjects = objects;
+        m_ObjectsReplaced = true;
+        UploadMaterials(materials);
+        UploadChunks(chunks);
+    }
 
-        if (!materials.empty()) {
-            void* data;
-            vmaMapMemory(m_Allocator->GetVmaAllocator(), m_MaterialsSSBO.allocation, &data);
-            memcpy(data, materials.data(), materials.size() * sizeof(voxel::PhysicalMaterial));
-            vmaUnmapMemory(m_Allocator->GetVmaAllocator(), m_MaterialsSSBO.allocation);
+    void SceneManager::UploadChunks(const std::vector<vortex::voxel::Chunk*>& chunks) {
+        // A resized buffer starts empty, so every chunk is written whole afterwards.
+        bool rewriteAll = false;
+        uint32_t capacity = m_ChunkSlots.GetStats().capacity;
+        // At the binding limit, Assign leaves the chunks that do not fit without a slot.
+        if (chunks.size() > capacity && capacity < m_MaxChunkSlots) {
+            ResizeChunkBuffer(GrownCapacity(chunks.size(), capacity, m_MaxChunkSlots));
+            rewriteAll = true;
         }
 
-        if (!chunks.empty()) {
-            void* data;
-            vmaMapMemory(m_Allocator->GetVmaAllocator(), m_ChunksSSBO.allocation, &data);
-            memcpy(data, chunks.data(), chunks.size() * sizeof(vortex::voxel::Chunk));
-            vmaUnmapMemory(m_Allocator->GetVmaAllocator(), m_ChunksSSBO.allocation);
+        m_ChunkSlots.Assign(chunks, m_SlotScratch, m_ResidentScratch);
+
+        ChunkSlotStats slotStats = m_ChunkSlots.GetStats();
+        if (slotStats.end >= COMPACT_MIN_SLOTS && slotStats.Fragmentation() > COMPACT_FRAGMENTATION) {
+            m_ChunkSlots.Compact(chunks, COMPACT_MOVES_PER_UPLOAD, m_SlotScratch, m_ResidentScratch);
+            slotStats = m_ChunkSlots.GetStats();
+        }
+        if (uint32_t shrunk = m_ChunkSlots.ShrinkTarget(m_InitialChunkSlots); shrunk < slotStats.capacity) {
+            ResizeChunkBuffer(shrunk);
+            rewriteAll = true;
+        }
+
+        size_t bytes = 0;
+        size_t dropped = 0;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            if (m_SlotScratch[i] == ChunkSlotAllocator::INVALID_SLOT) { dropped++; continue; }
+            voxel::Chunk* chunk = chunks[i];
+            VkDeviceSize base = (VkDeviceSize)m_SlotScratch[i] * voxel::Chunk::GPU_SIZE;
+            if (rewriteAll || !m_ResidentScratch[i]) {
+                // Address reuse is harmless: a freshly constructed chunk is fully dirty anyway.
+                m_Uploader->Write(m_ChunksSSBO.buffer, base, chunk, voxel::Chunk::GPU_SIZE);
+                bytes += voxel::Chunk::GPU_SIZE;
+            } else {
+                m_DirtyRanges.clear();
+                chunk->CollectDirtyRanges(m_DirtyRanges);
+                for (const auto& range : m_DirtyRanges) {
+                    m_Uploader->Write(m_ChunksSSBO.buffer, base + range.offset, (const char*)chunk + range.offset, range.size);
+                    bytes += range.size;
+                }
+            }
+            chunk->ClearDirty();
+        }
+        if (dropped > 0) Log::Warn("Chunk buffer full, dropping " + std::to_string(dropped) + " chunks");
+        m_LastChunkUploadBytes = bytes;
+        m_ChunkSlotHighWater = std::max(m_ChunkSlotHighWater, m_ChunkSlots.GetStats().used);
+
+        // Slots only change for new or compacted chunks, but resolving all objects is cheap.
+        for (size_t i = 0; i < m_CachedObjects.size(); ++i) {
+            SceneObject& obj = m_CachedObjects[i];
+            if (!obj.chunk) continue;
+            uint32_t slot = m_ChunkSlots.SlotOf(obj.chunk);
+            if (slot != ChunkSlotAllocator::INVALID_SLOT && slot != obj.chunkIndex) {
+                obj.chunkIndex = slot;
+                MarkObjectChanged((int)i);
+            }
         }
     }
 
     void SceneManager::SetObjectTransform(int index, const glm::mat4& newModel) {
-        if (index >= 0 && index < (int)m_CachedObjects.size()) {
+        if (index >= 0 && index < (int)m_CachedObjects.size() && m_CachedObjects[index].model != newModel) {
             m_CachedObjects[index].model = newModel;
+            MarkObjectChanged(index);
+        }
+    }
+
+    void SceneManager::SetObjectShape(int index, const glm::vec3& boundsMin, const glm::vec3& boundsMax, uint32_t voxelCount, const glm::vec3& logicalCenter) {
+        if (index < 0 || index >= (int)m_CachedObjects.size()) return;
+        SceneObject& obj = m_CachedObjects[index];
+        // Voxel count and center stay on the CPU; only new bounds reach the object entry and the TLAS leaf, so
+        // edits inside the occupied box cost no refit.
+        obj.voxelCount = voxelCount;
+        obj.logicalCenter = logicalCenter;
+        if (obj.boundsMin != boundsMin || obj.boundsMax != boundsMax) {
+            obj.boundsMin = boundsMin;
+            obj.boundsMax = boundsMax;
+            MarkObjectChanged(index);
+        }
+    }
+
+    void SceneManager::MarkObjectChanged(int index) {
+        // A replaced list is rewritten whole anyway.
+        if (m_ObjectsReplaced) return;
+        if (m_ObjectChanged.size() < m_CachedObjects.size()) m_ObjectChanged.resize(m_CachedObjects.size(), 0);
+        if (!m_ObjectChanged[index]) {
+            m_ObjectChanged[index] = 1;
+            m_ChangedObjects.push_back((uint32_t)index);
         }
     }
 
     void SceneManager::UploadLightBuffer(const DirectionalLight& light) {
-        void* data;
-        vmaMapMemory(m_Allocator->GetVmaAllocator(), m_LightUBO.allocation, &data);
-        memcpy(data, &light, sizeof(DirectionalLight));
-        vmaUnmapMemory(m_Allocator->GetVmaAllocator(), m_LightUBO.allocation);
+        m_LightData = light;
+        memcpy(m_LightUBO.Region(m_FrameIndex), &light, sizeof(DirectionalLight));
     }
 
     void SceneManager::UploadCameraBuffer(const Camera& camera, uint32_t width, uint32_t height, uint64_t frameCount, bool useJitter) {
@@ -143,7 +377,7 @@ namespace vortex::graphics {
         
         float aspect = (float)width / (float)height;
         glm::mat4 view = glm::lookAt(camera.position, camera.position + camera.front, camera.up);
-        glm::mat4 proj = glm::perspective(glm::radians(camera.fov), aspect, 0.1f, 400.0f);
+        glm::mat4 proj = glm::perspective(glm::radians(camera.fov), aspect, CAMERA_NEAR, CAMERA_FAR);
         proj[1][1] *= -1; 
 
         if (useJitter) {
@@ -168,142 +402,146 @@ namespace vortex::graphics {
         ubo.prevViewProj = m_PrevViewProj;
         m_PrevViewProj = ubo.viewProj; 
         ubo.viewInverse = glm::inverse(view);
-        ubo.objectCount = (uint32_t)m_VisibleGPUObjects.size(); 
+        ubo.objectCount = (uint32_t)m_GPUObjects.size(); 
 
-        void* data;
-        vmaMapMemory(m_Allocator->GetVmaAllocator(), m_CameraUBO.allocation, &data);
-        memcpy(data, &ubo, sizeof(CameraUBO));
-        vmaUnmapMemory(m_Allocator->GetVmaAllocator(), m_CameraUBO.allocation);
+        m_CameraData = ubo;
+        memcpy(m_CameraUBO.Region(m_FrameIndex), &ubo, sizeof(CameraUBO));
     }
 
-    // --- BVH Implementation ---
+    void SceneManager::WriteGPUObject(uint32_t index) {
+        const SceneObject& obj = m_CachedObjects[index];
+        GPUObject& gpu = m_GPUObjects[index];
+        gpu.model = obj.model;
+        gpu.invModel = glm::inverse(obj.model);
+        gpu.chunkIndex = obj.chunkIndex;
+        gpu.paletteOffset = obj.paletteOffset;
+        gpu.flags = 0;
+        gpu.boundsMin = glm::vec4(obj.boundsMin, 0.0f);
+        gpu.boundsMax = glm::vec4(obj.boundsMax, 0.0f);
+    }
 
-    int SceneManager::BuildBVHRecursive(std::vector<int>& objIndices, std::vector<BVHBuildNode>& nodes, const std::vector<SceneObject*>& objects) {
-        BVHBuildNode node;
-        
-        // 1. Calculate AABB for this set of objects
-        AABB box;
-        for (int idx : objIndices) {
-            box.Grow(AABB::FromMatrix(objects[idx]->model));
+    void SceneManager::BuildTLAS() {
+        // Each object's world bounds (8 corner transforms) are computed once; the builder only reads them back.
+        const uint32_t count = (uint32_t)m_GPUObjects.size();
+        m_TLASBuilder.Reset(count);
+        m_Culler.Reset(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            AABB box = AABB::FromObject(m_CachedObjects[i]);
+            m_TLASBuilder.SetBounds(i, box.min, box.max);
+            m_Culler.SetBounds(i, box.min, box.max);
         }
-        node.min = box.min;
-        node.max = box.max;
-
-        int nodeIndex = (int)nodes.size();
-        nodes.push_back(node);
+        m_TLASNodes.resize(TLASBuilder::NodeCount(count));
+        m_TLASBuilder.Build(m_TLASNodes.data());
+    }
 
-        // Leaf condition
-        if (objIndices.size() == 1) {
-            nodes[nodeIndex].objectIndex = objIndices[0]; // Original Index mapping handled in BuildTLAS
-            return nodeIndex;
+    void SceneManager::PublishChange(std::vector<RegionDelta>& deltas, uint32_t index, size_t count) {
+        for (auto& delta : deltas) {
+            if (delta.full) continue;
+            delta.indices.push_back(index);
+            // Past this, one contiguous copy beats scattered element writes.
+            if (delta.indices.size() > count / 2) {
+                delta.full = true;
+                delta.indices.clear();
+            }
         }
+    }
 
-        // Split
-        glm::vec3 extent = box.max - box.min;
-        int axis = 0;
-        if (extent.y > extent.x) axis = 1;
-        if (extent.z > extent.y && extent.z > extent.x) axis = 2;
-
-        float splitPos = box.Center()[axis];
-
-        std::vector<int> leftIndices, rightIndices;
-        for (int idx : objIndices) {
-            float center = AABB::FromMatrix(objects[idx]->model).Center()[axis];
-            if (center < splitPos) leftIndices.push_back(idx);
-            else rightIndices.push_back(idx);
+    void SceneManager::PublishAll(std::vector<RegionDelta>& deltas) {
+        for (auto& delta : deltas) {
+            delta.full = true;
+            delta.indices.clear();
         }
+    }
 
-        // Fallback for unbalanced split (all in one side)
-        if (leftIndices.empty() || rightIndices.empty()) {
-            size_t mid = objIndices.size() / 2;
-            leftIndices.assign(objIndices.begin(), objIndices.begin() + mid);
-            rightIndices.assign(objIndices.begin() + mid, objIndices.end());
+    void SceneManager::WriteRegion(memory::PerFrameBuffer& buffer, RegionDelta& delta, const void* src, size_t stride, size_t count) {
+        char* dst = (char*)buffer.Region(m_FrameIndex);
+        const char* bytes = (const char*)src;
+        if (delta.full) {
+            memcpy(dst, bytes, stride * count);
+        } else {
+            for (uint32_t index : delta.indices) memcpy(dst + index * stride, bytes + index * stride, stride);
         }
-
-        nodes[nodeIndex].left = BuildBVHRecursive(leftIndices, nodes, objects);
-        nodes[nodeIndex].right = BuildBVHRecursive(rightIndices, nodes, objects);
-        
-        return nodeIndex;
+        delta.full = false;
+        delta.indices.clear();
     }
 
-    void SceneManager::BuildTLAS(const std::vector<SceneObject*>& visibleObjects) {
-        if (visibleObjects.empty()) return;
-
-        std::vector<int> indices(visibleObjects.size());
-        for (size_t i = 0; i < indices.size(); ++i) indices[i] = i;
-
-        std::vector<BVHBuildNode> buildNodes;
-        buildNodes.reserve(visibleObjects.size() * 2);
-        
-        BuildBVHRecursive(indices, buildNodes, visibleObjects);
-
-        // Flatten to GPU format
-        std::vector<GPUBVHNode> gpuNodes;
-        gpuNodes.reserve(buildNodes.size());
+    size_t SceneManager::CullAndUpload(const Camera& camera, float aspectRatio) {
+        if (m_CachedObjects.empty()) {
+            // Nothing to draw or trace; the camera's object count disables the TLAS lookup.
+            m_GPUObjects.clear();
+            m_TLASNodes.clear();
+            m_CullStats = {};
+            return 0;
+        }
+        m_ObjectHighWater = std::max(m_ObjectHighWater, (uint32_t)m_CachedObjects.size());
+        if (m_CachedObjects.size() > m_ObjectCapacity && m_ObjectCapacity < m_MaxObjects) {
+            ResizeObjectBuffers(GrownCapacity(m_CachedObjects.size(), m_ObjectCapacity, m_MaxObjects));
+        }
+        // Objects past the binding limit are neither drawn nor traced.
+        const uint32_t count = (uint32_t)std::min<size_t>(m_CachedObjects.size(), m_ObjectCapacity);
+        uint32_t dropped = (uint32_t)m_CachedObjects.size() - count;
+        if (dropped != m_DroppedObjects) {
+            if (dropped > 0) Log::Warn("Object buffers full, dropping " + std::to_string(dropped) + " objects");
+            m_DroppedObjects = dropped;
+        }
 
-        for (const auto& bn : buildNodes) {
-            GPUBVHNode gn;
-            gn.aabbMin = bn.min;
-            gn.aabbMax = bn.max;
-            
-            if (bn.objectIndex != -1) {
-                // Leaf
-                gn.leftChildOrInstance = (uint32_t)bn.objectIndex; // This is the index into m_VisibleGPUObjects
-                gn.rightChildOrCount = 1; // Leaf marker (count > 0)
-            } else {
-                // Internal
-                gn.leftChildOrInstance = (uint32_t)bn.left;
-                gn.rightChildOrCount = (uint32_t)bn.right;
+        auto start = std::chrono::high_resolution_clock::now();
+        m_TLASStats = {};
+        if (m_ObjectsReplaced || m_GPUObjects.size() != count) {
+            m_GPUObjects.resize(count);
+            for (uint32_t i = 0; i < count; ++i) WriteGPUObject(i);
+            PublishAll(m_ObjectDeltas);
+            m_TLASStats.rebuilt = true;
+        } else {
+            // Moved objects keep their leaf: refit it and its ancestors instead of rebuilding.
+            m_TouchedNodes.clear();
+            for (uint32_t i : m_ChangedObjects) {
+                if (i >= count) continue;
+                WriteGPUObject(i);
+                PublishChange(m_ObjectDeltas, i, count);
+                AABB box = AABB::FromObject(m_CachedObjects[i]);
+                m_TLASBuilder.Refit(m_TLASNodes.data(), i, box.min, box.max, m_TouchedNodes);
+                m_Culler.SetBounds(i, box.min, box.max);
             }
-            gpuNodes.push_back(gn);
-        }
-        
-        // Fix up Leafs
-        for (size_t i=0; i<buildNodes.size(); ++i) {
-            if (buildNodes[i].objectIndex != -1) {
-                gpuNodes[i].leftChildOrInstance = (uint32_t)buildNodes[i].objectIndex;
-                gpuNodes[i].rightChildOrCount = 0xFFFFFFFF; // Mark as Leaf Sentinel
+            m_TLASStats.refitObjects = (uint32_t)m_ChangedObjects.size();
+            m_TLASStats.rebuilt = m_TLASBuilder.GetRefitDegradation() > TLAS_REBUILD_DEGRADATION;
+            if (!m_TLASStats.rebuilt) {
+                for (uint32_t node : m_TouchedNodes) PublishChange(m_TLASDeltas, node, m_TLASNodes.size());
             }
         }
-
-        if (m_MappedTLASBuffer) {
-            memcpy(m_MappedTLASBuffer, gpuNodes.data(), gpuNodes.size() * sizeof(GPUBVHNode));
+        if (m_TLASStats.rebuilt) {
+            BuildTLAS();
+            PublishAll(m_TLASDeltas);
         }
-    }
-
-    size_t SceneManager::CullAndUpload(const Camera& camera, float aspectRatio) {
-        if (m_CachedObjects.empty()) return 0;
+        m_TLASStats.degradation = m_TLASBuilder.GetRefitDegradation();
 
-        std::vector<SceneObject*> visiblePtrs;
-        visiblePtrs.reserve(m_CachedObjects.size());
-        
-        for(auto& obj : m_CachedObjects) {
-            visiblePtrs.push_back(&obj);
-        }
+        for (uint32_t i : m_ChangedObjects) m_ObjectChanged[i] = 0;
+        m_ChangedObjects.clear();
+        m_ObjectsReplaced = false;
 
-        glm::vec3 camPos = camera.position;
-        std::sort(visiblePtrs.begin(), visiblePtrs.end(), [camPos](SceneObject* a, SceneObject* b) {
-            glm::vec3 posA = glm::vec3(a->model[3]);
-            glm::vec3 posB = glm::vec3(b->model[3]);
-            return glm::dot(posA - camPos, posA - camPos) < glm::dot(posB - camPos, posB - camPos);
-        });
+        RegionDelta& tlasDelta = m_TLASDeltas[m_FrameIndex];
+        m_TLASStats.nodesWritten = tlasDelta.full ? (uint32_t)m_TLASNodes.size() : (uint32_t)tlasDelta.indices.size();
+        WriteRegion(m_ObjectsSSBO, m_ObjectDeltas[m_FrameIndex], m_GPUObjects.data(), sizeof(GPUObject), count);
+        WriteRegion(m_TLASBuffer, tlasDelta, m_TLASNodes.data(), sizeof(GPUBVHNode), m_TLASNodes.size());
+        m_TLASStats.updateMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
 
-        m_VisibleGPUObjects.resize(visiblePtrs.size());
-        for(size_t k=0; k < visiblePtrs.size(); ++k) {
-            m_VisibleGPUObjects[k].model = visiblePtrs[k]->model;
-            m_VisibleGPUObjects[k].invModel = glm::inverse(visiblePtrs[k]->model);
-            m_VisibleGPUObjects[k].chunkIndex = visiblePtrs[k]->chunkIndex; 
-            m_VisibleGPUObjects[k].paletteOffset = visiblePtrs[k]->paletteOffset; 
-            m_VisibleGPUObjects[k].flags = 0;
-        }
+        // Draw order only: visible instances are drawn front to back, the object buffer itself never moves.
+        // Unjittered matrices: TAA jitter moves the image by under a pixel, which the conservative test absorbs.
+        start = std::chrono::high_resolution_clock::now();
+        glm::mat4 view = glm::lookAt(camera.position, camera.position + camera.front, camera.up);
+        glm::mat4 proj = glm::perspective(glm::radians(camera.fov), aspectRatio, CAMERA_NEAR, CAMERA_FAR);
+        m_Culler.Cull(Frustum::FromViewProj(proj * view), m_DrawOrder);
 
-        if (!m_VisibleGPUObjects.empty() && m_MappedObjectBuffer) {
-            memcpy(m_MappedObjectBuffer, m_VisibleGPUObjects.data(), m_VisibleGPUObjects.size() * sizeof(GPUObject));
+        // Distances are computed once per visible object; the sort only moves keys.
+        m_DrawDepths.resize(m_DrawOrder.size());
+        for (size_t k = 0; k < m_DrawOrder.size(); ++k) {
+            m_DrawDepths[k] = glm::length(glm::vec3(m_CachedObjects[m_DrawOrder[k]].model[3]) - camera.position);
         }
+        m_DepthSorter.Sort(m_DrawOrder, m_DrawDepths, m_DrawOrderMode);
+        const uint32_t visible = (uint32_t)m_DrawOrder.size();
+        memcpy(m_DrawOrderBuffer.Region(m_FrameIndex), m_DrawOrder.data(), visible * sizeof(uint32_t));
+        m_CullStats = {visible, count, std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count()};
 
-        // --- Build and Upload TLAS ---
-        BuildTLAS(visiblePtrs);
-
-        return m_VisibleGPUObjects.size();
+        return visible;
     }
-}
\ No newline at end of file
+}
@@ -15,6 +15,7 @@ module vortex.graphics;
 
 import :shader; 
 import vortex.log;
+import vortex.voxel;
 
 namespace vortex::graphics {
 
@@ -161,6 +162,23 @@ namespace vortex::graphics {
         }
     }
 
+    /**
+     * @brief Defines shared between C++ and GLSL, so CPU data layouts and shaders cannot drift apart.
+     */
+    static std::string BuildPreamble() {
+        std::string preamble;
+        preamble += "#define CHUNK_LAYOUT_LINEAR " + std::to_string((uint32_t)voxel::ChunkLayout::Linear) + "\n";
+        preamble += "#define CHUNK_LAYOUT_MORTON " + std::to_string((uint32_t)voxel::ChunkLayout::Morton) + "\n";
+        preamble += "#define CHUNK_LAYOUT_BRICK " + std::to_string((uint32_t)voxel::ChunkLayout::Brick) + "\n";
+        preamble += "#define VORTEX_CHUNK_LAYOUT " + std::to_string((uint32_t)voxel::CHUNK_LAYOUT) + "\n";
+        preamble += "#define VORTEX_CHUNK_SIZE " + std::to_string(voxel::CHUNK_SIZE) + "\n";
+        preamble += "#define CHUNK_BLOCKS " + std::to_string(voxel::CHUNK_BLOCKS) + "\n";
+        preamble += "#define CHUNK_WORDS " + std::to_string(voxel::CHUNK_WORDS) + "\n";
+        preamble += "#define CHUNK_FLAG_WORDS " + std::to_string(voxel::CHUNK_FLAG_WORDS) + "\n";
+        preamble += "#define HIERARCHY_WORDS " + std::to_string(voxel::HIERARCHY_WORDS) + "\n";
+        return preamble;
+    }
+
     std::vector<uint32_t> ShaderCompiler::Compile(ShaderStage stage, const std::string& source) {
         EShLanguage lang = MapStage(stage);
         
@@ -168,6 +186,9 @@ namespace vortex::graphics {
         const char* src = source.c_str();
         shader.setStrings(&src, 1);
 
+        static const std::string preamble = BuildPreamble();
+        shader.setPreamble(preamble.c_str());
+
         // Set up environment (Vulkan 1.3, SPIR-V 1.6)
         shader.setEnvInput(glslang::EShSourceGlsl, lang, glslang::EShClientVulkan, 460);
         shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_3);
@@ -0,0 +1,250 @@
+module;
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+module vortex.graphics;
+
+import :staging;
+import vortex.log;
+import vortex.memory;
+
+namespace vortex::graphics {
+
+    // Ring allocations are aligned so copies start on a boundary every transfer engine handles at full speed.
+    static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+    StagingUploader::~StagingUploader() { Shutdown(); }
+
+    void StagingUploader::Initialize(VkDevice device, memory::MemoryAllocator* allocator, VkQueue queue, uint32_t queueFamily,
+                                     uint32_t graphicsQueueFamily, VkSemaphore frameTimeline, VkDeviceSize ringSize) {
+        m_Device = device;
+        m_Allocator = allocator;
+        m_Queue = queue;
+        m_FrameTimeline = frameTimeline;
+        m_QueueFamilies = {graphicsQueueFamily};
+        if (queueFamily != graphicsQueueFamily) m_QueueFamilies.push_back(queueFamily);
+
+        m_Capacity = ringSize;
+        m_Ring = allocator->CreateBuffer(ringSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+        void* mapped = nullptr;
+        if (vmaMapMemory(allocator->GetVmaAllocator(), m_Ring.allocation, &mapped) != VK_SUCCESS) {
+            Log::Error("Failed to map staging ring!");
+        }
+        m_Mapped = (char*)mapped;
+
+        VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = queueFamily;
+        vkCreateCommandPool(device, &poolInfo, nullptr, &m_CommandPool);
+
+        VkSemaphoreTypeCreateInfo typeInfo{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+        VkSemaphoreCreateInfo semInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+        semInfo.pNext = &typeInfo;
+        vkCreateSemaphore(device, &semInfo, nullptr, &m_Timeline);
+
+        Log::Info("Staging ring: " + std::to_string(ringSize >> 20) + " MB, " +
+                  (m_QueueFamilies.size() > 1 ? "dedicated transfer queue" : "shared graphics queue"));
+    }
+
+    void StagingUploader::Shutdown() {
+        if (!m_Device) return;
+        // The caller waits for the device to idle, so every batch has completed.
+        if (m_Mapped) {
+            vmaUnmapMemory(m_Allocator->GetVmaAllocator(), m_Ring.allocation);
+            m_Mapped = nullptr;
+        }
+        m_Allocator->DestroyBuffer(m_Ring);
+        vkDestroyCommandPool(m_Device, m_CommandPool, nullptr);
+        vkDestroySemaphore(m_Device, m_Timeline, nullptr);
+        m_Pending.clear();
+        m_InFlight.clear();
+        m_FreeCommandBuffers.clear();
+        m_Device = VK_NULL_HANDLE;
+    }
+
+    void StagingUploader::Reclaim(bool waitOldest) {
+        if (m_InFlight.empty()) return;
+
+        if (waitOldest) {
+            auto start = std::chrono::high_resolution_clock::now();
+            VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+            waitInfo.semaphoreCount = 1;
+            waitInfo.pSemaphores = &m_Timeline;
+            waitInfo.pValues = &m_InFlight.front().value;
+            vkWaitSemaphores(m_Device, &waitInfo, UINT64_MAX);
+            auto end = std::chrono::high_resolution_clock::now();
+            m_Stats.stalls++;
+            m_Stats.stallMs += std::chrono::duration<float, std::milli>(end - start).count();
+        }
+
+        uint64_t completed = 0;
+        vkGetSemaphoreCounterValue(m_Device, m_Timeline, &completed);
+        while (!m_InFlight.empty() && m_InFlight.front().value <= completed) {
+            m_Used -= m_InFlight.front().bytes;
+            m_FreeCommandBuffers.push_back(m_InFlight.front().cmd);
+            m_InFlight.pop_front();
+        }
+        // An empty ring restarts at the front, so the next large write does not have to wrap.
+        if (m_Used == 0) m_Head = 0;
+    }
+
+    void* StagingUploader::Stage(VkBuffer dst, VkDeviceSize dstOffset, VkDeviceSize size) {
+        VkDeviceSize alignedSize = (size + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+        if (alignedSize > m_Capacity) {
+            Log::Error("Staging write of " + std::to_string(size) + " bytes exceeds the ring");
+            return nullptr;
+        }
+
+        Reclaim(false);
+        VkDeviceSize offset, padding;
+        for (;;) {
+            // An allocation never straddles the end of the ring; the skipped tail counts as used until released.
+            offset = m_Head;
+            padding = 0;
+            if (offset + alignedSize > m_Capacity) {
+                padding = m_Capacity - offset;
+                offset = 0;
+            }
+            if (m_Used + padding + alignedSize <= m_Capacity) break;
+
+            // Full: submit what is pending so it can drain, then wait for the oldest batch.
+            if (!m_Pending.empty()) Flush();
+            Reclaim(true);
+        }
+
+        m_Head = offset + alignedSize;
+        m_Used += padding + alignedSize;
+        m_PendingBytes += padding + alignedSize;
+
+        // Consecutive writes to consecutive bytes (e.g. a chunk's dirty ranges) merge into one copy region.
+        if (!m_Pending.empty()) {
+            PendingCopy& last = m_Pending.back();
+            if (last.dst == dst && last.region.srcOffset + last.region.size == offset &&
+                last.region.dstOffset + last.region.size == dstOffset) {
+                last.region.size += size;
+                m_Stats.bytes += size;
+                return m_Mapped + offset;
+            }
+        }
+        m_Pending.push_back({dst, {offset, dstOffset, size}});
+        m_Stats.bytes += size;
+        return m_Mapped + offset;
+    }
+
+    void StagingUploader::Write(VkBuffer dst, VkDeviceSize dstOffset, const void* src, VkDeviceSize size) {
+        // Pieces of half the ring let one piece be filled while the previous one is still being copied.
+        const VkDeviceSize maxPiece = std::max<VkDeviceSize>(m_Capacity / 2, STAGING_ALIGNMENT);
+        const char* bytes = (const char*)src;
+        while (size > 0) {
+            VkDeviceSize piece = std::min(size, maxPiece);
+            void* staged = Stage(dst, dstOffset, piece);
+            if (!staged) return;
+            memcpy(staged, bytes, piece);
+            bytes += piece;
+            dstOffset += piece;
+            size -= piece;
+        }
+    }
+
+    VkCommandBuffer StagingUploader::AcquireCommandBuffer() {
+        if (!m_FreeCommandBuffers.empty()) {
+            VkCommandBuffer cmd = m_FreeCommandBuffers.back();
+            m_FreeCommandBuffers.pop_back();
+            vkResetCommandBuffer(cmd, 0);
+            return cmd;
+        }
+        VkCommandBuffer cmd;
+        VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+        allocInfo.commandPool = m_CommandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        vkAllocateCommandBuffers(m_Device, &allocInfo, &cmd);
+        return cmd;
+    }
+
+    uint64_t StagingUploader::Flush() {
+        if (m_Pending.empty()) return m_LastSignaled;
+
+        // Host writes to the ring become visible to the transfer at submission (the ring is host-coherent).
+        VkCommandBuffer cmd = AcquireCommandBuffer();
+        VkCommandBufferBeginInfo begin{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+        begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(cmd, &begin);
+
+        // One vkCmdCopyBuffer per destination. The sort is stable, so writes to one buffer keep their order.
+        std::stable_sort(m_Pending.begin(), m_Pending.end(), [](const PendingCopy& a, const PendingCopy& b) { return a.dst < b.dst; });
+        std::vector<VkBufferCopy> regions, sorted;
+        for (size_t i = 0; i < m_Pending.size();) {
+            size_t j = i;
+            regions.clear();
+            while (j < m_Pending.size() && m_Pending[j].dst == m_Pending[i].dst) regions.push_back(m_Pending[j++].region);
+
+            // Regions of one copy command are unordered. If the same bytes were written twice in this batch (two
+            // uploads between flushes), issue the copies one by one so the later write wins.
+            sorted = regions;
+            std::sort(sorted.begin(), sorted.end(), [](const VkBufferCopy& a, const VkBufferCopy& b) { return a.dstOffset < b.dstOffset; });
+            bool overlap = false;
+            for (size_t k = 1; k < sorted.size() && !overlap; ++k) {
+                overlap = sorted[k].dstOffset < sorted[k - 1].dstOffset + sorted[k - 1].size;
+            }
+
+            if (!overlap) {
+                vkCmdCopyBuffer(cmd, m_Ring.buffer, m_Pending[i].dst, (uint32_t)regions.size(), regions.data());
+            } else {
+                VkMemoryBarrier barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+                for (size_t k = 0; k < regions.size(); ++k) {
+                    if (k > 0) vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+                    vkCmdCopyBuffer(cmd, m_Ring.buffer, m_Pending[i].dst, 1, &regions[k]);
+                }
+            }
+            i = j;
+        }
+        vkEndCommandBuffer(cmd);
+
+        uint64_t signalValue = m_LastSignaled + 1;
+        uint64_t waitValue = m_FrameWaitValue;
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+        VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+        timelineInfo.waitSemaphoreValueCount = 1;
+        timelineInfo.pWaitSemaphoreValues = &waitValue;
+        timelineInfo.signalSemaphoreValueCount = 1;
+        timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+        VkSubmitInfo submit{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+        submit.pNext = &timelineInfo;
+        // Destinations may still be read by the frames in flight; the copy starts after the last of them.
+        submit.waitSemaphoreCount = 1;
+        submit.pWaitSemaphores = &m_FrameTimeline;
+        submit.pWaitDstStageMask = &waitStage;
+        submit.commandBufferCount = 1;
+        submit.pCommandBuffers = &cmd;
+        submit.signalSemaphoreCount = 1;
+        submit.pSignalSemaphores = &m_Timeline;
+        vkQueueSubmit(m_Queue, 1, &submit, VK_NULL_HANDLE);
+
+        m_InFlight.push_back({signalValue, m_PendingBytes, cmd});
+        m_LastSignaled = signalValue;
+        m_PendingBytes = 0;
+        m_Pending.clear();
+        m_Stats.batches++;
+        return signalValue;
+    }
+
+    StagingStats StagingUploader::TakeStats() {
+        StagingStats stats = m_Stats;
+        m_Stats = {};
+        return stats;
+    }
+}
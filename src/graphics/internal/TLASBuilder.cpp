@@ -0,0 +1,242 @@
+module;
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+module vortex.graphics;
+
+import :tlas;
+import vortex.jobs;
+
+namespace vortex::graphics {
+
+    // Ranges at least this large build their left subtree as a job; smaller ones are not worth the task overhead.
+    static constexpr uint32_t PARALLEL_MIN_INSTANCES = 2048;
+
+    static float HalfArea(const glm::vec3& min, const glm::vec3& max) {
+        glm::vec3 e = max - min;
+        return e.x * e.y + e.y * e.z + e.z * e.x;
+    }
+
+    static float HalfArea(const GPUBVHNode& node) { return HalfArea(node.aabbMin, node.aabbMax); }
+
+    void TLASBuilder::Reset(uint32_t count) {
+        m_Count = count;
+        m_MinX.resize(count); m_MinY.resize(count); m_MinZ.resize(count);
+        m_MaxX.resize(count); m_MaxY.resize(count); m_MaxZ.resize(count);
+        m_Indices.resize(count);
+        m_LeafOf.resize(count);
+        m_Parents.resize(NodeCount(count));
+    }
+
+    void TLASBuilder::Build(GPUBVHNode* out) {
+        if (m_Count == 0) return;
+        Range root{0, m_Count};
+        for (uint32_t i = 0; i < m_Count; ++i) {
+            m_Indices[i] = i;
+            glm::vec3 mn{m_MinX[i], m_MinY[i], m_MinZ[i]};
+            glm::vec3 mx{m_MaxX[i], m_MaxY[i], m_MaxZ[i]};
+            root.bounds.Grow(mn, mx);
+            root.centroids.Grow(mn + mx);
+        }
+        m_Parents[0] = LEAF_SENTINEL;
+        BuildRange(out, 0, root, 0);
+
+        // The area sum is only needed for refits; one pass over the nodes is cheap next to the build.
+        m_RootArea = HalfArea(out[0]);
+        m_AreaSum = 0.0;
+        for (uint32_t i = 0; i < NodeCount(m_Count); ++i) m_AreaSum += HalfArea(out[i]);
+        m_BuiltCost = SAHCost(out, NodeCount(m_Count));
+    }
+
+    TLASBuilder::Range TLASBuilder::MakeRange(uint32_t begin, uint32_t end) const {
+        Range r{begin, end};
+        for (uint32_t i = begin; i < end; ++i) {
+            glm::vec3 mn{m_MinX[i], m_MinY[i], m_MinZ[i]};
+            glm::vec3 mx{m_MaxX[i], m_MaxY[i], m_MaxZ[i]};
+            r.bounds.Grow(mn, mx);
+            r.centroids.Grow(mn + mx);
+        }
+        return r;
+    }
+
+    void TLASBuilder::Swap(uint32_t a, uint32_t b) {
+        std::swap(m_MinX[a], m_MinX[b]); std::swap(m_MinY[a], m_MinY[b]); std::swap(m_MinZ[a], m_MinZ[b]);
+        std::swap(m_MaxX[a], m_MaxX[b]); std::swap(m_MaxY[a], m_MaxY[b]); std::swap(m_MaxZ[a], m_MaxZ[b]);
+        std::swap(m_Indices[a], m_Indices[b]);
+    }
+
+    void TLASBuilder::SelectMedian(const float* axisMin, const float* axisMax, uint32_t begin, uint32_t mid, uint32_t end) {
+        // Quickselect with a three-way partition, so runs of equal centroids cannot stall it.
+        while (end - begin > 1) {
+            uint32_t p = begin + (end - begin) / 2;
+            float pivot = axisMin[p] + axisMax[p];
+            uint32_t lt = begin, i = begin, gt = end;
+            while (i < gt) {
+                float key = axisMin[i] + axisMax[i];
+                if (key < pivot) Swap(lt++, i++);
+                else if (key > pivot) Swap(i, --gt);
+                else ++i;
+            }
+            if (mid < lt) end = lt;
+            else if (mid >= gt) begin = gt;
+            else return;
+        }
+    }
+
+    void TLASBuilder::BuildRange(GPUBVHNode* out, uint32_t nodeIndex, const Range& range, uint32_t depth) {
+        const uint32_t begin = range.begin, end = range.end, count = end - begin;
+
+        if (count == 1) {
+            uint32_t i = begin;
+            out[nodeIndex] = {{m_MinX[i], m_MinY[i], m_MinZ[i]}, m_Indices[i], {m_MaxX[i], m_MaxY[i], m_MaxZ[i]}, LEAF_SENTINEL};
+            m_LeafOf[m_Indices[i]] = nodeIndex;
+            return;
+        }
+
+        const float* minAxis[3] = {m_MinX.data(), m_MinY.data(), m_MinZ.data()};
+        const float* maxAxis[3] = {m_MaxX.data(), m_MaxY.data(), m_MaxZ.data()};
+        glm::vec3 extent = range.centroids.max - range.centroids.min;
+
+        Range left, right;
+        bool split = false;
+
+        // Past this depth a median split is needed everywhere below to stay within MAX_DEPTH.
+        uint32_t balancedDepth = 0;
+        while ((1u << balancedDepth) < count) ++balancedDepth;
+
+        // Binned along the widest centroid axis only: binning all three roughly triples the build time for a
+        // few percent of SAH cost, which does not pay off for a tree that is rebuilt at runtime.
+        int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        const float* axisMin = minAxis[axis];
+        const float* axisMax = maxAxis[axis];
+
+        if (count > 2 && extent[axis] > 0.0f && depth + balancedDepth < MAX_DEPTH) {
+            const float origin = range.centroids.min[axis];
+            const float scale = (float)BIN_COUNT / extent[axis];
+            auto binOf = [&](uint32_t i) { return std::min(BIN_COUNT - 1, (uint32_t)((axisMin[i] + axisMax[i] - origin) * scale)); };
+
+            Bin bins[BIN_COUNT];
+            for (uint32_t i = begin; i < end; ++i) {
+                Bin& bin = bins[binOf(i)];
+                bin.bounds.Grow({m_MinX[i], m_MinY[i], m_MinZ[i]}, {m_MaxX[i], m_MaxY[i], m_MaxZ[i]});
+                bin.count++;
+            }
+
+            // Right-to-left accumulates the right side of every plane, left-to-right evaluates them.
+            Bounds rightBounds[BIN_COUNT];
+            uint32_t rightCount[BIN_COUNT];
+            Bounds acc;
+            uint32_t n = 0;
+            for (uint32_t b = BIN_COUNT - 1; b > 0; --b) {
+                acc.Grow(bins[b].bounds);
+                n += bins[b].count;
+                rightBounds[b] = acc;
+                rightCount[b] = n;
+            }
+            float bestCost = FLT_MAX;
+            uint32_t bestSplit = 0;
+            acc = {};
+            n = 0;
+            for (uint32_t b = 1; b < BIN_COUNT; ++b) {
+                acc.Grow(bins[b - 1].bounds);
+                n += bins[b - 1].count;
+                if (n == 0 || rightCount[b] == 0) continue;
+                float cost = (float)n * acc.HalfArea() + (float)rightCount[b] * rightBounds[b].HalfArea();
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = b;
+                    left.bounds = acc;
+                    right.bounds = rightBounds[b];
+                }
+            }
+
+            // The centroid extent is non-zero, so both end bins hold an instance and some plane always splits.
+            // In-place partition; the children's centroid bounds are gathered on the way so no extra pass is needed.
+            auto centroidOf = [&](uint32_t i) {
+                return glm::vec3{m_MinX[i] + m_MaxX[i], m_MinY[i] + m_MaxY[i], m_MinZ[i] + m_MaxZ[i]};
+            };
+            uint32_t lo = begin, hi = end;
+            for (;;) {
+                while (lo < hi && binOf(lo) < bestSplit) left.centroids.Grow(centroidOf(lo++));
+                while (lo < hi && binOf(hi - 1) >= bestSplit) right.centroids.Grow(centroidOf(--hi));
+                if (lo >= hi) break;
+                Swap(lo, hi - 1);
+            }
+            left.begin = begin; left.end = lo;
+            right.begin = lo; right.end = end;
+            split = true;
+        }
+
+        // Median split: the fallback for coincident centroids and the rule near MAX_DEPTH. Halving the range keeps
+        // the remaining depth at ceil(log2(count)).
+        if (!split) {
+            uint32_t mid = begin + count / 2;
+            // Coincident centroids need no ordering at all.
+            if (extent[axis] > 0.0f) SelectMedian(axisMin, axisMax, begin, mid, end);
+            left = MakeRange(begin, mid);
+            right = MakeRange(mid, end);
+        }
+
+        uint32_t leftIndex = nodeIndex + 1;
+        uint32_t rightIndex = nodeIndex + NodeCount(left.end - left.begin) + 1;
+        out[nodeIndex] = {range.bounds.min, leftIndex, range.bounds.max, rightIndex};
+        m_Parents[leftIndex] = nodeIndex;
+        m_Parents[rightIndex] = nodeIndex;
+
+        if (count >= PARALLEL_MIN_INSTANCES && jobs::JobSystem::IsInitialized()) {
+            jobs::TaskGroup group;
+            group.Run([&, this]() { BuildRange(out, leftIndex, left, depth + 1); });
+            BuildRange(out, rightIndex, right, depth + 1);
+            group.Wait();
+        } else {
+            BuildRange(out, leftIndex, left, depth + 1);
+            BuildRange(out, rightIndex, right, depth + 1);
+        }
+    }
+
+    void TLASBuilder::Refit(GPUBVHNode* nodes, uint32_t instance, const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& touched) {
+        uint32_t node = m_LeafOf[instance];
+        GPUBVHNode& leaf = nodes[node];
+        if (leaf.aabbMin == min && leaf.aabbMax == max) return;
+        m_AreaSum += HalfArea(min, max) - HalfArea(leaf);
+        leaf.aabbMin = min;
+        leaf.aabbMax = max;
+        touched.push_back(node);
+        if (node == 0) m_RootArea = HalfArea(leaf);
+
+        while ((node = m_Parents[node]) != LEAF_SENTINEL) {
+            GPUBVHNode& parent = nodes[node];
+            const GPUBVHNode& l = nodes[parent.leftChildOrInstance];
+            const GPUBVHNode& r = nodes[parent.rightChildOrCount];
+            glm::vec3 mn = glm::min(l.aabbMin, r.aabbMin);
+            glm::vec3 mx = glm::max(l.aabbMax, r.aabbMax);
+            if (mn == parent.aabbMin && mx == parent.aabbMax) break;
+            m_AreaSum += HalfArea(mn, mx) - HalfArea(parent);
+            parent.aabbMin = mn;
+            parent.aabbMax = mx;
+            touched.push_back(node);
+            if (node == 0) m_RootArea = HalfArea(parent);
+        }
+    }
+
+    float TLASBuilder::GetRefitDegradation() const {
+        if (m_BuiltCost <= 0.0f || m_RootArea <= 0.0f) return 1.0f;
+        return (float)(m_AreaSum / m_RootArea) / m_BuiltCost;
+    }
+
+    float TLASBuilder::SAHCost(const GPUBVHNode* nodes, uint32_t nodeCount) {
+        if (nodeCount == 0) return 0.0f;
+        float rootArea = HalfArea(nodes[0]);
+        if (rootArea <= 0.0f) return 0.0f;
+
+        // Each node costs its probability of being visited (area ratio to the root): one traversal step for
+        // internal nodes, one instance test for leaves.
+        double cost = 0.0;
+        for (uint32_t i = 0; i < nodeCount; ++i) cost += HalfArea(nodes[i]);
+        return (float)(cost / rootArea);
+    }
+}
@@ -21,21 +21,36 @@ namespace vortex::graphics {
 
         /**
          * @brief Initializes the graphics pipeline, layout, and descriptors.
+         * @details Camera, object, light, TLAS and draw order buffers are per-frame buffers bound as dynamic
+         * descriptors; Bind selects the region of the frame being recorded.
          */
         void Initialize(VkDevice device, 
                         VkFormat colorFormat,
                         VkFormat velocityFormat, 
                         VkFormat depthFormat,
                         uint32_t framesInFlight,
-                        const memory::AllocatedBuffer& cameraBuffer,
+                        const memory::PerFrameBuffer& cameraBuffer,
                         const memory::AllocatedBuffer& materialBuffer,
-                        const memory::AllocatedBuffer& objectBuffer,
+                        const memory::PerFrameBuffer& objectBuffer,
                         const memory::AllocatedBuffer& chunkBuffer,
-                        const memory::AllocatedBuffer& lightBuffer,
-                        const memory::AllocatedBuffer& tlasBuffer); // Added TLAS buffer
+                        const memory::PerFrameBuffer& lightBuffer,
+                        const memory::PerFrameBuffer& tlasBuffer,
+                        const memory::PerFrameBuffer& drawOrderBuffer);
 
         void Shutdown();
         
+        /**
+         * @brief Points the descriptor sets at new buffers (e.g. after SceneManager resized one).
+         * @details Each frame's set is rewritten lazily by its next Bind, when that frame is no longer in flight.
+         */
+        void SetBuffers(const memory::PerFrameBuffer& cameraBuffer,
+                        const memory::AllocatedBuffer& materialBuffer,
+                        const memory::PerFrameBuffer& objectBuffer,
+                        const memory::AllocatedBuffer& chunkBuffer,
+                        const memory::PerFrameBuffer& lightBuffer,
+                        const memory::PerFrameBuffer& tlasBuffer,
+                        const memory::PerFrameBuffer& drawOrderBuffer);
+
         void Bind(VkCommandBuffer cmd, uint32_t frameIndex);
         void UpdateDescriptors(uint32_t frameIndex);
 
@@ -48,6 +63,7 @@ namespace vortex::graphics {
         VkDescriptorPool m_DescriptorPool{VK_NULL_HANDLE};
         
         std::vector<VkDescriptorSet> m_DescriptorSets;
+        std::vector<bool> m_DescriptorsStale;
 
         VkBuffer m_CameraBuffer{VK_NULL_HANDLE};
         VkBuffer m_MaterialBuffer{VK_NULL_HANDLE};
@@ -55,5 +71,13 @@ namespace vortex::graphics {
         VkBuffer m_ChunkBuffer{VK_NULL_HANDLE};
         VkBuffer m_LightBuffer{VK_NULL_HANDLE};
         VkBuffer m_TLASBuffer{VK_NULL_HANDLE};
+        VkBuffer m_DrawOrderBuffer{VK_NULL_HANDLE};
+
+        // Region size of each per-frame buffer: descriptor range and dynamic offset stride.
+        VkDeviceSize m_CameraRegion{0};
+        VkDeviceSize m_ObjectRegion{0};
+        VkDeviceSize m_LightRegion{0};
+        VkDeviceSize m_TLASRegion{0};
+        VkDeviceSize m_DrawOrderRegion{0};
     };
 }
\ No newline at end of file
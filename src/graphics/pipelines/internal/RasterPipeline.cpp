@@ -32,29 +32,27 @@ namespace vortex::graphics {
                                     VkFormat velocityFormat, 
                                     VkFormat depthFormat,
                                     uint32_t framesInFlight, 
-                                    const memory::AllocatedBuffer& cameraBuffer,
+                                    const memory::PerFrameBuffer& cameraBuffer,
                                     const memory::AllocatedBuffer& materialBuffer,
-                                    const memory::AllocatedBuffer& objectBuffer,
+                                    const memory::PerFrameBuffer& objectBuffer,
                                     const memory::AllocatedBuffer& chunkBuffer,
-                                    const memory::AllocatedBuffer& lightBuffer,
-                                    const memory::AllocatedBuffer& tlasBuffer) {
+                                    const memory::PerFrameBuffer& lightBuffer,
+                                    const memory::PerFrameBuffer& tlasBuffer,
+                                    const memory::PerFrameBuffer& drawOrderBuffer) {
         m_Device = device;
-        m_CameraBuffer = cameraBuffer.buffer;
-        m_MaterialBuffer = materialBuffer.buffer;
-        m_ObjectBuffer = objectBuffer.buffer;
-        m_ChunkBuffer = chunkBuffer.buffer;
-        m_LightBuffer = lightBuffer.buffer;
-        m_TLASBuffer = tlasBuffer.buffer;
+        SetBuffers(cameraBuffer, materialBuffer, objectBuffer, chunkBuffer, lightBuffer, tlasBuffer, drawOrderBuffer);
 
-        // Increased bindings to 6
-        std::vector<VkDescriptorSetLayoutBinding> bindings(6);
-        bindings[0] = {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
+        // Per-frame data (camera, objects, light, TLAS, draw order) is dynamic: one set layout, offset chosen at bind time.
+        std::vector<VkDescriptorSetLayoutBinding> bindings(7);
+        bindings[0] = {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
         bindings[1] = {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
-        bindings[2] = {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
+        bindings[2] = {2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
         bindings[3] = {3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
-        bindings[4] = {4, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
+        bindings[4] = {4, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
         // TLAS Binding
-        bindings[5] = {5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
+        bindings[5] = {5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr};
+        // Draw order: object index per instance
+        bindings[6] = {6, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr};
 
         VkDescriptorSetLayoutCreateInfo layoutInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
         layoutInfo.bindingCount = (uint32_t)bindings.size();
@@ -155,12 +153,13 @@ namespace vortex::graphics {
 
         // Descriptors
         VkDescriptorPoolSize sizes[] = {
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 * framesInFlight }, 
-            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * framesInFlight } // Increased
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 2 * framesInFlight }, 
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 3 * framesInFlight },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * framesInFlight }
         };
         VkDescriptorPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
         poolInfo.maxSets = framesInFlight;
-        poolInfo.poolSizeCount = 2;
+        poolInfo.poolSizeCount = 3;
         poolInfo.pPoolSizes = sizes;
         vkCreateDescriptorPool(m_Device, &poolInfo, nullptr, &m_DescriptorPool);
 
@@ -172,6 +171,7 @@ namespace vortex::graphics {
         
         m_DescriptorSets.resize(framesInFlight);
         vkAllocateDescriptorSets(m_Device, &allocInfo, m_DescriptorSets.data());
+        m_DescriptorsStale.assign(framesInFlight, false);
 
         for(uint32_t i=0; i<framesInFlight; i++) {
             UpdateDescriptors(i);
@@ -181,27 +181,65 @@ namespace vortex::graphics {
     }
 
     void RasterPipeline::UpdateDescriptors(uint32_t frameIndex) {
-        VkDescriptorBufferInfo camInfo{m_CameraBuffer, 0, VK_WHOLE_SIZE};
+        // Dynamic bindings cover one region; the bind-time offset selects which.
+        VkDescriptorBufferInfo camInfo{m_CameraBuffer, 0, m_CameraRegion};
         VkDescriptorBufferInfo matInfo{m_MaterialBuffer, 0, VK_WHOLE_SIZE};
-        VkDescriptorBufferInfo objInfo{m_ObjectBuffer, 0, VK_WHOLE_SIZE};
+        VkDescriptorBufferInfo objInfo{m_ObjectBuffer, 0, m_ObjectRegion};
         VkDescriptorBufferInfo chkInfo{m_ChunkBuffer, 0, VK_WHOLE_SIZE};
-        VkDescriptorBufferInfo lightInfo{m_LightBuffer, 0, VK_WHOLE_SIZE};
-        VkDescriptorBufferInfo tlasInfo{m_TLASBuffer, 0, VK_WHOLE_SIZE};
+        VkDescriptorBufferInfo lightInfo{m_LightBuffer, 0, m_LightRegion};
+        VkDescriptorBufferInfo tlasInfo{m_TLASBuffer, 0, m_TLASRegion};
+        VkDescriptorBufferInfo orderInfo{m_DrawOrderBuffer, 0, m_DrawOrderRegion};
 
-        std::vector<VkWriteDescriptorSet> writes(6);
-        writes[0] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 0, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, nullptr, &camInfo, nullptr};
+        std::vector<VkWriteDescriptorSet> writes(7);
+        writes[0] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 0, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, nullptr, &camInfo, nullptr};
         writes[1] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 1, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &matInfo, nullptr};
-        writes[2] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 2, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &objInfo, nullptr};
+        writes[2] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 2, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, nullptr, &objInfo, nullptr};
         writes[3] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 3, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &chkInfo, nullptr};
-        writes[4] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 4, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, nullptr, &lightInfo, nullptr};
-        writes[5] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 5, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &tlasInfo, nullptr};
+        writes[4] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 4, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, nullptr, &lightInfo, nullptr};
+        writes[5] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 5, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, nullptr, &tlasInfo, nullptr};
+        writes[6] = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, m_DescriptorSets[frameIndex], 6, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, nullptr, &orderInfo, nullptr};
 
         vkUpdateDescriptorSets(m_Device, (uint32_t)writes.size(), writes.data(), 0, nullptr);
     }
 
+    void RasterPipeline::SetBuffers(const memory::PerFrameBuffer& cameraBuffer,
+                                    const memory::AllocatedBuffer& materialBuffer,
+                                    const memory::PerFrameBuffer& objectBuffer,
+                                    const memory::AllocatedBuffer& chunkBuffer,
+                                    const memory::PerFrameBuffer& lightBuffer,
+                                    const memory::PerFrameBuffer& tlasBuffer,
+                                    const memory::PerFrameBuffer& drawOrderBuffer) {
+        m_CameraBuffer = cameraBuffer.buffer.buffer;
+        m_MaterialBuffer = materialBuffer.buffer;
+        m_ObjectBuffer = objectBuffer.buffer.buffer;
+        m_ChunkBuffer = chunkBuffer.buffer;
+        m_LightBuffer = lightBuffer.buffer.buffer;
+        m_TLASBuffer = tlasBuffer.buffer.buffer;
+        m_DrawOrderBuffer = drawOrderBuffer.buffer.buffer;
+        m_CameraRegion = cameraBuffer.regionSize;
+        m_ObjectRegion = objectBuffer.regionSize;
+        m_LightRegion = lightBuffer.regionSize;
+        m_TLASRegion = tlasBuffer.regionSize;
+        m_DrawOrderRegion = drawOrderBuffer.regionSize;
+        m_DescriptorsStale.assign(m_DescriptorSets.size(), true);
+    }
+
     void RasterPipeline::Bind(VkCommandBuffer cmd, uint32_t frameIndex) {
+        // Safe here: the caller waited for this frame's fence, so its set is not in use.
+        if (m_DescriptorsStale[frameIndex]) {
+            UpdateDescriptors(frameIndex);
+            m_DescriptorsStale[frameIndex] = false;
+        }
+        // In binding order: camera (0), objects (2), light (4), TLAS (5), draw order (6).
+        uint32_t dynamicOffsets[] = {
+            (uint32_t)(m_CameraRegion * frameIndex),
+            (uint32_t)(m_ObjectRegion * frameIndex),
+            (uint32_t)(m_LightRegion * frameIndex),
+            (uint32_t)(m_TLASRegion * frameIndex),
+            (uint32_t)(m_DrawOrderRegion * frameIndex)
+        };
         vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Pipeline);
-        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &m_DescriptorSets[frameIndex], 0, nullptr);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1, &m_DescriptorSets[frameIndex], 5, dynamicOffsets);
     }
 
     void RasterPipeline::Shutdown() {
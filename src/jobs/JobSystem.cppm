@@ -0,0 +1,129 @@
+module;
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+
+export module vortex.jobs;
+
+namespace vortex::jobs {
+
+    export class TaskGroup;
+    struct Task;
+
+    /**
+     * @brief Engine-wide thread pool with per-worker work-stealing queues.
+     * @details Workers pop their own queue LIFO (cache-warm, depth-first) and steal FIFO from others.
+     * Tasks submitted from non-worker threads go to a shared injection queue.
+     * Threads waiting on a TaskGroup execute pending tasks instead of blocking, so nested
+     * ParallelFor calls and Jolt barriers never deadlock.
+     */
+    export class JobSystem {
+    public:
+        /**
+         * @brief Starts the worker threads.
+         * @param workerCount Number of workers. 0 = hardware_concurrency() - 1 (the main thread also works while waiting).
+         */
+        static void Initialize(uint32_t workerCount = 0);
+
+        /**
+         * @brief Drains the queues and joins all workers.
+         */
+        static void Shutdown();
+
+        static bool IsInitialized();
+
+        /**
+         * @brief Number of background worker threads.
+         */
+        static uint32_t GetWorkerCount();
+
+        /**
+         * @brief Index of the calling worker (0..WorkerCount-1), or -1 for threads not owned by the pool.
+         */
+        static int32_t GetCurrentWorkerIndex();
+
+        /**
+         * @brief Queues a task. If a group is given, it is counted until the task finishes.
+         * @details Runs the task inline if the pool is not initialized.
+         */
+        static void Submit(std::function<void()> task, TaskGroup* group = nullptr);
+
+        /**
+         * @brief Executes one pending task on the calling thread, if any is available.
+         * @return True if a task was executed.
+         */
+        static bool RunPendingTask();
+
+        /**
+         * @brief Short pause used by spin-waits when no task could be found.
+         */
+        static void Backoff();
+
+        /**
+         * @brief Splits [0, count) into ranges of at most grainSize and calls fn(begin, end) for each in parallel.
+         * @details Blocks until all ranges are done; the calling thread participates.
+         */
+        template<typename Fn>
+        static void ParallelFor(size_t count, size_t grainSize, const Fn& fn);
+
+    private:
+        static void Execute(Task& task);
+        static void WorkerLoop(int32_t index);
+    };
+
+    /**
+     * @brief Counter of outstanding tasks that can be waited on.
+     */
+    export class TaskGroup {
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+        ~TaskGroup() { Wait(); }
+
+        /**
+         * @brief Submits a task belonging to this group.
+         */
+        void Run(std::function<void()> task) {
+            JobSystem::Submit(std::move(task), this);
+        }
+
+        /**
+         * @brief Blocks until every task of the group has finished, executing other tasks meanwhile.
+         */
+        void Wait() {
+            while (m_Pending.load(std::memory_order_acquire) != 0) {
+                if (!JobSystem::RunPendingTask()) JobSystem::Backoff();
+            }
+        }
+
+        bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+        std::atomic<uint32_t> m_Pending{0};
+    };
+
+    template<typename Fn>
+    void JobSystem::ParallelFor(size_t count, size_t grainSize, const Fn& fn) {
+        if (count == 0) return;
+        grainSize = std::max<size_t>(grainSize, 1);
+
+        if (!IsInitialized() || count <= grainSize) {
+            fn(size_t(0), count);
+            return;
+        }
+
+        TaskGroup group;
+        // Keep the first range for the calling thread.
+        for (size_t begin = grainSize; begin < count; begin += grainSize) {
+            size_t end = std::min(count, begin + grainSize);
+            group.Run([&fn, begin, end]() { fn(begin, end); });
+        }
+        fn(size_t(0), grainSize);
+        group.Wait();
+    }
+}
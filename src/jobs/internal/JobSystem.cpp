@@ -0,0 +1,195 @@
+module;
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+module vortex.jobs;
+
+import vortex.log;
+
+namespace vortex::jobs {
+
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup* group = nullptr;
+    };
+
+    /**
+     * @brief Mutex-guarded deque. The owner uses the back, thieves use the front.
+     */
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+
+        void Push(Task&& task) {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+
+        bool PopBack(Task& out) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (tasks.empty()) return false;
+            out = std::move(tasks.back());
+            tasks.pop_back();
+            return true;
+        }
+
+        bool PopFront(Task& out) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (tasks.empty()) return false;
+            out = std::move(tasks.front());
+            tasks.pop_front();
+            return true;
+        }
+    };
+
+    struct JobSystemData {
+        std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<WorkQueue>> queues; // One per worker
+        WorkQueue injection;                            // Submissions from external threads
+
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        std::atomic<uint32_t> queuedTasks{0};
+        std::atomic<bool> running{false};
+    };
+
+    static JobSystemData s_Data;
+    static thread_local int32_t t_WorkerIndex = -1;
+
+    static bool TryGetTask(Task& out) {
+        const int32_t self = t_WorkerIndex;
+        const size_t count = s_Data.queues.size();
+
+        if (self >= 0 && s_Data.queues[self]->PopBack(out)) return true;
+        if (s_Data.injection.PopFront(out)) return true;
+
+        // Steal, starting after our own queue so thieves spread out.
+        size_t start = self >= 0 ? (size_t)self + 1 : 0;
+        for (size_t i = 0; i < count; ++i) {
+            size_t victim = (start + i) % count;
+            if ((int32_t)victim == self) continue;
+            if (s_Data.queues[victim]->PopFront(out)) return true;
+        }
+        return false;
+    }
+
+    void JobSystem::Execute(Task& task) {
+        s_Data.queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+        task.fn();
+        if (task.group) task.group->m_Pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void JobSystem::WorkerLoop(int32_t index) {
+        t_WorkerIndex = index;
+
+        while (s_Data.running.load(std::memory_order_acquire)) {
+            Task task;
+            if (TryGetTask(task)) {
+                Execute(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(s_Data.sleepMutex);
+            s_Data.sleepCondition.wait(lock, [] {
+                return s_Data.queuedTasks.load(std::memory_order_acquire) > 0 || !s_Data.running.load(std::memory_order_acquire);
+            });
+        }
+    }
+
+    void JobSystem::Initialize(uint32_t workerCount) {
+        if (s_Data.running) return;
+
+        if (workerCount == 0) {
+            uint32_t hw = std::thread::hardware_concurrency();
+            workerCount = hw > 1 ? hw - 1 : 1;
+        }
+
+        s_Data.queues.clear();
+        for (uint32_t i = 0; i < workerCount; ++i) s_Data.queues.push_back(std::make_unique<WorkQueue>());
+
+        s_Data.running = true;
+        for (uint32_t i = 0; i < workerCount; ++i) {
+            s_Data.workers.emplace_back(WorkerLoop, (int32_t)i);
+        }
+
+        Log::Info("Job System Initialized (" + std::to_string(workerCount) + " workers).");
+    }
+
+    void JobSystem::Shutdown() {
+        if (!s_Data.running) return;
+
+        // Finish everything that is still queued so no TaskGroup is left waiting.
+        Task task;
+        while (TryGetTask(task)) Execute(task);
+
+        {
+            std::lock_guard<std::mutex> lock(s_Data.sleepMutex);
+            s_Data.running = false;
+        }
+        s_Data.sleepCondition.notify_all();
+
+        for (auto& worker : s_Data.workers) {
+            if (worker.joinable()) worker.join();
+        }
+        // Tasks submitted by tasks that were still running during the drain above.
+        while (TryGetTask(task)) Execute(task);
+        s_Data.workers.clear();
+        s_Data.queues.clear();
+    }
+
+    bool JobSystem::IsInitialized() {
+        return s_Data.running.load(std::memory_order_acquire);
+    }
+
+    uint32_t JobSystem::GetWorkerCount() {
+        return (uint32_t)s_Data.workers.size();
+    }
+
+    int32_t JobSystem::GetCurrentWorkerIndex() {
+        return t_WorkerIndex;
+    }
+
+    void JobSystem::Submit(std::function<void()> task, TaskGroup* group) {
+        if (!IsInitialized()) {
+            task();
+            return;
+        }
+
+        if (group) group->m_Pending.fetch_add(1, std::memory_order_acq_rel);
+
+        // Counted before it is visible: a thief may pop and Execute it right after the push, and the count
+        // must never dip below zero (it is unsigned, and a wrapped value keeps sleeping workers spinning).
+        s_Data.queuedTasks.fetch_add(1, std::memory_order_release);
+
+        Task t{ std::move(task), group };
+        if (t_WorkerIndex >= 0) s_Data.queues[t_WorkerIndex]->Push(std::move(t));
+        else s_Data.injection.Push(std::move(t));
+
+        {
+            // Taking the lock orders the increment against a worker about to sleep (no lost wake-up).
+            std::lock_guard<std::mutex> lock(s_Data.sleepMutex);
+        }
+        s_Data.sleepCondition.notify_one();
+    }
+
+    bool JobSystem::RunPendingTask() {
+        if (!IsInitialized()) return false;
+
+        Task task;
+        if (!TryGetTask(task)) return false;
+        Execute(task);
+        return true;
+    }
+
+    void JobSystem::Backoff() {
+        std::this_thread::yield();
+    }
+}
@@ -3,6 +3,7 @@ module;
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
 #include <memory>
+#include <vector>
 
 export module vortex.memory;
 
@@ -17,6 +18,22 @@ namespace vortex::memory {
         VmaAllocationInfo info{};
     };
 
+    /**
+     * @brief Persistently mapped host-visible buffer holding one region per frame in flight.
+     * @details Bound with the dynamic offset Offset(frame). The CPU only writes the region of the frame it is
+     * recording, whose previous contents stopped being read when that frame's fence was waited on, so the other
+     * frames in flight keep reading theirs undisturbed.
+     */
+    export struct PerFrameBuffer {
+        AllocatedBuffer buffer;
+        char* mapped{nullptr};
+        VkDeviceSize regionSize{0}; ///< Distance between regions; a multiple of the dynamic offset alignment.
+        uint32_t frames{0};
+
+        VkDeviceSize Offset(uint32_t frame) const { return regionSize * frame; }
+        void* Region(uint32_t frame) const { return mapped + Offset(frame); }
+    };
+
     /**
      * @brief Represents an image allocated on GPU.
      */
@@ -40,14 +57,28 @@ namespace vortex::memory {
          * @param size Size in bytes.
          * @param usage Vulkan buffer usage flags.
          * @param memoryUsage VMA memory usage hint (e.g., GPU_ONLY).
+         * @param queueFamilies Queue families that use the buffer. With two or more the buffer is shared
+         * concurrently (no ownership transfers); otherwise it is exclusive.
          * @return The allocated buffer struct.
          */
-        AllocatedBuffer CreateBuffer(size_t size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage);
+        AllocatedBuffer CreateBuffer(size_t size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage,
+                                     const std::vector<uint32_t>& queueFamilies = {});
         
         /**
          * @brief Destroys a buffer and frees its memory.
          */
         void DestroyBuffer(const AllocatedBuffer& buffer);
+
+        /**
+         * @brief Allocates and maps a buffer of `frames` regions of at least `regionSize` bytes each.
+         * @param offsetAlignment Device alignment for dynamic offsets of the buffer's descriptor type.
+         */
+        PerFrameBuffer CreatePerFrameBuffer(size_t regionSize, uint32_t frames, VkDeviceSize offsetAlignment, VkBufferUsageFlags usage);
+
+        /**
+         * @brief Unmaps and destroys a per-frame buffer.
+         */
+        void DestroyPerFrameBuffer(const PerFrameBuffer& buffer);
         
         /**
          * @brief Allocates a Vulkan Image.
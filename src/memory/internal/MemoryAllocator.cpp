@@ -4,6 +4,7 @@ module;
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 #include <stdexcept>
+#include <vector>
 module vortex.memory;
 
 namespace vortex::memory {
@@ -11,10 +12,16 @@ namespace vortex::memory {
     MemoryAllocator::MemoryAllocator(VmaAllocator allocator, VkDevice device) 
         : m_Allocator(allocator), m_Device(device) {}
 
-    AllocatedBuffer MemoryAllocator::CreateBuffer(size_t size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage) {
+    AllocatedBuffer MemoryAllocator::CreateBuffer(size_t size, VkBufferUsageFlags usage, VmaMemoryUsage memoryUsage,
+                                                  const std::vector<uint32_t>& queueFamilies) {
         VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
         bufferInfo.size = size;
         bufferInfo.usage = usage;
+        if (queueFamilies.size() > 1) {
+            bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = (uint32_t)queueFamilies.size();
+            bufferInfo.pQueueFamilyIndices = queueFamilies.data();
+        }
         
         VmaAllocationCreateInfo vmaallocInfo = {};
         vmaallocInfo.usage = memoryUsage;
@@ -26,6 +33,21 @@ namespace vortex::memory {
         return newBuffer;
     }
 
+    PerFrameBuffer MemoryAllocator::CreatePerFrameBuffer(size_t regionSize, uint32_t frames, VkDeviceSize offsetAlignment, VkBufferUsageFlags usage) {
+        PerFrameBuffer newBuffer;
+        newBuffer.regionSize = (regionSize + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+        newBuffer.frames = frames;
+        newBuffer.buffer = CreateBuffer(newBuffer.regionSize * frames, usage, VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+        void* mapped = nullptr;
+        if (vmaMapMemory(m_Allocator, newBuffer.buffer.allocation, &mapped) != VK_SUCCESS) {
+            DestroyBuffer(newBuffer.buffer);
+            throw std::runtime_error("Failed to map per-frame buffer");
+        }
+        newBuffer.mapped = (char*)mapped;
+        return newBuffer;
+    }
+
     AllocatedImage MemoryAllocator::CreateImage(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage, VmaMemoryUsage memoryUsage) {
         VkImageCreateInfo imageInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
         imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -84,6 +106,11 @@ namespace vortex::memory {
         vmaDestroyBuffer(m_Allocator, buffer.buffer, buffer.allocation);
     }
 
+    void MemoryAllocator::DestroyPerFrameBuffer(const PerFrameBuffer& buffer) {
+        if (buffer.mapped) vmaUnmapMemory(m_Allocator, buffer.buffer.allocation);
+        DestroyBuffer(buffer.buffer);
+    }
+
     void MemoryAllocator::DestroyImage(const AllocatedImage& image) {
         if (image.imageView) vkDestroyImageView(m_Device, image.imageView, nullptr);
         if (image.image) vmaDestroyImage(m_Allocator, image.image, image.allocation);
@@ -13,13 +13,16 @@ module;
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <memory>
 
 module vortex.voxel;
 
 import :mesh_converter;
+import :config;
 import :chunk;
 import :material;
 import vortex.log;
+import vortex.jobs;
 // DO NOT import vortex.graphics;
 
 namespace vortex::voxel {
@@ -170,54 +173,72 @@ namespace vortex::voxel {
         result.minBound = minBound;
         result.maxBound = maxBound;
 
-        int chunksX = std::max(1, (int)ceil((maxBound.x - minBound.x) / 32.0f));
-        int chunksY = std::max(1, (int)ceil((maxBound.y - minBound.y) / 32.0f));
-        int chunksZ = std::max(1, (int)ceil((maxBound.z - minBound.z) / 32.0f));
+        const int edge = (int)CHUNK_SIZE;
+        const float halfEdge = CHUNK_SIZE * 0.5f;
+
+        int chunksX = std::max(1, (int)ceil((maxBound.x - minBound.x) / edge));
+        int chunksY = std::max(1, (int)ceil((maxBound.y - minBound.y) / edge));
+        int chunksZ = std::max(1, (int)ceil((maxBound.z - minBound.z) / edge));
 
         Log::Info("Voxelizing mesh: " + std::to_string(chunksX) + "x" + std::to_string(chunksY) + "x" + std::to_string(chunksZ));
 
-        for (int cz = 0; cz < chunksZ; ++cz) {
-            for (int cy = 0; cy < chunksY; ++cy) {
-                for (int cx = 0; cx < chunksX; ++cx) {
-                    glm::vec3 chunkOrigin = minBound + glm::vec3(cx * 32, cy * 32, cz * 32);
-                    
-                    bool chunkNotEmpty = false;
-                    auto chunkObj = std::make_shared<VoxelObject>();
-                    chunkObj->chunk = std::make_shared<Chunk>();
-                    
-                    for (const auto& tri : triangles) {
-                        glm::vec3 tv0 = tri.v0 - chunkOrigin;
-                        glm::vec3 tv1 = tri.v1 - chunkOrigin;
-                        glm::vec3 tv2 = tri.v2 - chunkOrigin;
-
-                        if (TriBoxOverlap(glm::vec3(16.0f), glm::vec3(16.0f), tv0, tv1, tv2)) {
-                             glm::vec3 localMin = glm::min(tv0, glm::min(tv1, tv2));
-                             glm::vec3 localMax = glm::max(tv0, glm::max(tv1, tv2));
-                             int minX = std::max(0, (int)floor(localMin.x)); int maxX = std::min(31, (int)ceil(localMax.x));
-                             int minY = std::max(0, (int)floor(localMin.y)); int maxY = std::min(31, (int)ceil(localMax.y));
-                             int minZ = std::max(0, (int)floor(localMin.z)); int maxZ = std::min(31, (int)ceil(localMax.z));
-
-                             for (int z = minZ; z <= maxZ; ++z) {
-                                for (int y = minY; y <= maxY; ++y) {
-                                    for (int x = minX; x <= maxX; ++x) {
-                                        if(chunkObj->chunk->GetVoxel(x, y, z) != 0) continue;
-                                        if (TriBoxOverlap(glm::vec3(x+0.5f, y+0.5f, z+0.5f), glm::vec3(0.5f), tv0, tv1, tv2)) {
-                                            chunkObj->chunk->SetVoxel(x, y, z, (uint8_t)tri.materialIdx);
-                                            chunkNotEmpty = true;
-                                        }
+        // Chunks are voxelized independently, so each one is a separate task.
+        // Results are collected by chunk index to keep part order deterministic.
+        const size_t chunkCount = (size_t)chunksX * chunksY * chunksZ;
+        std::vector<std::shared_ptr<VoxelObject>> chunkResults(chunkCount);
+
+        jobs::JobSystem::ParallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+            for (size_t chunkIdx = begin; chunkIdx < end; ++chunkIdx) {
+                int cx = (int)(chunkIdx % chunksX);
+                int cy = (int)((chunkIdx / chunksX) % chunksY);
+                int cz = (int)(chunkIdx / ((size_t)chunksX * chunksY));
+
+                glm::vec3 chunkOrigin = minBound + glm::vec3(cx * edge, cy * edge, cz * edge);
+                
+                // Voxelize into a dense local grid, then write the chunk in one bulk pass.
+                bool chunkNotEmpty = false;
+                std::vector<uint8_t> grid(CHUNK_VOXELS, 0);
+                
+                for (const auto& tri : triangles) {
+                    glm::vec3 tv0 = tri.v0 - chunkOrigin;
+                    glm::vec3 tv1 = tri.v1 - chunkOrigin;
+                    glm::vec3 tv2 = tri.v2 - chunkOrigin;
+
+                    if (TriBoxOverlap(glm::vec3(halfEdge), glm::vec3(halfEdge), tv0, tv1, tv2)) {
+                         glm::vec3 localMin = glm::min(tv0, glm::min(tv1, tv2));
+                         glm::vec3 localMax = glm::max(tv0, glm::max(tv1, tv2));
+                         int minX = std::max(0, (int)floor(localMin.x)); int maxX = std::min(edge - 1, (int)ceil(localMax.x));
+                         int minY = std::max(0, (int)floor(localMin.y)); int maxY = std::min(edge - 1, (int)ceil(localMax.y));
+                         int minZ = std::max(0, (int)floor(localMin.z)); int maxZ = std::min(edge - 1, (int)ceil(localMax.z));
+
+                         for (int z = minZ; z <= maxZ; ++z) {
+                            for (int y = minY; y <= maxY; ++y) {
+                                for (int x = minX; x <= maxX; ++x) {
+                                    uint8_t& cell = grid[x + y * CHUNK_SIZE + z * CHUNK_AREA];
+                                    if (cell != 0) continue;
+                                    if (TriBoxOverlap(glm::vec3(x+0.5f, y+0.5f, z+0.5f), glm::vec3(0.5f), tv0, tv1, tv2)) {
+                                        cell = (uint8_t)tri.materialIdx;
+                                        chunkNotEmpty = true;
                                     }
                                 }
-                             }
-                        }
+                            }
+                         }
                     }
+                }
 
-                    if (chunkNotEmpty) {
-                        chunkObj->position = glm::vec3(cx * 32, cy * 32, cz * 32); 
-                        chunkObj->scale = glm::vec3(1.0f); 
-                        result.parts.push_back(chunkObj);
-                    }
+                if (chunkNotEmpty) {
+                    auto chunkObj = std::make_shared<VoxelObject>();
+                    chunkObj->chunk = std::make_shared<Chunk>();
+                    chunkObj->chunk->WriteLinear(grid, glm::ivec3(0), glm::ivec3(edge));
+                    chunkObj->position = glm::vec3(cx * edge, cy * edge, cz * edge); 
+                    chunkObj->scale = glm::vec3(1.0f); 
+                    chunkResults[chunkIdx] = chunkObj;
                 }
             }
+        });
+
+        for (auto& chunkObj : chunkResults) {
+            if (chunkObj) result.parts.push_back(chunkObj);
         }
         return result;
     }
@@ -2,7 +2,10 @@ module;
 
 #include <memory>
 #include <vector>
+#include <span>
+#include <string>
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 export module vortex.physics;
 
@@ -20,6 +23,144 @@ namespace vortex::physics {
         bool IsValid() const { return id != 0xFFFFFFFF; }
     };
 
+    /**
+     * @brief Runtime capacities and collision policy of the physics world.
+     * @details Capacities are fixed for the lifetime of the Jolt system, so they are only read by Initialize().
+     */
+    export struct PhysicsConfig {
+        uint32_t maxBodies = 4096;
+        uint32_t numBodyMutexes = 0;              ///< 0 = Jolt default.
+        uint32_t maxBodyPairs = 4096;
+        uint32_t maxContactConstraints = 4096;
+        uint32_t tempAllocatorSize = 10 * 1024 * 1024;
+
+        /// @brief Dynamic bodies with at most this many voxels are placed in the DEBRIS layer (0 disables).
+        /// @details Off by default, so every body collides as before; destruction-heavy scenes opt in (e.g. 64).
+        uint32_t debrisMaxVoxels = 0;
+
+        /// @brief If false, debris only collides with the world and regular bodies, not with other debris.
+        bool debrisCollidesWithDebris = false;
+    };
+
+    /**
+     * @brief Load counters of the physics world.
+     * @details Per-step values describe the most recent Update(), averaged over its collision steps so they compare
+     * directly with the per-step PhysicsConfig limits; peaks are high-water marks since Initialize().
+     */
+    export struct PhysicsStats {
+        uint32_t bodyCount = 0;
+        uint32_t activeBodyCount = 0;
+
+        uint32_t bodyPairs = 0;
+        uint32_t bodyPairsPeak = 0;
+        uint32_t contactConstraints = 0;
+        uint32_t contactConstraintsPeak = 0;
+
+        size_t tempAllocatorUsagePeak = 0;
+        size_t tempAllocatorCapacity = 0;
+        uint32_t tempAllocatorFallbacks = 0;      ///< Allocations that overflowed into malloc.
+
+        uint32_t capacityErrors = 0;              ///< Updates that hit a Jolt capacity limit.
+    };
+
+    // --- Profiling ---
+
+    /**
+     * @brief Accumulated time of one Jolt profile zone (e.g. "Build Broadphase", "Solve Velocity Constraints").
+     * @details Time is inclusive (nested zones are also counted in their parent) and summed over all threads.
+     */
+    export struct PhysicsProfileZone {
+        std::string name;
+        float timeMs = 0.0f;
+        uint32_t calls = 0;
+    };
+
+    /**
+     * @brief Time a thread spent inside top-level Jolt zones.
+     * @details workerIndex is the vortex::jobs worker index, -1 for threads outside the pool (main thread).
+     */
+    export struct PhysicsThreadTime {
+        int32_t workerIndex = -1;
+        float timeMs = 0.0f;
+    };
+
+    // --- Queries ---
+
+    /**
+     * @brief World-space ray segment for CastRays().
+     */
+    export struct Ray {
+        glm::vec3 origin{0.0f};
+        glm::vec3 direction{0.0f, 0.0f, 1.0f}; ///< Normalized.
+        float maxDistance = 1000.0f;
+    };
+
+    /**
+     * @brief Closest hit of a ray.
+     * @details partIndex/voxel address the solid voxel that was hit inside the entity (voxel-local coordinates).
+     * They are -1 if the body is not backed by a voxel entity.
+     */
+    export struct RayHit {
+        BodyHandle body{0xFFFFFFFF};
+        float distance = 0.0f;
+        glm::vec3 point{0.0f};
+        glm::vec3 normal{0.0f};
+        int32_t partIndex = -1;
+        glm::ivec3 voxel{-1};
+
+        bool IsHit() const { return body.IsValid(); }
+    };
+
+    export struct SphereQuery {
+        glm::vec3 center{0.0f};
+        float radius = 1.0f;
+    };
+
+    export struct BoxQuery {
+        glm::vec3 center{0.0f};
+        glm::vec3 halfExtents{0.5f};
+        glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    };
+
+    /**
+     * @brief Flattened results of a batched overlap query.
+     * @details Bodies overlapping query i are bodies[offsets[i] .. offsets[i + 1]). Each body appears once per query.
+     */
+    export struct OverlapResults {
+        std::vector<uint32_t> offsets;
+        std::vector<BodyHandle> bodies;
+
+        size_t QueryCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+        std::span<const BodyHandle> Get(size_t query) const {
+            return std::span<const BodyHandle>(bodies.data() + offsets[query], offsets[query + 1] - offsets[query]);
+        }
+    };
+
+    /**
+     * @brief SoA snapshot of the transforms of all awake dynamic bodies (and the ones that just fell asleep).
+     * @details Filled by PhysicsSystem::ReadActiveTransforms(). Index i of every array describes the same body.
+     */
+    export struct ActiveTransformBuffer {
+        std::vector<BodyHandle> bodies;
+        std::vector<glm::vec3> positions;
+        std::vector<glm::quat> rotations;
+
+        size_t Size() const { return bodies.size(); }
+
+        void Clear() {
+            bodies.clear();
+            positions.clear();
+            rotations.clear();
+        }
+
+        void Reserve(size_t count) {
+            bodies.reserve(count);
+            positions.reserve(count);
+            rotations.reserve(count);
+        }
+    };
+
     /**
      * @brief Wrapper around the Jolt Physics System.
      */
@@ -30,8 +171,9 @@ namespace vortex::physics {
 
         /**
          * @brief Initializes the physics engine (allocators, job system, etc.).
+         * @param config Capacities and layer policy.
          */
-        void Initialize();
+        void Initialize(const PhysicsConfig& config = {});
 
         /**
          * @brief Shuts down the physics engine.
@@ -63,6 +205,25 @@ namespace vortex::physics {
          */
         void SyncBodyTransform(std::shared_ptr<vortex::voxel::VoxelEntity> entity, BodyHandle handle);
 
+        /**
+         * @brief Reads back the transforms of all currently active (awake) dynamic bodies, plus those that fell
+         * asleep since the previous call, so their resting pose is read exactly once.
+         * @details The active set is maintained by the body activation listener, so sleeping bodies cost nothing.
+         * All bodies are read under a single multi-body lock. Static and kinematic bodies are skipped.
+         * @param out Buffer receiving the snapshot (cleared first, capacity is reused).
+         */
+        void ReadActiveTransforms(ActiveTransformBuffer& out);
+
+        /**
+         * @brief Checks whether the body is currently awake (in the active set).
+         */
+        bool IsBodyActive(BodyHandle handle) const;
+
+        /**
+         * @brief Returns the number of bodies currently awake.
+         */
+        size_t GetActiveBodyCount() const;
+
         /**
          * @brief Changes the body's motion type temporarily (e.g. for Gizmo manipulation).
          * @param isKinematic If true, the body is moved manually and ignores forces.
@@ -107,6 +268,43 @@ namespace vortex::physics {
          */
         void SetAngularVelocity(BodyHandle handle, const glm::vec3& velocity);
 
+        // --- Queries ---
+
+        /**
+         * @brief Casts a batch of rays against all bodies (closest hit per ray).
+         * @details Rays are split into batches and executed on the physics job system.
+         * Must not be called while Update() is running.
+         * @param rays Input rays.
+         * @param outHits Resized to rays.size(); misses have an invalid body handle.
+         */
+        void CastRays(std::span<const Ray> rays, std::vector<RayHit>& outHits) const;
+
+        /**
+         * @brief Finds all bodies overlapping each sphere.
+         */
+        void OverlapSphere(std::span<const SphereQuery> queries, OverlapResults& out) const;
+
+        /**
+         * @brief Finds all bodies overlapping each oriented box.
+         */
+        void OverlapBox(std::span<const BoxQuery> queries, OverlapResults& out) const;
+
+        /**
+         * @brief Returns the Jolt profile zones recorded since the last call and resets the accumulators.
+         * @details Requires Jolt built with JPH_EXTERNAL_PROFILE; otherwise both outputs stay empty.
+         */
+        void ConsumeProfileData(std::vector<PhysicsProfileZone>& zones, std::vector<PhysicsThreadTime>& threads);
+
+        /**
+         * @brief Returns the current load counters and high-water marks.
+         */
+        PhysicsStats GetStats() const;
+
+        /**
+         * @brief Returns the configuration the system was initialized with.
+         */
+        const PhysicsConfig& GetConfig() const;
+
     private:
         struct InternalState;
         std::unique_ptr<InternalState> m_Internal;
@@ -1,9 +1,11 @@
 module;
 
 #include <vector>
-#include <vector>
+#include <algorithm>
 #include <glm/glm.hpp>
 #include <cstring>
+#include <span>
+#include <bit>
 
 module vortex.physics;
 
@@ -12,91 +14,103 @@ import vortex.voxel;
 
 namespace vortex::physics {
 
+    using voxel::CHUNK_SIZE;
+    using voxel::CHUNK_AREA;
+    using voxel::CHUNK_VOXELS;
+
     // Helper to linearize 3D coordinates locally within the builder
     inline int GetIndex(int x, int y, int z) {
-        return x + y * 32 + z * 1024;
+        return x + y * (int)CHUNK_SIZE + z * (int)CHUNK_AREA;
     }
 
     std::vector<ColliderBox> VoxelColliderBuilder::Build(const vortex::voxel::Chunk& chunk) {
         std::vector<ColliderBox> boxes;
-        
+
+        // Transcode the chunk once into a dense linear grid (no per-lookup Morton encoding)
+        // and collect solid voxels from the occupancy rows, so empty space is never visited.
+        // Rows are scanned in z/y/x order, so seeds come out sorted and merging stays deterministic.
+        std::vector<uint8_t> grid(CHUNK_VOXELS);
+        chunk.ReadLinear(std::span<uint8_t, CHUNK_VOXELS>(grid.data(), grid.size()));
+
+        std::vector<uint32_t> solids;
+        for (uint32_t row = 0; row < CHUNK_AREA; ++row) {
+            voxel::OccupancyRow bits = chunk.occupancy.rows[row];
+            while (bits) {
+                solids.push_back(row * CHUNK_SIZE + (uint32_t)std::countr_zero(bits));
+                bits &= bits - 1;
+            }
+        }
+        if (solids.empty()) return boxes;
+
         // Mask to keep track of processed voxels. 
-        // 32^3 = 32768 bools. std::vector<bool> is space efficient.
-        std::vector<bool> visited(32 * 32 * 32, false);
-
-        // Iterate over all voxels
-        for (int z = 0; z < 32; ++z) {
-            for (int y = 0; y < 32; ++y) {
-                for (int x = 0; x < 32; ++x) {
-                    
-                    int idx = GetIndex(x, y, z);
-                    if (visited[idx]) continue;
-
-                    uint8_t matID = chunk.GetVoxel(x, y, z);
-                    if (matID == 0) { // Empty
-                        visited[idx] = true;
-                        continue;
-                    }
+        // CHUNK_SIZE^3 bools. std::vector<bool> is space efficient.
+        std::vector<bool> visited(CHUNK_VOXELS, false);
 
-                    // Start Greedy Merging
-                    // 1. Expand in X axis
-                    int width = 1;
-                    while (x + width < 32) {
-                        int nextIdx = GetIndex(x + width, y, z);
-                        if (visited[nextIdx] || chunk.GetVoxel(x + width, y, z) != matID) break;
-                        width++;
-                    }
+        for (uint32_t seed : solids) {
+            if (visited[seed]) continue;
 
-                    // 2. Expand in Y axis (check the whole row of width)
-                    int height = 1;
-                    bool canExpandY = true;
-                    while (y + height < 32) {
-                        for (int w = 0; w < width; ++w) {
-                            int nextIdx = GetIndex(x + w, y + height, z);
-                            if (visited[nextIdx] || chunk.GetVoxel(x + w, y + height, z) != matID) {
-                                canExpandY = false;
-                                break;
-                            }
-                        }
-                        if (!canExpandY) break;
-                        height++;
-                    }
+            int x = (int)(seed % CHUNK_SIZE);
+            int y = (int)((seed / CHUNK_SIZE) % CHUNK_SIZE);
+            int z = (int)(seed / CHUNK_AREA);
+            uint8_t matID = grid[seed];
 
-                    // 3. Expand in Z axis (check the whole plane of width * height)
-                    int depth = 1;
-                    bool canExpandZ = true;
-                    while (z + depth < 32) {
-                        for (int h = 0; h < height; ++h) {
-                            for (int w = 0; w < width; ++w) {
-                                int nextIdx = GetIndex(x + w, y + h, z + depth);
-                                if (visited[nextIdx] || chunk.GetVoxel(x + w, y + h, z + depth) != matID) {
-                                    canExpandZ = false;
-                                    break;
-                                }
-                            }
-                            if (!canExpandZ) break;
-                        }
-                        if (!canExpandZ) break;
-                        depth++;
+            // Start Greedy Merging
+            // 1. Expand in X axis
+            int width = 1;
+            while (x + width < (int)CHUNK_SIZE) {
+                int nextIdx = GetIndex(x + width, y, z);
+                if (visited[nextIdx] || grid[nextIdx] != matID) break;
+                width++;
+            }
+
+            // 2. Expand in Y axis (check the whole row of width)
+            int height = 1;
+            bool canExpandY = true;
+            while (y + height < (int)CHUNK_SIZE) {
+                for (int w = 0; w < width; ++w) {
+                    int nextIdx = GetIndex(x + w, y + height, z);
+                    if (visited[nextIdx] || grid[nextIdx] != matID) {
+                        canExpandY = false;
+                        break;
                     }
+                }
+                if (!canExpandY) break;
+                height++;
+            }
 
-                    // Mark all covered voxels as visited
-                    for (int d = 0; d < depth; ++d) {
-                        for (int h = 0; h < height; ++h) {
-                            for (int w = 0; w < width; ++w) {
-                                visited[GetIndex(x + w, y + h, z + d)] = true;
-                            }
+            // 3. Expand in Z axis (check the whole plane of width * height)
+            int depth = 1;
+            bool canExpandZ = true;
+            while (z + depth < (int)CHUNK_SIZE) {
+                for (int h = 0; h < height; ++h) {
+                    for (int w = 0; w < width; ++w) {
+                        int nextIdx = GetIndex(x + w, y + h, z + depth);
+                        if (visited[nextIdx] || grid[nextIdx] != matID) {
+                            canExpandZ = false;
+                            break;
                         }
                     }
+                    if (!canExpandZ) break;
+                }
+                if (!canExpandZ) break;
+                depth++;
+            }
 
-                    // Add the optimized box
-                    ColliderBox box;
-                    box.min = glm::vec3(x, y, z);
-                    box.size = glm::vec3(width, height, depth);
-                    box.materialID = matID;
-                    boxes.push_back(box);
+            // Mark all covered voxels as visited
+            for (int d = 0; d < depth; ++d) {
+                for (int h = 0; h < height; ++h) {
+                    for (int w = 0; w < width; ++w) {
+                        visited[GetIndex(x + w, y + h, z + d)] = true;
+                    }
                 }
             }
+
+            // Add the optimized box
+            ColliderBox box;
+            box.min = glm::vec3(x, y, z);
+            box.size = glm::vec3(width, height, depth);
+            box.materialID = matID;
+            boxes.push_back(box);
         }
 
         return boxes;
@@ -4,7 +4,8 @@ module;
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
 #include <Jolt/Core/TempAllocator.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
 #include <Jolt/Physics/PhysicsSettings.h>
 #include <Jolt/Physics/PhysicsSystem.h>
 #include <Jolt/Physics/Collision/Shape/BoxShape.h>
@@ -12,11 +13,28 @@ module;
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Body/BodyActivationListener.h>
 #include <Jolt/Physics/Body/BodyLock.h> 
+#include <Jolt/Physics/Body/BodyLockMulti.h>
+#include <Jolt/Physics/Collision/ContactListener.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/NarrowPhaseQuery.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
 
 #include <iostream>
 #include <cstdarg>
 #include <thread>
 #include <vector>
+#include <span>
+#include <string>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <new>
 #include <cmath> // Added for ceil
 #include <algorithm> // Added for max
 #include <glm/glm.hpp>
@@ -27,28 +45,35 @@ module vortex.physics;
 
 import vortex.log;
 import vortex.voxel;
+import vortex.jobs;
 
 namespace Layers {
     static constexpr JPH::ObjectLayer NON_MOVING = 0;
     static constexpr JPH::ObjectLayer MOVING = 1;
-    static constexpr JPH::ObjectLayer NUM_LAYERS = 2;
+    static constexpr JPH::ObjectLayer DEBRIS = 2;
+    static constexpr JPH::ObjectLayer NUM_LAYERS = 3;
 };
 
+// One broadphase tree per object layer, so debris never bloats the tree regular bodies are tested against.
 namespace BroadPhaseLayers {
     static constexpr JPH::BroadPhaseLayer NON_MOVING(0);
     static constexpr JPH::BroadPhaseLayer MOVING(1);
-    static constexpr uint32_t NUM_LAYERS(2);
+    static constexpr JPH::BroadPhaseLayer DEBRIS(2);
+    static constexpr uint32_t NUM_LAYERS(3);
 };
 
 class ObjectLayerPairFilterImpl : public JPH::ObjectLayerPairFilter {
 public:
     virtual bool ShouldCollide(JPH::ObjectLayer inObject1, JPH::ObjectLayer inObject2) const override {
         switch (inObject1) {
-            case Layers::NON_MOVING: return inObject2 == Layers::MOVING; 
+            case Layers::NON_MOVING: return inObject2 != Layers::NON_MOVING; 
             case Layers::MOVING:     return true; 
+            case Layers::DEBRIS:     return inObject2 != Layers::DEBRIS || mDebrisVsDebris;
             default:                 return false;
         }
     }
+
+    bool mDebrisVsDebris = false;
 };
 
 class BPLayerInterfaceImpl : public JPH::BroadPhaseLayerInterface {
@@ -56,6 +81,7 @@ public:
     BPLayerInterfaceImpl() {
         mObjectToBroadPhase[Layers::NON_MOVING] = BroadPhaseLayers::NON_MOVING;
         mObjectToBroadPhase[Layers::MOVING] = BroadPhaseLayers::MOVING;
+        mObjectToBroadPhase[Layers::DEBRIS] = BroadPhaseLayers::DEBRIS;
     }
 
     virtual uint32_t GetNumBroadPhaseLayers() const override { return BroadPhaseLayers::NUM_LAYERS; }
@@ -70,6 +96,7 @@ public:
         switch ((JPH::BroadPhaseLayer::Type)inLayer) {
             case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::NON_MOVING: return "NON_MOVING";
             case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::MOVING: return "MOVING";
+            case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::DEBRIS: return "DEBRIS";
             default: return "INVALID";
         }
     }
@@ -83,19 +110,327 @@ class ObjectVsBroadPhaseLayerFilterImpl : public JPH::ObjectVsBroadPhaseLayerFil
 public:
     virtual bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const override {
         switch (inLayer1) {
-            case Layers::NON_MOVING: return inLayer2 == BroadPhaseLayers::MOVING;
+            case Layers::NON_MOVING: return inLayer2 != BroadPhaseLayers::NON_MOVING;
             case Layers::MOVING:     return true;
+            case Layers::DEBRIS:     return inLayer2 != BroadPhaseLayers::DEBRIS || mDebrisVsDebris;
             default:                 return false;
         }
     }
+
+    bool mDebrisVsDebris = false;
+};
+
+/**
+ * @brief Temp allocator that records usage high-water marks.
+ * @details Jolt only uses the temp allocator from one thread at a time, so plain counters suffice.
+ * Overflowing allocations fall back to malloc instead of aborting and are counted.
+ */
+class TrackingTempAllocator : public JPH::TempAllocator {
+public:
+    explicit TrackingTempAllocator(uint32_t inSize) : mImpl(inSize), mCapacity(inSize) {}
+
+    virtual void* Allocate(JPH::uint inSize) override {
+        size_t aligned = JPH::AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+        mCurrent += aligned;
+        if (mCurrent > mCapacity) mFallbacks++;
+        mPeak = std::max(mPeak, mCurrent);
+        return mImpl.Allocate(inSize);
+    }
+
+    virtual void Free(void* inAddress, JPH::uint inSize) override {
+        mCurrent -= JPH::AlignUp(inSize, JPH_RVECTOR_ALIGNMENT);
+        mImpl.Free(inAddress, inSize);
+    }
+
+    size_t GetPeak() const { return mPeak; }
+    size_t GetCapacity() const { return mCapacity; }
+    uint32_t GetFallbacks() const { return mFallbacks; }
+
+private:
+    JPH::TempAllocatorImplWithMallocFallback mImpl;
+    size_t mCapacity;
+    size_t mCurrent = 0;
+    size_t mPeak = 0;
+    uint32_t mFallbacks = 0;
 };
 
+/**
+ * @brief Counts body pairs and contact constraints touched during a physics update.
+ * @details Callbacks arrive from job threads, which all belong to the engine pool (or are the thread waiting on
+ * a Jolt barrier, outside the pool). Each thread counts into its own slot, so no callback takes a lock or touches
+ * a shared cache line; the slots are merged once after the update. Within one collision step a body pair is
+ * processed by a single job, so its manifolds all land in the same slot.
+ */
+class StatsContactListener : public JPH::ContactListener {
+public:
+    virtual void OnContactAdded(const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings) override {
+        Record(inBody1, inBody2);
+    }
+
+    virtual void OnContactPersisted(const JPH::Body& inBody1, const JPH::Body& inBody2, const JPH::ContactManifold& inManifold, JPH::ContactSettings& ioSettings) override {
+        Record(inBody1, inBody2);
+    }
+
+    /// @brief One slot per pool worker plus one for threads outside the pool.
+    void Initialize(uint32_t workerCount) {
+        mSlots = std::vector<Slot>(workerCount + 1);
+    }
+
+    void BeginUpdate() {
+        for (Slot& slot : mSlots) {
+            slot.constraints = 0;
+            slot.pairs.clear();
+        }
+    }
+
+    /**
+     * @brief Per-step load of the update that just finished, the unit of Jolt's body pair and contact limits.
+     * @details Contact constraints are averaged over the collision steps. Body pairs are the distinct pairs of the
+     * whole update; resting contacts persist across steps, so this is close to the count of each single step.
+     */
+    void EndUpdate(uint32_t collisionSteps, uint32_t& outPairs, uint32_t& outConstraints) {
+        uint32_t constraints = 0;
+        size_t pairs = 0;
+        for (const Slot& slot : mSlots) {
+            constraints += slot.constraints;
+            pairs += slot.pairs.size();
+        }
+
+        // Over several steps a persistent pair may have been seen by several threads: count it once. This merge
+        // runs on the calling thread after the update, off the contact callback path.
+        if (collisionSteps > 1 && mSlots.size() > 1) {
+            mMerged.clear();
+            for (const Slot& slot : mSlots) mMerged.insert(slot.pairs.begin(), slot.pairs.end());
+            pairs = mMerged.size();
+        }
+
+        outPairs = (uint32_t)pairs;
+        outConstraints = (constraints + collisionSteps - 1) / collisionSteps;
+    }
+
+private:
+    struct alignas(64) Slot {
+        uint32_t constraints = 0;
+        std::unordered_set<uint64_t> pairs;
+    };
+
+    void Record(const JPH::Body& inBody1, const JPH::Body& inBody2) {
+        // Worker index -1 (a thread outside the pool) maps to slot 0.
+        Slot& slot = mSlots[vortex::jobs::JobSystem::GetCurrentWorkerIndex() + 1];
+        slot.constraints++;
+
+        uint64_t a = inBody1.GetID().GetIndexAndSequenceNumber();
+        uint64_t b = inBody2.GetID().GetIndexAndSequenceNumber();
+        if (a > b) std::swap(a, b);
+        slot.pairs.insert((a << 32) | b);
+    }
+
+    std::vector<Slot> mSlots;
+    std::unordered_set<uint64_t> mMerged;
+};
+
+/**
+ * @brief Tracks the set of awake bodies.
+ * @details Jolt invokes the callbacks from job threads while holding body locks, so the set is mutex protected.
+ * Bodies are kept in a dense array (swap-remove) so a snapshot is a single memcpy. Bodies that fell asleep are
+ * also remembered until the next snapshot, which still has to read the pose they came to rest in.
+ */
 class MyBodyActivationListener : public JPH::BodyActivationListener {
 public:
-    virtual void OnBodyActivated(const JPH::BodyID& inBodyID, uint64_t inBodyUserData) override { }
-    virtual void OnBodyDeactivated(const JPH::BodyID& inBodyID, uint64_t inBodyUserData) override { }
+    virtual void OnBodyActivated(const JPH::BodyID& inBodyID, uint64_t inBodyUserData) override {
+        std::lock_guard<std::mutex> lock(mMutex);
+        uint32_t id = inBodyID.GetIndexAndSequenceNumber();
+        if (mSlots.find(id) != mSlots.end()) return;
+        mSlots[id] = (uint32_t)mBodies.size();
+        mBodies.push_back(inBodyID);
+    }
+
+    virtual void OnBodyDeactivated(const JPH::BodyID& inBodyID, uint64_t inBodyUserData) override {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (RemoveLocked(inBodyID.GetIndexAndSequenceNumber())) mDeactivated.push_back(inBodyID);
+    }
+
+    /// @brief Explicit removal (e.g. body destroyed while awake).
+    void Remove(uint32_t id) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        RemoveLocked(id);
+    }
+
+    bool Contains(uint32_t id) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSlots.find(id) != mSlots.end();
+    }
+
+    size_t Size() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mBodies.size();
+    }
+
+    /// @brief Awake bodies plus the ones that fell asleep since the last call (each listed once).
+    void Snapshot(std::vector<JPH::BodyID>& out) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        out.assign(mBodies.begin(), mBodies.end());
+        for (const JPH::BodyID& id : mDeactivated) {
+            // Woken up again within the step: already listed as awake.
+            if (mSlots.find(id.GetIndexAndSequenceNumber()) == mSlots.end()) out.push_back(id);
+        }
+        mDeactivated.clear();
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBodies.clear();
+        mSlots.clear();
+        mDeactivated.clear();
+    }
+
+private:
+    bool RemoveLocked(uint32_t id) {
+        auto it = mSlots.find(id);
+        if (it == mSlots.end()) return false;
+
+        uint32_t slot = it->second;
+        mSlots.erase(it);
+
+        if (slot != mBodies.size() - 1) {
+            mBodies[slot] = mBodies.back();
+            mSlots[mBodies[slot].GetIndexAndSequenceNumber()] = slot;
+        }
+        mBodies.pop_back();
+        return true;
+    }
+
+    mutable std::mutex mMutex;
+    std::vector<JPH::BodyID> mBodies;
+    std::unordered_map<uint32_t, uint32_t> mSlots;
+    std::vector<JPH::BodyID> mDeactivated;
+};
+
+/**
+ * @brief Jolt job system backed by the engine thread pool.
+ * @details Jolt jobs become vortex::jobs tasks, so physics shares its cores with the rest of the engine
+ * instead of running a second pool. Barriers come from JobSystemWithBarrier; a thread waiting on a barrier
+ * executes the barrier's ready jobs itself, so waiting never depends on a free worker.
+ */
+class EngineJobSystem final : public JPH::JobSystemWithBarrier {
+public:
+    EngineJobSystem(uint32_t inMaxJobs, uint32_t inMaxBarriers) : JPH::JobSystemWithBarrier(inMaxBarriers) {
+        mJobs.Init(inMaxJobs, inMaxJobs);
+    }
+
+    virtual int GetMaxConcurrency() const override {
+        return (int)vortex::jobs::JobSystem::GetWorkerCount() + 1;
+    }
+
+    virtual JPH::JobHandle CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies = 0) override {
+        uint32_t index;
+        for (;;) {
+            index = mJobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+            if (index != AvailableJobs::cInvalidObjectIndex) break;
+            // Job list full: let running jobs complete and free their slots.
+            if (!vortex::jobs::JobSystem::RunPendingTask()) std::this_thread::yield();
+        }
+
+        Job* job = &mJobs.Get(index);
+        JPH::JobHandle handle(job);
+        if (inNumDependencies == 0) QueueJob(job);
+        return handle;
+    }
+
+protected:
+    virtual void QueueJob(Job* inJob) override {
+        inJob->AddRef();
+        vortex::jobs::JobSystem::Submit([inJob]() {
+            inJob->Execute();
+            inJob->Release();
+        });
+    }
+
+    virtual void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override {
+        for (JPH::uint i = 0; i < inNumJobs; ++i) QueueJob(inJobs[i]);
+    }
+
+    virtual void FreeJob(Job* inJob) override {
+        mJobs.DestructObject(inJob);
+    }
+
+private:
+    using AvailableJobs = JPH::FixedSizeFreeList<Job>;
+    AvailableJobs mJobs;
+};
+
+// --- External Profiling ---
+
+/**
+ * @brief Per-thread accumulation of Jolt zone timings.
+ * @details Written by the owning thread, drained by the main thread; the mutex is uncontended except while draining.
+ * Zones are keyed by name pointer (Jolt passes string literals) and merged by string when drained.
+ */
+struct ThreadProfileData {
+    struct ZoneSample {
+        double ms = 0.0;
+        uint32_t calls = 0;
+    };
+
+    std::mutex mutex;
+    int32_t workerIndex = -1;
+    std::unordered_map<const char*, ZoneSample> zones;
+    double topLevelMs = 0.0;
+    int depth = 0; // Owning thread only
 };
 
+struct ProfileRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadProfileData>> threads;
+};
+
+static ProfileRegistry s_ProfileRegistry;
+
+static ThreadProfileData& GetThreadProfileData() {
+    thread_local std::shared_ptr<ThreadProfileData> data = [] {
+        auto d = std::make_shared<ThreadProfileData>();
+        d->workerIndex = vortex::jobs::JobSystem::GetCurrentWorkerIndex();
+        std::lock_guard<std::mutex> lock(s_ProfileRegistry.mutex);
+        s_ProfileRegistry.threads.push_back(d);
+        return d;
+    }();
+    return *data;
+}
+
+#ifdef JPH_EXTERNAL_PROFILE
+
+struct ExternalMeasurementData {
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Jolt declares these in the global module; define them there as well.
+extern "C++" {
+    JPH::ExternalProfileMeasurement::ExternalProfileMeasurement(const char* inName, JPH::uint32 inColor) {
+        static_assert(sizeof(ExternalMeasurementData) <= sizeof(mUserData), "Profile payload does not fit into Jolt's user data");
+        new (mUserData) ExternalMeasurementData{ inName, std::chrono::steady_clock::now() };
+        GetThreadProfileData().depth++;
+    }
+
+    JPH::ExternalProfileMeasurement::~ExternalProfileMeasurement() {
+        auto* data = std::launder(reinterpret_cast<ExternalMeasurementData*>(mUserData));
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - data->start).count();
+
+        ThreadProfileData& thread = GetThreadProfileData();
+        thread.depth--;
+        {
+            std::lock_guard<std::mutex> lock(thread.mutex);
+            auto& zone = thread.zones[data->name];
+            zone.ms += ms;
+            zone.calls++;
+            if (thread.depth == 0) thread.topLevelMs += ms;
+        }
+        data->~ExternalMeasurementData();
+    }
+}
+
+#endif
+
 static void TraceImpl(const char* inFMT, ...) {
     va_list list;
     va_start(list, inFMT);
@@ -112,20 +447,109 @@ static glm::vec3 ToGlm(const JPH::Vec3& v) { return glm::vec3(v.GetX(), v.GetY()
 namespace vortex::physics {
 
     struct PhysicsSystem::InternalState {
-        JPH::TempAllocatorImpl* tempAllocator = nullptr;
-        JPH::JobSystemThreadPool* jobSystem = nullptr;
+        TrackingTempAllocator* tempAllocator = nullptr;
+        EngineJobSystem* jobSystem = nullptr;
         JPH::PhysicsSystem physicsSystem;
         
         BPLayerInterfaceImpl bpLayerInterface;
         ObjectVsBroadPhaseLayerFilterImpl objectVsBpLayerFilter;
         ObjectLayerPairFilterImpl objectLayerPairFilter;
         MyBodyActivationListener bodyActivationListener;
+        StatsContactListener contactListener;
+
+        PhysicsConfig config;
+        PhysicsStats stats;
+
+        /// @brief Picks the object layer for a body from its motion type and voxel count (stored as user data).
+        JPH::ObjectLayer SelectLayer(bool isStatic, uint64_t voxelCount) const {
+            if (isStatic) return Layers::NON_MOVING;
+            if (config.debrisMaxVoxels > 0 && voxelCount <= config.debrisMaxVoxels) return Layers::DEBRIS;
+            return Layers::MOVING;
+        }
+
+        /// @brief Scratch copy of the active set, reused every frame.
+        std::vector<JPH::BodyID> activeScratch;
+
+        /// @brief Voxel entity behind each body, used to resolve query hits to voxel coordinates.
+        std::unordered_map<uint32_t, std::weak_ptr<vortex::voxel::VoxelEntity>> bodyEntities;
+
+        static constexpr size_t cRaysPerJob = 64;
+        static constexpr size_t cOverlapsPerJob = 16;
+
+        /**
+         * @brief Resolves a world-space hit on a body to the voxel that was hit.
+         * @details The point is nudged against the surface normal so it lands inside the solid voxel.
+         * Uses the same part placement as the collider (part->position, no part rotation).
+         */
+        void ResolveVoxel(const JPH::Body& body, const glm::vec3& point, const glm::vec3& normal, RayHit& hit) const {
+            auto it = bodyEntities.find(body.GetID().GetIndexAndSequenceNumber());
+            if (it == bodyEntities.end()) return;
+            auto entity = it->second.lock();
+            if (!entity) return;
+
+            JPH::RMat44 invWorld = body.GetWorldTransform().InversedRotationTranslation();
+            glm::vec3 local = ToGlm(JPH::Vec3(invWorld * ToJolt(point)));
+            glm::vec3 localNormal = ToGlm(invWorld.Multiply3x3(ToJolt(normal)));
+            local -= localNormal * 0.01f;
+
+            for (size_t p = 0; p < entity->parts.size(); ++p) {
+                const auto& part = entity->parts[p];
+                if (!part || !part->chunk) continue;
+
+                glm::ivec3 v = glm::ivec3(glm::floor(local - part->position));
+                if (glm::any(glm::lessThan(v, glm::ivec3(0))) || glm::any(glm::greaterThanEqual(v, glm::ivec3(voxel::CHUNK_SIZE)))) continue;
+                if (!part->chunk->IsSolid(v.x, v.y, v.z)) continue;
+
+                hit.partIndex = (int32_t)p;
+                hit.voxel = v;
+                return;
+            }
+        }
+
+        /**
+         * @brief Collides a query shape against the world and writes one handle per touched body.
+         */
+        void CollectOverlaps(const JPH::Shape* shape, JPH::RMat44Arg transform, std::vector<BodyHandle>& out) const {
+            JPH::CollideShapeSettings settings;
+            JPH::AllHitCollisionCollector<JPH::CollideShapeCollector> collector;
+            physicsSystem.GetNarrowPhaseQuery().CollideShape(shape, JPH::Vec3::sReplicate(1.0f), transform, settings, JPH::RVec3::sZero(), collector);
+
+            out.clear();
+            for (const auto& h : collector.mHits) {
+                uint32_t id = h.mBodyID2.GetIndexAndSequenceNumber();
+                // Compound shapes report one hit per sub shape.
+                if (std::find_if(out.begin(), out.end(), [id](const BodyHandle& b) { return b.id == id; }) == out.end()) {
+                    out.push_back({ id });
+                }
+            }
+        }
+
+        /**
+         * @brief Runs per-query overlap collection in parallel and flattens into OverlapResults.
+         * @param collect Called as collect(query, hits) on a job thread; builds the query shape and calls CollectOverlaps.
+         */
+        template<typename Query, typename Collect>
+        void RunOverlaps(std::span<const Query> queries, OverlapResults& out, const Collect& collect) const {
+            std::vector<std::vector<BodyHandle>> perQuery(queries.size());
+
+            vortex::jobs::JobSystem::ParallelFor(queries.size(), cOverlapsPerJob, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) collect(queries[i], perQuery[i]);
+            });
+
+            out.offsets.resize(queries.size() + 1);
+            out.bodies.clear();
+            out.offsets[0] = 0;
+            for (size_t i = 0; i < perQuery.size(); ++i) {
+                out.bodies.insert(out.bodies.end(), perQuery[i].begin(), perQuery[i].end());
+                out.offsets[i + 1] = (uint32_t)out.bodies.size();
+            }
+        }
     };
 
     PhysicsSystem::PhysicsSystem() : m_Internal(std::make_unique<InternalState>()) {}
     PhysicsSystem::~PhysicsSystem() { Shutdown(); }
 
-    void PhysicsSystem::Initialize() {
+    void PhysicsSystem::Initialize(const PhysicsConfig& config) {
         if (m_Internal->jobSystem) {
             Shutdown();
         }
@@ -136,22 +560,27 @@ namespace vortex::physics {
         JPH::Factory::sInstance = new JPH::Factory();
         JPH::RegisterTypes();
 
-        m_Internal->tempAllocator = new JPH::TempAllocatorImpl(10 * 1024 * 1024);
-        m_Internal->jobSystem = new JPH::JobSystemThreadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1);
+        m_Internal->config = config;
+        m_Internal->stats = {};
 
-        const uint32_t cMaxBodies = 4096; // Increased body limit for voxel debris
-        const uint32_t cNumBodyMutexes = 0;
-        const uint32_t cMaxBodyPairs = 4096;
-        const uint32_t cMaxContactConstraints = 4096;
+        m_Internal->tempAllocator = new TrackingTempAllocator(config.tempAllocatorSize);
+        // Physics runs on the engine pool; start it here if the engine has not done so already.
+        if (!vortex::jobs::JobSystem::IsInitialized()) vortex::jobs::JobSystem::Initialize();
+        m_Internal->jobSystem = new EngineJobSystem(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers);
+
+        m_Internal->objectLayerPairFilter.mDebrisVsDebris = config.debrisCollidesWithDebris;
+        m_Internal->objectVsBpLayerFilter.mDebrisVsDebris = config.debrisCollidesWithDebris;
 
         m_Internal->physicsSystem.Init(
-            cMaxBodies, cNumBodyMutexes, cMaxBodyPairs, cMaxContactConstraints,
+            config.maxBodies, config.numBodyMutexes, config.maxBodyPairs, config.maxContactConstraints,
             m_Internal->bpLayerInterface, 
             m_Internal->objectVsBpLayerFilter, 
             m_Internal->objectLayerPairFilter
         );
 
         m_Internal->physicsSystem.SetBodyActivationListener(&m_Internal->bodyActivationListener);
+        m_Internal->contactListener.Initialize(vortex::jobs::JobSystem::GetWorkerCount());
+        m_Internal->physicsSystem.SetContactListener(&m_Internal->contactListener);
         
         // --- Critical for Voxel Stability ---
         // Increase tolerance for penetration slightly to prevent jitter
@@ -160,7 +589,9 @@ namespace vortex::physics {
         settings.mBaumgarte = 0.2f;        // Stabilization factor
         m_Internal->physicsSystem.SetPhysicsSettings(settings);
 
-        vortex::Log::Info("Jolt Physics Initialized.");
+        vortex::Log::Info("Jolt Physics Initialized (bodies: " + std::to_string(config.maxBodies) +
+            ", pairs: " + std::to_string(config.maxBodyPairs) +
+            ", contacts: " + std::to_string(config.maxContactConstraints) + ").");
     }
 
     void PhysicsSystem::Shutdown() {
@@ -175,6 +606,8 @@ namespace vortex::physics {
             
             m_Internal->jobSystem = nullptr;
             m_Internal->tempAllocator = nullptr;
+            m_Internal->bodyActivationListener.Clear();
+            m_Internal->bodyEntities.clear();
         }
     }
 
@@ -189,34 +622,151 @@ namespace vortex::physics {
             // Hard cap to prevent death spiral on extreme lag
             if (cCollisionSteps > 10) cCollisionSteps = 10;
 
-            m_Internal->physicsSystem.Update(deltaTime, cCollisionSteps, m_Internal->tempAllocator, m_Internal->jobSystem);
+            m_Internal->contactListener.BeginUpdate();
+            JPH::EPhysicsUpdateError error = m_Internal->physicsSystem.Update(deltaTime, cCollisionSteps, m_Internal->tempAllocator, m_Internal->jobSystem);
+
+            PhysicsStats& stats = m_Internal->stats;
+            m_Internal->contactListener.EndUpdate((uint32_t)cCollisionSteps, stats.bodyPairs, stats.contactConstraints);
+            stats.bodyPairsPeak = std::max(stats.bodyPairsPeak, stats.bodyPairs);
+            stats.contactConstraintsPeak = std::max(stats.contactConstraintsPeak, stats.contactConstraints);
+
+            // Capacity overflows degrade the simulation (dropped pairs/contacts) rather than fail, so only report them.
+            if (error != JPH::EPhysicsUpdateError::None) {
+                if (stats.capacityErrors++ == 0) {
+                    uint32_t flags = (uint32_t)error;
+                    std::string reason;
+                    if (flags & (uint32_t)JPH::EPhysicsUpdateError::ManifoldCacheFull) reason += " ManifoldCacheFull";
+                    if (flags & (uint32_t)JPH::EPhysicsUpdateError::BodyPairCacheFull) reason += " BodyPairCacheFull";
+                    if (flags & (uint32_t)JPH::EPhysicsUpdateError::ContactConstraintsFull) reason += " ContactConstraintsFull";
+                    vortex::Log::Warn("Jolt capacity exceeded:" + reason + ". Consider raising PhysicsConfig limits.");
+                }
+            }
         }
     }
 
-    BodyHandle PhysicsSystem::AddBody(std::shared_ptr<vortex::voxel::VoxelEntity> entity, bool isStatic) {
-        if (!entity || entity->parts.empty() || !m_Internal->jobSystem) return {JPH::BodyID::cInvalidBodyID};
-        
-        // Check if we have any valid colliders
-        auto boxes = VoxelColliderBuilder::Build(*entity->parts[0]->chunk); 
-        bool hasAny = !boxes.empty();
-        
-        if (!hasAny) {
-             for(auto& p : entity->parts) {
-                if(p->chunk && !VoxelColliderBuilder::Build(*p->chunk).empty()) {
-                    hasAny = true; break;
+    // --- Queries ---
+
+    void PhysicsSystem::CastRays(std::span<const Ray> rays, std::vector<RayHit>& outHits) const {
+        outHits.assign(rays.size(), RayHit{});
+        if (!m_Internal->jobSystem) return;
+
+        const InternalState& state = *m_Internal;
+        const JPH::NarrowPhaseQuery& query = state.physicsSystem.GetNarrowPhaseQuery();
+        const JPH::BodyLockInterface& lockInterface = state.physicsSystem.GetBodyLockInterface();
+
+        vortex::jobs::JobSystem::ParallelFor(rays.size(), InternalState::cRaysPerJob, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Ray& ray = rays[i];
+                JPH::RRayCast joltRay(ToJolt(ray.origin), ToJolt(ray.direction * ray.maxDistance));
+                JPH::RayCastResult result;
+                if (!query.CastRay(joltRay, result)) continue;
+
+                RayHit& hit = outHits[i];
+                hit.body = { result.mBodyID.GetIndexAndSequenceNumber() };
+                hit.distance = result.mFraction * ray.maxDistance;
+                hit.point = ray.origin + ray.direction * hit.distance;
+
+                JPH::BodyLockRead lock(lockInterface, result.mBodyID);
+                if (lock.Succeeded()) {
+                    const JPH::Body& body = lock.GetBody();
+                    hit.normal = ToGlm(body.GetWorldSpaceSurfaceNormal(result.mSubShapeID2, ToJolt(hit.point)));
+                    state.ResolveVoxel(body, hit.point, hit.normal, hit);
                 }
             }
+        });
+    }
+
+    void PhysicsSystem::OverlapSphere(std::span<const SphereQuery> queries, OverlapResults& out) const {
+        if (!m_Internal->jobSystem) { out.offsets.assign(queries.size() + 1, 0); out.bodies.clear(); return; }
+
+        const InternalState& state = *m_Internal;
+        state.RunOverlaps(queries, out, [&state](const SphereQuery& q, std::vector<BodyHandle>& hits) {
+            // Query shapes live on the job's stack: embedded, so no reference ever frees them, and no heap allocation.
+            JPH::SphereShape sphere(q.radius);
+            sphere.SetEmbedded();
+            state.CollectOverlaps(&sphere, JPH::RMat44::sTranslation(ToJolt(q.center)), hits);
+        });
+    }
+
+    void PhysicsSystem::OverlapBox(std::span<const BoxQuery> queries, OverlapResults& out) const {
+        if (!m_Internal->jobSystem) { out.offsets.assign(queries.size() + 1, 0); out.bodies.clear(); return; }
+
+        const InternalState& state = *m_Internal;
+        state.RunOverlaps(queries, out, [&state](const BoxQuery& q, std::vector<BodyHandle>& hits) {
+            // Convex radius must not exceed the smallest half extent.
+            float convexRadius = std::min(JPH::cDefaultConvexRadius, glm::min(q.halfExtents.x, glm::min(q.halfExtents.y, q.halfExtents.z)));
+            JPH::BoxShape box(ToJolt(q.halfExtents), convexRadius);
+            box.SetEmbedded();
+            state.CollectOverlaps(&box, JPH::RMat44::sRotationTranslation(ToJolt(q.rotation), ToJolt(q.center)), hits);
+        });
+    }
+
+    void PhysicsSystem::ConsumeProfileData(std::vector<PhysicsProfileZone>& zones, std::vector<PhysicsThreadTime>& threads) {
+        zones.clear();
+        threads.clear();
+
+        std::map<std::string, PhysicsProfileZone> merged;
+        std::lock_guard<std::mutex> registryLock(s_ProfileRegistry.mutex);
+
+        for (auto& thread : s_ProfileRegistry.threads) {
+            std::lock_guard<std::mutex> lock(thread->mutex);
+            if (thread->zones.empty()) continue;
+
+            for (const auto& [name, sample] : thread->zones) {
+                auto& zone = merged[name];
+                zone.timeMs += (float)sample.ms;
+                zone.calls += sample.calls;
+            }
+            threads.push_back({ thread->workerIndex, (float)thread->topLevelMs });
+
+            thread->zones.clear();
+            thread->topLevelMs = 0.0;
+        }
+
+        zones.reserve(merged.size());
+        for (auto& [name, zone] : merged) {
+            zone.name = name;
+            zones.push_back(std::move(zone));
         }
+        std::sort(threads.begin(), threads.end(), [](const PhysicsThreadTime& a, const PhysicsThreadTime& b) { return a.workerIndex < b.workerIndex; });
+    }
+
+    PhysicsStats PhysicsSystem::GetStats() const {
+        PhysicsStats stats = m_Internal->stats;
+        if (m_Internal->jobSystem) {
+            stats.bodyCount = m_Internal->physicsSystem.GetNumBodies();
+            stats.activeBodyCount = (uint32_t)m_Internal->bodyActivationListener.Size();
+            stats.tempAllocatorUsagePeak = m_Internal->tempAllocator->GetPeak();
+            stats.tempAllocatorCapacity = m_Internal->tempAllocator->GetCapacity();
+            stats.tempAllocatorFallbacks = m_Internal->tempAllocator->GetFallbacks();
+        }
+        return stats;
+    }
+
+    const PhysicsConfig& PhysicsSystem::GetConfig() const {
+        return m_Internal->config;
+    }
+
+    BodyHandle PhysicsSystem::AddBody(std::shared_ptr<vortex::voxel::VoxelEntity> entity, bool isStatic) {
+        if (!entity || entity->parts.empty() || !m_Internal->jobSystem) return {JPH::BodyID::cInvalidBodyID};
         
+        // Cook all parts in parallel (each part is independent), then assemble the compound serially.
+        std::vector<std::vector<ColliderBox>> partBoxes(entity->parts.size());
+        vortex::jobs::JobSystem::ParallelFor(entity->parts.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const auto& part = entity->parts[i];
+                if (part && part->chunk) partBoxes[i] = VoxelColliderBuilder::Build(*part->chunk);
+            }
+        });
+
+        bool hasAny = std::any_of(partBoxes.begin(), partBoxes.end(), [](const auto& boxes) { return !boxes.empty(); });
         if(!hasAny) return {JPH::BodyID::cInvalidBodyID};
 
         JPH::StaticCompoundShapeSettings compoundSettings;
         
-        for (const auto& part : entity->parts) {
-            if (!part || !part->chunk) continue;
-            
-            auto partBoxes = VoxelColliderBuilder::Build(*part->chunk);
-            for (const auto& box : partBoxes) {
+        for (size_t i = 0; i < entity->parts.size(); ++i) {
+            const auto& part = entity->parts[i];
+            for (const auto& box : partBoxes[i]) {
                 JPH::Vec3 halfExtent = ToJolt(box.size) * 0.5f;
                 // Jolt boxes are centered.
                 glm::vec3 boxCenterLocal = part->position + box.min + (box.size * 0.5f);
@@ -238,9 +788,12 @@ namespace vortex::physics {
             ToJolt(glm::vec3(entity->transform[3])), 
             ToJolt(glm::quat(entity->transform)),    
             isStatic ? JPH::EMotionType::Static : JPH::EMotionType::Dynamic,
-            isStatic ? Layers::NON_MOVING : Layers::MOVING
+            m_Internal->SelectLayer(isStatic, entity->totalVoxelCount)
         );
 
+        // Voxel count is kept on the body so layer changes (SetBodyType) can re-classify it as debris.
+        bodySettings.mUserData = entity->totalVoxelCount;
+
         bodySettings.mAllowSleeping = true;
         bodySettings.mIsSensor = entity->isTrigger;
         
@@ -259,6 +812,7 @@ namespace vortex::physics {
         if (!body) return {JPH::BodyID::cInvalidBodyID};
 
         bodyInterface.AddBody(body->GetID(), isStatic ? JPH::EActivation::DontActivate : JPH::EActivation::Activate);
+        m_Internal->bodyEntities[body->GetID().GetIndexAndSequenceNumber()] = entity;
 
         return { body->GetID().GetIndexAndSequenceNumber() };
     }
@@ -271,6 +825,8 @@ namespace vortex::physics {
         
         bodyInterface.RemoveBody(bodyID);
         bodyInterface.DestroyBody(bodyID);
+        m_Internal->bodyActivationListener.Remove(handle.id);
+        m_Internal->bodyEntities.erase(handle.id);
     }
 
     void PhysicsSystem::SyncBodyTransform(std::shared_ptr<vortex::voxel::VoxelEntity> entity, BodyHandle handle) {
@@ -294,6 +850,42 @@ namespace vortex::physics {
         entity->transform = transform;
     }
 
+    void PhysicsSystem::ReadActiveTransforms(ActiveTransformBuffer& out) {
+        out.Clear();
+        if (!m_Internal->jobSystem) return;
+
+        auto& ids = m_Internal->activeScratch;
+        m_Internal->bodyActivationListener.Snapshot(ids);
+        if (ids.empty()) return;
+
+        out.Reserve(ids.size());
+
+        // One multi-body lock for the whole batch instead of a lock per body and per query.
+        const JPH::BodyLockInterface& lockInterface = m_Internal->physicsSystem.GetBodyLockInterface();
+        JPH::BodyLockMultiRead lock(lockInterface, ids.data(), (int)ids.size());
+
+        for (int i = 0; i < (int)ids.size(); ++i) {
+            const JPH::Body* body = lock.GetBody(i);
+            if (!body || !body->IsDynamic()) continue;
+
+            JPH::Vec3 pos = body->GetPosition();
+            JPH::Quat rot = body->GetRotation();
+
+            out.bodies.push_back({ ids[i].GetIndexAndSequenceNumber() });
+            out.positions.push_back(ToGlm(pos));
+            out.rotations.push_back(glm::quat(rot.GetW(), rot.GetX(), rot.GetY(), rot.GetZ()));
+        }
+    }
+
+    bool PhysicsSystem::IsBodyActive(BodyHandle handle) const {
+        if (!handle.IsValid()) return false;
+        return m_Internal->bodyActivationListener.Contains(handle.id);
+    }
+
+    size_t PhysicsSystem::GetActiveBodyCount() const {
+        return m_Internal->bodyActivationListener.Size();
+    }
+
     void PhysicsSystem::SetBodyKinematic(BodyHandle handle, bool isKinematic) {
         if(!m_Internal->jobSystem) return;
         JPH::BodyID bodyID(handle.id);
@@ -316,7 +908,7 @@ namespace vortex::physics {
         JPH::BodyInterface& bodyInterface = m_Internal->physicsSystem.GetBodyInterface();
         
         JPH::EMotionType newType = isStatic ? JPH::EMotionType::Static : JPH::EMotionType::Dynamic;
-        JPH::ObjectLayer newLayer = isStatic ? Layers::NON_MOVING : Layers::MOVING;
+        JPH::ObjectLayer newLayer = m_Internal->SelectLayer(isStatic, bodyInterface.GetUserData(bodyID));
 
         if (bodyInterface.GetMotionType(bodyID) != newType) {
             bodyInterface.SetMotionType(bodyID, newType, isStatic ? JPH::EActivation::DontActivate : JPH::EActivation::Activate);
@@ -3,16 +3,22 @@ module;
 #include <vector>
 #include <cstdint>
 #include <cstring>
+#include <span>
+#include <bit>
 #include <glm/glm.hpp>
 
+// Chunk storage order, set by CMake (VORTEX_CHUNK_LAYOUT): 0 = Linear, 1 = Morton, 2 = Brick.
+#ifndef VORTEX_CHUNK_LAYOUT
+    #define VORTEX_CHUNK_LAYOUT 1
+#endif
+
 export module vortex.voxel:chunk;
 
-namespace vortex::voxel {
+import :config;
+import :occupancy;
+import :stats;
 
-    // --- Configuration ---
-    // Set to true to enable Z-Order Curve (Morton) memory layout.
-    // Must match the shader definition!
-    constexpr bool USE_MORTON_LAYOUT = true;
+namespace vortex::voxel {
 
     // --- Helpers ---
 
@@ -27,26 +33,150 @@ namespace vortex::voxel {
     }
 
     // Calculates 3D Morton Code (Z-Order Curve index)
-    constexpr uint32_t Morton3D(uint32_t x, uint32_t y, uint32_t z) {
+    export constexpr uint32_t Morton3D(uint32_t x, uint32_t y, uint32_t z) {
         return ExpandBits(x) | (ExpandBits(y) << 1) | (ExpandBits(z) << 2);
     }
 
+    // Inverse of ExpandBits: gathers every third bit back into a contiguous integer.
+    export constexpr uint32_t CompactBits(uint32_t v) {
+        v &= 0x49249249u;
+        v = (v ^ (v >> 2)) & 0xC30C30C3u;
+        v = (v ^ (v >> 4)) & 0x0F00F00Fu;
+        v = (v ^ (v >> 8)) & 0xFF0000FFu;
+        v = (v ^ (v >> 16)) & 0x000003FFu;
+        return v;
+    }
+
+    // --- Layouts ---
+    // Each layout is a policy with the same static interface. A 4x4x4 block maps to hierarchy bit
+    // HierarchyBit(bx, by, bz) in every layout; BLOCK_CONTIGUOUS layouts also store it as 64 contiguous bytes
+    // (16 words, one cache line) at BlockIndex * 64, with LocalIndex giving the order inside the block.
+
+    /**
+     * @brief Storage order of Chunk::voxelIDs. The active one is injected into shaders by ShaderCompiler.
+     */
+    export enum class ChunkLayout : uint32_t {
+        Linear = 0, ///< x + y * CHUNK_SIZE + z * CHUNK_AREA
+        Morton = 1, ///< Z-order curve over the whole chunk
+        Brick = 2   ///< Bricks in hierarchy order, linear inside each brick
+    };
+
+    export struct LinearLayout {
+        static constexpr ChunkLayout KIND = ChunkLayout::Linear;
+        static constexpr bool BLOCK_CONTIGUOUS = false;
+
+        static constexpr uint32_t VoxelIndex(uint32_t x, uint32_t y, uint32_t z) { return x + y * CHUNK_SIZE + z * CHUNK_AREA; }
+        // Only used when BLOCK_CONTIGUOUS; kept so layout-generic code compiles.
+        static constexpr uint32_t BlockIndex(uint32_t bx, uint32_t by, uint32_t bz) { return HierarchyBit(bx, by, bz); }
+        static constexpr glm::ivec3 BlockCoord(uint32_t block) {
+            return glm::ivec3(block % CHUNK_BLOCKS, (block / CHUNK_BLOCKS) % CHUNK_BLOCKS, block / (CHUNK_BLOCKS * CHUNK_BLOCKS));
+        }
+        static constexpr uint32_t LocalIndex(uint32_t lx, uint32_t ly, uint32_t lz) { return lx + ly * 4 + lz * 16; }
+        static constexpr glm::ivec3 LocalCoord(uint32_t l) { return glm::ivec3(l & 3, (l >> 2) & 3, l >> 4); }
+    };
+
+    export struct MortonLayout {
+        static constexpr ChunkLayout KIND = ChunkLayout::Morton;
+        static constexpr bool BLOCK_CONTIGUOUS = true;
+
+        static constexpr uint32_t VoxelIndex(uint32_t x, uint32_t y, uint32_t z) { return Morton3D(x, y, z); }
+        static constexpr uint32_t BlockIndex(uint32_t bx, uint32_t by, uint32_t bz) { return Morton3D(bx, by, bz); }
+        static constexpr glm::ivec3 BlockCoord(uint32_t block) {
+            return glm::ivec3(CompactBits(block), CompactBits(block >> 1), CompactBits(block >> 2));
+        }
+        static constexpr uint32_t LocalIndex(uint32_t lx, uint32_t ly, uint32_t lz) { return Morton3D(lx, ly, lz); }
+        // Local Morton code bits: (x0 y0 z0 x1 y1 z1)
+        static constexpr glm::ivec3 LocalCoord(uint32_t l) {
+            return glm::ivec3((l & 1) | ((l >> 2) & 2), ((l >> 1) & 1) | ((l >> 3) & 2), ((l >> 2) & 1) | ((l >> 4) & 2));
+        }
+    };
+
+    export struct BrickLayout {
+        static constexpr ChunkLayout KIND = ChunkLayout::Brick;
+        static constexpr bool BLOCK_CONTIGUOUS = true;
+
+        static constexpr uint32_t BlockIndex(uint32_t bx, uint32_t by, uint32_t bz) { return HierarchyBit(bx, by, bz); }
+        static constexpr glm::ivec3 BlockCoord(uint32_t block) {
+            return glm::ivec3(block % CHUNK_BLOCKS, (block / CHUNK_BLOCKS) % CHUNK_BLOCKS, block / (CHUNK_BLOCKS * CHUNK_BLOCKS));
+        }
+        static constexpr uint32_t LocalIndex(uint32_t lx, uint32_t ly, uint32_t lz) { return lx + ly * 4 + lz * 16; }
+        static constexpr glm::ivec3 LocalCoord(uint32_t l) { return glm::ivec3(l & 3, (l >> 2) & 3, l >> 4); }
+        static constexpr uint32_t VoxelIndex(uint32_t x, uint32_t y, uint32_t z) {
+            return BlockIndex(x >> 2, y >> 2, z >> 2) * 64 + LocalIndex(x & 3, y & 3, z & 3);
+        }
+    };
+
+    template<ChunkLayout L> struct LayoutPolicy;
+    template<> struct LayoutPolicy<ChunkLayout::Linear> { using Type = LinearLayout; };
+    template<> struct LayoutPolicy<ChunkLayout::Morton> { using Type = MortonLayout; };
+    template<> struct LayoutPolicy<ChunkLayout::Brick> { using Type = BrickLayout; };
+
+    export constexpr ChunkLayout CHUNK_LAYOUT = static_cast<ChunkLayout>(VORTEX_CHUNK_LAYOUT);
+    export using ActiveLayout = LayoutPolicy<CHUNK_LAYOUT>::Type;
+
     /**
-     * @brief Represents a 32x32x32 block of voxels.
+     * @brief One bit per 4x4x4 block (HierarchyBit order) for blocks whose voxel data changed since the last upload.
+     * @details Starts fully dirty. Copies start fully dirty too: a copied chunk has never been uploaded to
+     * whatever GPU slot it ends up in, so only the write APIs of a chunk can make its mask partial.
+     */
+    export struct DirtyBlockMask {
+        uint32_t words[HIERARCHY_WORDS];
+
+        DirtyBlockMask() { SetAll(); }
+        DirtyBlockMask(const DirtyBlockMask&) { SetAll(); }
+        DirtyBlockMask& operator=(const DirtyBlockMask&) { SetAll(); return *this; }
+
+        void SetAll() { std::memset(words, 0xFF, sizeof(words)); }
+        void Clear() { std::memset(words, 0, sizeof(words)); }
+        void Set(uint32_t hBit) { words[hBit >> 5] |= 1u << (hBit & 31); }
+        bool Test(uint32_t hBit) const { return (words[hBit >> 5] >> (hBit & 31)) & 1u; }
+
+        bool Any() const {
+            uint32_t any = 0;
+            for (uint32_t i = 0; i < HIERARCHY_WORDS; ++i) any |= words[i];
+            return any != 0;
+        }
+    };
+
+    /**
+     * @brief Byte range inside a chunk's GPU prefix (see Chunk::GPU_SIZE).
+     */
+    export struct ChunkByteRange {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    /**
+     * @brief Represents a CHUNK_SIZE^3 block of voxels (32^3 by default, see VORTEX_CHUNK_SIZE).
      * @details Uses SoA (Structure of Arrays) layout aligned for GPU consumption.
-     * Data layout for voxelIDs can be Linear or Morton (Z-Order) for cache optimization.
+     * Data layout for voxelIDs is ActiveLayout (Linear, Morton or Brick, see ChunkLayout).
      */
     export struct Chunk {
-        // 32^3 = 32768 voxels.
+        // CHUNK_SIZE^3 voxels (32^3 = 32768).
         // Packed 4 voxels per uint (8 bits each).
-        uint32_t voxelIDs[8192];
+        uint32_t voxelIDs[CHUNK_WORDS];
         
         // Flags: 2 bits per voxel? Currently reserved/unused or used for other properties.
-        uint32_t voxelFlags[2048]; 
+        uint32_t voxelFlags[CHUNK_FLAG_WORDS]; 
         
         // Hierarchy: 1 bit per 4x4x4 block.
-        // 32/4 = 8 blocks per axis. 8^3 = 512 bits = 16 uints.
-        uint32_t hierarchy[16];
+        // CHUNK_SIZE/4 blocks per axis (32^3: 8^3 = 512 bits = 16 uints).
+        uint32_t hierarchy[HIERARCHY_WORDS];
+
+        // --- CPU-only data (not uploaded, see GPU_SIZE) ---
+
+        // Solid/empty bit per voxel, kept in sync with voxelIDs. Fast path for occupancy-only queries.
+        OccupancyMask occupancy;
+
+        // Count, position sum, per-material counts and bounds, kept in sync by every write API.
+        // Bounds may be stale (stats.boundsDirty); read them through GetStats().
+        ChunkStats stats;
+
+        // Blocks changed since the last GPU upload, marked by every write API. See CollectDirtyRanges.
+        DirtyBlockMask dirtyBlocks;
+
+        // Byte size of the prefix mirrored by the shader's Chunk struct (voxelIDs, voxelFlags, hierarchy).
+        static constexpr size_t GPU_SIZE = sizeof(uint32_t) * (CHUNK_WORDS + CHUNK_FLAG_WORDS + HIERARCHY_WORDS);
 
         Chunk() {
             std::memset(voxelIDs, 0, sizeof(voxelIDs));
@@ -55,55 +185,234 @@ namespace vortex::voxel {
         }
 
         /**
-         * @brief Sets a voxel at local coordinates (0..31).
-         * @details Automatically handles Linear vs Morton addressing.
+         * @brief Checks solidity via the occupancy mask (no ID decoding).
+         */
+        bool IsSolid(int x, int y, int z) const { return occupancy.Get(x, y, z); }
+
+        /**
+         * @brief Sets a voxel at local coordinates (0..CHUNK_SIZE-1).
+         * @details Addressing follows ActiveLayout.
          */
         void SetVoxel(int x, int y, int z, uint8_t id) {
-            if (x < 0 || x >= 32 || y < 0 || y >= 32 || z < 0 || z >= 32) return;
+            if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE) return;
 
-            uint32_t index;
-            if constexpr (USE_MORTON_LAYOUT) {
-                index = Morton3D((uint32_t)x, (uint32_t)y, (uint32_t)z);
-            } else {
-                index = x + y * 32 + z * 1024;
-            }
+            uint32_t index = VoxelIndex((uint32_t)x, (uint32_t)y, (uint32_t)z);
 
             // Pack into 32-bit array (4 voxels per uint)
             uint32_t arrayIdx = index >> 2;       // index / 4
             uint32_t shift = (index & 3) << 3;    // (index % 4) * 8
-            
+
+            uint8_t old = (voxelIDs[arrayIdx] >> shift) & 0xFF;
+            if (old == id) return;
+            if (old != 0) stats.Remove(x, y, z, old);
+            if (id != 0) stats.Add(x, y, z, id);
+
             // Clear old value
             voxelIDs[arrayIdx] &= ~(0xFF << shift);
             // Set new value
             voxelIDs[arrayIdx] |= (static_cast<uint32_t>(id) << shift);
 
+            occupancy.Set(x, y, z, id != 0);
+
             // Update Hierarchy (Linear mapping used for hierarchy to match simple shader logic)
-            // Hierarchy tracks 4x4x4 blocks.
+            // Hierarchy tracks 4x4x4 blocks and is kept exact, so consumers can rely on it for empty-space skipping.
+            int bx = x >> 2;
+            int by = y >> 2;
+            int bz = z >> 2;
+            uint32_t hIndex = HierarchyBit(bx, by, bz);
+            dirtyBlocks.Set(hIndex);
+
             if (id != 0) {
-                int bx = x >> 2;
-                int by = y >> 2;
-                int bz = z >> 2;
-                uint32_t hIndex = bx + by * 8 + bz * 64;
-                
                 hierarchy[hIndex >> 5] |= (1u << (hIndex & 31));
+            } else if (IsBlockEmpty(bx, by, bz)) {
+                // Only the one affected block (16 words) needs to be checked.
+                hierarchy[hIndex >> 5] &= ~(1u << (hIndex & 31));
+            }
+        }
+
+        /**
+         * @brief Checks voxel data of one 4x4x4 block (ignores the hierarchy bit).
+         * @details In Morton and Brick layouts the block is 16 contiguous words; in linear layout each word
+         * is one 4-voxel row of the block, so both cases read exactly 16 words.
+         */
+        bool IsBlockEmpty(int bx, int by, int bz) const {
+            uint32_t any = 0;
+            if constexpr (ActiveLayout::BLOCK_CONTIGUOUS) {
+                const uint32_t* words = voxelIDs + ActiveLayout::BlockIndex((uint32_t)bx, (uint32_t)by, (uint32_t)bz) * 16;
+                for (int i = 0; i < 16; ++i) any |= words[i];
             } else {
-                // Note: Clearing hierarchy bit requires checking all 64 voxels in the block.
-                // Skipped for performance in simple Setter. Rebuild hierarchy if mass clearing.
+                for (int lz = 0; lz < 4; ++lz)
+                    for (int ly = 0; ly < 4; ++ly)
+                        any |= voxelIDs[((bz * 4 + lz) * CHUNK_AREA + (by * 4 + ly) * CHUNK_SIZE + bx * 4) >> 2];
             }
+            return any == 0;
         }
 
+        // --- Region API ---
+        // Bulk writes operate on whole 4x4x4 blocks where possible (64 contiguous bytes in block-contiguous layouts)
+        // and rebuild the hierarchy and occupancy once at the end instead of per voxel.
+        // Regions are given as [min, max) and clipped to the chunk.
+
         /**
-         * @brief Gets a voxel ID at local coordinates.
+         * @brief Fills the box [min, max) with one material (0 clears).
          */
-        uint8_t GetVoxel(int x, int y, int z) const {
-            if (x < 0 || x >= 32 || y < 0 || y >= 32 || z < 0 || z >= 32) return 0;
+        void FillBox(const glm::ivec3& min, const glm::ivec3& max, uint8_t id);
 
-            uint32_t index;
-            if constexpr (USE_MORTON_LAYOUT) {
-                index = Morton3D((uint32_t)x, (uint32_t)y, (uint32_t)z);
+        /**
+         * @brief Copies the region [srcMin, srcMin + size) of another chunk to dstMin.
+         * @param skipEmpty If true, empty source voxels do not overwrite destination voxels.
+         */
+        void CopyRegion(const Chunk& src, const glm::ivec3& srcMin, const glm::ivec3& dstMin, const glm::ivec3& size, bool skipEmpty = false);
+
+        /**
+         * @brief Writes a dense X-major buffer (index = x + y * size.x + z * size.x * size.y) to [min, min + size).
+         */
+        void WriteLinear(std::span<const uint8_t> data, const glm::ivec3& min, const glm::ivec3& size);
+
+        /**
+         * @brief Decodes the whole chunk into X-major order (index = x + y * CHUNK_SIZE + z * CHUNK_AREA).
+         * @details Uses the SIMD transcoder, a few microseconds per chunk.
+         */
+        void ReadLinear(std::span<uint8_t, CHUNK_VOXELS> out) const;
+
+        /**
+         * @brief Writes id to every voxel whose bit is set in a chunk-sized bit mask (OccupancyMask row format).
+         * @param rows CHUNK_AREA rows, bit x of rows[z * CHUNK_SIZE + y] selects voxel (x, y, z).
+         */
+        void ApplyMask(std::span<const OccupancyRow, CHUNK_AREA> rows, uint8_t id);
+
+        /**
+         * @brief Counts solid voxels in [min, max) and optionally sums their centers (x + 0.5, ...).
+         * @details Works on occupancy rows (popcount per row), no voxel IDs are decoded.
+         */
+        uint32_t CountSolidInBox(const glm::ivec3& min, const glm::ivec3& max, glm::vec3* centerSum = nullptr) const;
+
+        /**
+         * @brief Statistics with up-to-date bounds (recomputed from occupancy rows if an erase made them stale).
+         */
+        const ChunkStats& GetStats();
+
+        /**
+         * @brief Recomputes all statistics from the occupancy mask and occupied blocks.
+         * @details Relies on an exact hierarchy and occupancy. Region writes keep stats current on their own;
+         * this is for data loaded behind the Chunk's back (e.g. decompression).
+         */
+        void RebuildStats();
+
+        /**
+         * @brief Marks every block overlapping [min, max) as changed (clipped to the chunk).
+         */
+        void MarkBoxDirty(const glm::ivec3& min, const glm::ivec3& max);
+
+        /**
+         * @brief Appends the byte ranges of the GPU prefix that changed since the last ClearDirty, in ascending order.
+         * @details Dirty blocks become one 64-byte run each in block-contiguous layouts and 16 row segments in linear
+         * layout; adjacent runs are merged. The hierarchy words are appended whenever any block is dirty.
+         * voxelFlags is never written after construction and is not included.
+         */
+        void CollectDirtyRanges(std::vector<ChunkByteRange>& out) const;
+
+        bool IsDirty() const { return dirtyBlocks.Any(); }
+
+        /**
+         * @brief Call after the chunk's GPU copy has been brought up to date.
+         */
+        void ClearDirty() { dirtyBlocks.Clear(); }
+
+        /**
+         * @brief Recomputes every hierarchy bit exactly from voxel data.
+         */
+        void RebuildHierarchy();
+
+        /**
+         * @brief Recomputes the occupancy mask from voxel data, visiting only occupied blocks.
+         * @details Relies on an exact hierarchy, so call RebuildHierarchy first.
+         */
+        void RebuildOccupancy();
+
+        /**
+         * @brief Storage index of a voxel in ActiveLayout. No bounds check.
+         */
+        static constexpr uint32_t VoxelIndex(uint32_t x, uint32_t y, uint32_t z) {
+            return ActiveLayout::VoxelIndex(x, y, z);
+        }
+
+        /**
+         * @brief Writes a voxel by storage index without touching the hierarchy, occupancy, stats or dirty mask.
+         */
+        void WriteRaw(uint32_t index, uint8_t id) {
+            uint32_t shift = (index & 3) << 3;
+            voxelIDs[index >> 2] = (voxelIDs[index >> 2] & ~(0xFFu << shift)) | (static_cast<uint32_t>(id) << shift);
+        }
+
+        uint8_t ReadRaw(uint32_t index) const {
+            return (voxelIDs[index >> 2] >> ((index & 3) << 3)) & 0xFF;
+        }
+
+        // --- Iteration ---
+
+        /**
+         * @brief Calls fn(x, y, z, id) for every solid voxel, in storage order.
+         * @details Skips empty 4x4x4 blocks via the hierarchy and zero words (4 empty voxels) without decoding.
+         * Coordinates are derived from the block origin plus the 6-bit local index, never re-encoded.
+         * Cost is proportional to occupied blocks, not to CHUNK_SIZE^3.
+         */
+        template<typename Fn>
+        void ForEachSolidVoxel(const Fn& fn) const {
+            if constexpr (ActiveLayout::BLOCK_CONTIGUOUS) {
+                for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block) {
+                    glm::ivec3 base = ActiveLayout::BlockCoord(block) * 4;
+                    uint32_t hBit = HierarchyBit(base.x >> 2, base.y >> 2, base.z >> 2);
+                    if ((hierarchy[hBit >> 5] & (1u << (hBit & 31))) == 0) continue;
+
+                    const uint32_t* words = voxelIDs + block * 16;
+                    for (uint32_t w = 0; w < 16; ++w) {
+                        uint32_t word = words[w];
+                        if (word == 0) continue;
+                        for (uint32_t b = 0; b < 4; ++b) {
+                            uint8_t id = (word >> (b * 8)) & 0xFF;
+                            if (id == 0) continue;
+                            glm::ivec3 p = base + ActiveLayout::LocalCoord(w * 4 + b);
+                            fn(p.x, p.y, p.z, id);
+                        }
+                    }
+                }
             } else {
-                index = x + y * 32 + z * 1024;
+                for (uint32_t w = 0; w < CHUNK_WORDS; ++w) {
+                    uint32_t word = voxelIDs[w];
+                    if (word == 0) continue;
+                    uint32_t index = w * 4;
+                    int x = (int)(index % CHUNK_SIZE), y = (int)((index / CHUNK_SIZE) % CHUNK_SIZE), z = (int)(index / CHUNK_AREA);
+                    for (uint32_t b = 0; b < 4; ++b) {
+                        uint8_t id = (word >> (b * 8)) & 0xFF;
+                        if (id != 0) fn(x + (int)b, y, z, id);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Calls fn(bx, by, bz) for every occupied 4x4x4 block (block coordinates 0..CHUNK_BLOCKS-1).
+         */
+        template<typename Fn>
+        void ForEachSolidBlock(const Fn& fn) const {
+            for (uint32_t i = 0; i < HIERARCHY_WORDS; ++i) {
+                uint32_t bits = hierarchy[i];
+                while (bits) {
+                    uint32_t hBit = i * 32 + (uint32_t)std::countr_zero(bits);
+                    bits &= bits - 1;
+                    fn((int)(hBit % CHUNK_BLOCKS), (int)((hBit / CHUNK_BLOCKS) % CHUNK_BLOCKS), (int)(hBit / (CHUNK_BLOCKS * CHUNK_BLOCKS)));
+                }
             }
+        }
+
+        /**
+         * @brief Gets a voxel ID at local coordinates.
+         */
+        uint8_t GetVoxel(int x, int y, int z) const {
+            if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE) return 0;
+
+            uint32_t index = VoxelIndex((uint32_t)x, (uint32_t)y, (uint32_t)z);
 
             uint32_t arrayIdx = index >> 2;
             uint32_t shift = (index & 3) << 3;
@@ -0,0 +1,36 @@
+module;
+
+#include <cstdint>
+
+// Chunk edge length in voxels, set by CMake (VORTEX_CHUNK_SIZE): 16, 32 or 64.
+#ifndef VORTEX_CHUNK_SIZE
+    #define VORTEX_CHUNK_SIZE 32
+#endif
+
+export module vortex.voxel:config;
+
+namespace vortex::voxel {
+
+    // --- Chunk Dimensions ---
+    // Shared by every voxel system and injected into shaders by ShaderCompiler.
+
+    export constexpr int CHUNK_SIZE = VORTEX_CHUNK_SIZE;
+    static_assert(CHUNK_SIZE == 16 || CHUNK_SIZE == 32 || CHUNK_SIZE == 64, "VORTEX_CHUNK_SIZE must be 16, 32 or 64");
+
+    export constexpr uint32_t CHUNK_AREA = (uint32_t)(CHUNK_SIZE * CHUNK_SIZE);      ///< Voxels per XY slice / occupancy rows
+    export constexpr uint32_t CHUNK_VOXELS = CHUNK_AREA * CHUNK_SIZE;                ///< Voxels per chunk
+    export constexpr uint32_t CHUNK_WORDS = CHUNK_VOXELS / 4;                        ///< uint32 words of packed 8-bit IDs
+    export constexpr uint32_t CHUNK_FLAG_WORDS = CHUNK_VOXELS / 16;                  ///< uint32 words of 2-bit flags
+
+    // Hierarchy: 1 bit per 4x4x4 block.
+    export constexpr int CHUNK_BLOCKS = CHUNK_SIZE / 4;                              ///< Blocks per axis
+    export constexpr uint32_t CHUNK_BLOCK_COUNT = (uint32_t)(CHUNK_BLOCKS * CHUNK_BLOCKS * CHUNK_BLOCKS);
+    export constexpr uint32_t HIERARCHY_WORDS = (CHUNK_BLOCK_COUNT + 31) / 32;
+
+    /**
+     * @brief Hierarchy bit of block (bx, by, bz). Linear in every chunk layout.
+     */
+    export constexpr uint32_t HierarchyBit(uint32_t bx, uint32_t by, uint32_t bz) {
+        return bx + by * CHUNK_BLOCKS + bz * CHUNK_BLOCKS * CHUNK_BLOCKS;
+    }
+}
@@ -0,0 +1,75 @@
+module;
+
+#include <cstdint>
+#include <array>
+#include <glm/glm.hpp>
+
+export module vortex.voxel:stats;
+
+import :config;
+
+namespace vortex::voxel {
+
+    /**
+     * @brief Aggregate statistics of a chunk, maintained by the Chunk write APIs.
+     * @details Single-voxel writes update every field in O(1). Region writes apply the delta of the
+     * affected region only. Bounds shrink lazily: erasing a voxel on the bounds marks them dirty and
+     * Chunk::GetStats recomputes them from the occupancy rows (CHUNK_AREA row reads, no voxel decoding).
+     */
+    export struct ChunkStats {
+        /// @brief Number of solid (non-zero) voxels.
+        uint32_t solidCount = 0;
+
+        /// @brief Sum of solid voxel coordinates (min corners). Fits 32 bits up to 64^3.
+        glm::uvec3 positionSum{0u};
+
+        /// @brief Solid voxels per material ID (index 0 is always 0).
+        std::array<uint32_t, 256> materialCounts{};
+
+        /// @brief Occupied voxel bounds [boundsMin, boundsMax). Empty chunks have boundsMin == boundsMax.
+        glm::ivec3 boundsMin{0};
+        glm::ivec3 boundsMax{0};
+
+        /// @brief Bounds may be larger than the occupied region and must be recomputed before use.
+        bool boundsDirty = false;
+
+        void Clear() { *this = ChunkStats{}; }
+
+        void Add(int x, int y, int z, uint8_t id) {
+            glm::ivec3 p(x, y, z);
+            if (solidCount == 0) {
+                boundsMin = p;
+                boundsMax = p + 1;
+                boundsDirty = false;
+            } else {
+                boundsMin = glm::min(boundsMin, p);
+                boundsMax = glm::max(boundsMax, p + 1);
+            }
+            solidCount++;
+            positionSum += glm::uvec3(p);
+            materialCounts[id]++;
+        }
+
+        void Remove(int x, int y, int z, uint8_t id) {
+            glm::ivec3 p(x, y, z);
+            solidCount--;
+            positionSum -= glm::uvec3(p);
+            materialCounts[id]--;
+
+            if (solidCount == 0) {
+                boundsMin = boundsMax = glm::ivec3(0);
+                boundsDirty = false;
+            } else if (glm::any(glm::equal(p, boundsMin)) || glm::any(glm::equal(p + 1, boundsMax))) {
+                boundsDirty = true;
+            }
+        }
+
+        /**
+         * @brief Center of mass in chunk-local space (voxel centers), or the chunk center when empty.
+         */
+        glm::vec3 Center() const {
+            if (solidCount == 0) return glm::vec3(CHUNK_SIZE * 0.5f);
+            return glm::vec3(positionSum) / (float)solidCount + 0.5f;
+        }
+    };
+}
@@ -0,0 +1,68 @@
+module;
+
+#include <vector>
+#include <cstdint>
+#include <span>
+
+export module vortex.voxel:compressed;
+
+import :config;
+import :chunk;
+
+namespace vortex::voxel {
+
+    /**
+     * @brief Compact CPU-side storage for a Chunk.
+     * @details Voxel IDs are kept in storage (Morton) order as bit-packed indices into a small local palette,
+     * so expanding back to the GPU layout is a palette lookup (pshufb when available), not a per-voxel re-encode.
+     * Uniform chunks (all empty, all one material) store no voxel data at all.
+     * The hierarchy is stored as-is (HIERARCHY_WORDS words); voxelFlags is unused and not kept (expands to zero).
+     *
+     * Typical sizes at 32^3: uniform ~0 KB, 2 materials 4 KB, 4 materials 8 KB, 16 materials 16 KB,
+     * otherwise 32 KB raw, versus 44 KB for a full Chunk.
+     */
+    export class CompressedChunk {
+    public:
+        enum class Encoding : uint8_t {
+            Uniform = 0,
+            Palette1,   ///< 1 bit per voxel, up to 2 IDs
+            Palette2,   ///< 2 bits per voxel, up to 4 IDs
+            Palette4,   ///< 4 bits per voxel, up to 16 IDs
+            Raw         ///< 8 bits per voxel, copy of voxelIDs
+        };
+
+        CompressedChunk() = default;
+
+        static CompressedChunk Compress(const Chunk& chunk);
+
+        /**
+         * @brief Expands into a full chunk (voxel IDs, hierarchy and occupancy).
+         */
+        void Decompress(Chunk& out) const;
+
+        /**
+         * @brief Expands only the packed voxel IDs (Chunk::voxelIDs layout).
+         */
+        void DecodeVoxelIDs(std::span<uint32_t, CHUNK_WORDS> out) const;
+
+        /**
+         * @brief Writes the GPU prefix of a chunk (Chunk::GPU_SIZE bytes) directly to dst, e.g. mapped memory.
+         */
+        void WriteGPU(void* dst) const;
+
+        Encoding GetEncoding() const { return m_Encoding; }
+        uint32_t GetPaletteSize() const { return m_PaletteSize; }
+
+        /**
+         * @brief Heap + inline bytes held by this chunk.
+         */
+        size_t GetMemoryUsage() const { return sizeof(CompressedChunk) + m_Data.capacity() * sizeof(uint32_t); }
+
+    private:
+        Encoding m_Encoding = Encoding::Uniform;
+        uint8_t m_PaletteSize = 1;
+        uint8_t m_Palette[16] = {};
+        uint32_t m_Hierarchy[HIERARCHY_WORDS] = {};
+        std::vector<uint32_t> m_Data;
+    };
+}
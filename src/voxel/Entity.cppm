@@ -8,7 +8,9 @@ module;
 
 export module vortex.voxel:entity;
 
+import :config;
 import :object;
+import :stats;
 
 namespace vortex::voxel {
 
@@ -51,6 +53,7 @@ namespace vortex::voxel {
 
         /**
          * @brief Recalculates stats.
+         * @details O(parts): per-part count and center come from the chunks' incrementally maintained ChunkStats.
          */
         void RecalculateStats() {
             totalVoxelCount = 0;
@@ -64,12 +67,19 @@ namespace vortex::voxel {
                     weightedCenterSum += (p->position + p->logicalCenter) * static_cast<float>(p->voxelCount);
                     totalVoxelCount += p->voxelCount;
 
-                    localBoundsMin = glm::min(localBoundsMin, p->position);
-                    localBoundsMax = glm::max(localBoundsMax, p->position + glm::vec3(32.0f));
+                    // Tight occupied bounds of the part, not the whole chunk cube.
+                    const ChunkStats& stats = p->chunk->GetStats();
+                    if (stats.solidCount == 0) continue;
+                    localBoundsMin = glm::min(localBoundsMin, p->position + glm::vec3(stats.boundsMin));
+                    localBoundsMax = glm::max(localBoundsMax, p->position + glm::vec3(stats.boundsMax));
                 }
             }
 
-            if (totalVoxelCount > 0) logicalCenter = weightedCenterSum / static_cast<float>(totalVoxelCount);
+            if (totalVoxelCount > 0) {
+                logicalCenter = weightedCenterSum / static_cast<float>(totalVoxelCount);
+            } else {
+                localBoundsMin = localBoundsMax = glm::vec3(0.0f);
+            }
         }
         
         glm::vec3 GetLocalCenter() const { return logicalCenter; }
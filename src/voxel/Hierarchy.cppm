@@ -6,27 +6,29 @@ module;
 
 export module vortex.voxel:hierarchy;
 
+import :config;
+
 namespace vortex::voxel {
 
     /**
      * @brief Acceleration structure for Voxel Ray Tracing (Grid Hierarchy).
-     * @details Represents a 32x32x32 chunk divided into 8x8x8 blocks (4x4x4 voxels each).
+     * @details Represents a CHUNK_SIZE^3 chunk divided into CHUNK_BLOCKS^3 blocks (4x4x4 voxels each).
      * Each bit corresponds to one 4x4x4 block. If a bit is 0, the entire 4x4x4 block is empty, allow the raymarcher to skip it.
-     * Total size: 512 bits (64 bytes).
+     * Total size: CHUNK_BLOCK_COUNT bits (64 bytes at 32^3).
      */
     export struct HierarchyMask {
-        // 512 bits / 64 bits per uint64 = 8 integers.
-        uint64_t masks[8]; 
+        // One bit per block, 64 bits per uint64.
+        uint64_t masks[(CHUNK_BLOCK_COUNT + 63) / 64]; 
 
         /**
          * @brief Checks if a specific 4x4x4 block is marked as empty.
-         * @param bx Block X (0-7).
-         * @param by Block Y (0-7).
-         * @param bz Block Z (0-7).
+         * @param bx Block X (0 to CHUNK_BLOCKS - 1).
+         * @param by Block Y (0 to CHUNK_BLOCKS - 1).
+         * @param bz Block Z (0 to CHUNK_BLOCKS - 1).
          * @return True if the block is empty.
          */
         bool IsBlockEmpty(int bx, int by, int bz) const {
-            int blockIndex = bx + by * 8 + bz * 64;
+            int blockIndex = (int)HierarchyBit(bx, by, bz);
             int uintIndex = blockIndex / 64;
             int bitIndex = blockIndex % 64;
             return !(masks[uintIndex] & (1ULL << bitIndex));
@@ -34,13 +36,13 @@ namespace vortex::voxel {
 
         /**
          * @brief Updates the occupancy status of a block.
-         * @param bx Block X (0-7).
-         * @param by Block Y (0-7).
-         * @param bz Block Z (0-7).
+         * @param bx Block X (0 to CHUNK_BLOCKS - 1).
+         * @param by Block Y (0 to CHUNK_BLOCKS - 1).
+         * @param bz Block Z (0 to CHUNK_BLOCKS - 1).
          * @param notEmpty If true, marks the block as occupied.
          */
         void SetBlockStatus(int bx, int by, int bz, bool notEmpty) {
-            int blockIndex = bx + by * 8 + bz * 64;
+            int blockIndex = (int)HierarchyBit(bx, by, bz);
             int uintIndex = blockIndex / 64;
             int bitIndex = blockIndex % 64;
             
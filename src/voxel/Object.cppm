@@ -7,6 +7,7 @@ module;
 
 export module vortex.voxel:object;
 
+import :config;
 import :chunk;
 
 namespace vortex::voxel {
@@ -23,7 +24,7 @@ namespace vortex::voxel {
         glm::vec3 scale{1.0f};
 
         /// @brief Logical Center (Center of Mass) relative to Chunk Origin (0,0,0).
-        glm::vec3 logicalCenter{16.0f}; // Default to center of 32x32x32 block
+        glm::vec3 logicalCenter{CHUNK_SIZE * 0.5f}; // Default to center of the chunk
         
         /// @brief Number of solid voxels in this object.
         uint32_t voxelCount{0};
@@ -47,33 +48,14 @@ namespace vortex::voxel {
         }
 
         /**
-         * @brief Recalculates the logical center based on voxel positions within the chunk.
-         * @details Should be called after modifying the chunk content.
+         * @brief Refreshes the logical center and voxel count from the chunk's stats.
+         * @details O(1): the chunk write APIs maintain count and position sum incrementally.
          */
         void RecalculateCenter() {
             if (!chunk) return;
 
-            glm::vec3 sumPos(0.0f);
-            uint32_t count = 0;
-
-            for (int z = 0; z < 32; ++z) {
-                for (int y = 0; y < 32; ++y) {
-                    for (int x = 0; x < 32; ++x) {
-                        if (chunk->GetVoxel(x, y, z) != 0) {
-                            // Add +0.5 to use the center of the voxel, not the corner
-                            sumPos += glm::vec3(x + 0.5f, y + 0.5f, z + 0.5f);
-                            count++;
-                        }
-                    }
-                }
-            }
-
-            if (count > 0) {
-                logicalCenter = sumPos / (float)count;
-            } else {
-                logicalCenter = glm::vec3(16.0f); // Fallback to geometric center
-            }
-            voxelCount = count;
+            logicalCenter = chunk->stats.Center(); // Falls back to the geometric center when empty
+            voxelCount = chunk->stats.solidCount;
         }
     };
 }
\ No newline at end of file
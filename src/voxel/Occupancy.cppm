@@ -0,0 +1,141 @@
+module;
+
+#include <cstdint>
+#include <cstring>
+#include <bit>
+#include <type_traits>
+
+export module vortex.voxel:occupancy;
+
+import :config;
+
+namespace vortex::voxel {
+
+    /**
+     * @brief Axis-aligned face direction of a voxel.
+     */
+    export enum class VoxelFace : uint8_t {
+        PosX = 0, NegX, PosY, NegY, PosZ, NegZ
+    };
+
+    /**
+     * @brief One occupancy row (CHUNK_SIZE voxels along X). 16-voxel rows use the low half of a uint32.
+     */
+    export using OccupancyRow = std::conditional_t<CHUNK_SIZE == 64, uint64_t, uint32_t>;
+    export constexpr OccupancyRow OCCUPANCY_ROW_MASK = CHUNK_SIZE >= 32 ? ~OccupancyRow(0) : ((OccupancyRow(1) << CHUNK_SIZE) - 1);
+
+    /**
+     * @brief 1 bit per voxel solid/empty mask of a chunk (4 KB at 32^3).
+     * @details Row-major along X: bit x of rows[z * CHUNK_SIZE + y] is voxel (x, y, z).
+     * Whole rows are processed with plain integer ops, so neighbor tests, face extraction and
+     * counts touch a full row of voxels per instruction instead of decoding 8-bit IDs one by one.
+     */
+    export struct OccupancyMask {
+        OccupancyRow rows[CHUNK_AREA];
+
+        OccupancyMask() { Clear(); }
+
+        void Clear() { std::memset(rows, 0, sizeof(rows)); }
+
+        static constexpr uint32_t RowIndex(int y, int z) { return (uint32_t)(z * CHUNK_SIZE + y); }
+
+        bool Get(int x, int y, int z) const {
+            if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE) return false;
+            return (rows[RowIndex(y, z)] >> x) & 1u;
+        }
+
+        void Set(int x, int y, int z, bool solid) {
+            OccupancyRow bit = OccupancyRow(1) << x;
+            OccupancyRow& row = rows[RowIndex(y, z)];
+            row = solid ? (row | bit) : (row & ~bit);
+        }
+
+        OccupancyRow Row(int y, int z) const {
+            if (y < 0 || y >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE) return 0;
+            return rows[RowIndex(y, z)];
+        }
+
+        // --- Counts ---
+
+        uint32_t PopCount() const {
+            uint32_t count = 0;
+            for (uint32_t i = 0; i < CHUNK_AREA; ++i) count += (uint32_t)std::popcount(rows[i]);
+            return count;
+        }
+
+        bool IsEmpty() const {
+            OccupancyRow any = 0;
+            for (uint32_t i = 0; i < CHUNK_AREA; ++i) any |= rows[i];
+            return any == 0;
+        }
+
+        // --- Bitwise Set Operations ---
+
+        void And(const OccupancyMask& o) { for (uint32_t i = 0; i < CHUNK_AREA; ++i) rows[i] &= o.rows[i]; }
+        void Or(const OccupancyMask& o) { for (uint32_t i = 0; i < CHUNK_AREA; ++i) rows[i] |= o.rows[i]; }
+        void AndNot(const OccupancyMask& o) { for (uint32_t i = 0; i < CHUNK_AREA; ++i) rows[i] &= ~o.rows[i]; }
+
+        // --- Neighbor Shifts ---
+        // out(x, y, z) = this(x + d.x, y + d.y, z + d.z), with voxels outside the chunk treated as empty.
+        // I.e. bit set in the result means "the neighbor in that direction is solid".
+
+        void ShiftX(int d, OccupancyMask& out) const {
+            for (uint32_t i = 0; i < CHUNK_AREA; ++i) {
+                out.rows[i] = d > 0 ? (rows[i] >> d) : (d < 0 ? ((rows[i] << -d) & OCCUPANCY_ROW_MASK) : rows[i]);
+            }
+        }
+
+        void ShiftY(int d, OccupancyMask& out) const {
+            for (int z = 0; z < CHUNK_SIZE; ++z)
+                for (int y = 0; y < CHUNK_SIZE; ++y)
+                    out.rows[RowIndex(y, z)] = Row(y + d, z);
+        }
+
+        void ShiftZ(int d, OccupancyMask& out) const {
+            for (int z = 0; z < CHUNK_SIZE; ++z)
+                for (int y = 0; y < CHUNK_SIZE; ++y)
+                    out.rows[RowIndex(y, z)] = Row(y, z + d);
+        }
+
+        void Neighbor(VoxelFace face, OccupancyMask& out) const {
+            switch (face) {
+                case VoxelFace::PosX: ShiftX(1, out); break;
+                case VoxelFace::NegX: ShiftX(-1, out); break;
+                case VoxelFace::PosY: ShiftY(1, out); break;
+                case VoxelFace::NegY: ShiftY(-1, out); break;
+                case VoxelFace::PosZ: ShiftZ(1, out); break;
+                case VoxelFace::NegZ: ShiftZ(-1, out); break;
+            }
+        }
+
+        // --- Faces ---
+
+        /**
+         * @brief Solid voxels whose neighbor in the given direction is empty (exposed faces).
+         */
+        void FaceMask(VoxelFace face, OccupancyMask& out) const {
+            Neighbor(face, out);
+            for (uint32_t i = 0; i < CHUNK_AREA; ++i) out.rows[i] = rows[i] & ~out.rows[i];
+        }
+
+        /**
+         * @brief Total number of exposed voxel faces (surface area in voxel units).
+         */
+        uint32_t CountExposedFaces() const {
+            uint32_t count = 0;
+            for (int z = 0; z < CHUNK_SIZE; ++z) {
+                for (int y = 0; y < CHUNK_SIZE; ++y) {
+                    OccupancyRow r = rows[RowIndex(y, z)];
+                    if (r == 0) continue;
+                    count += (uint32_t)std::popcount(r & ~(r >> 1));  // +X
+                    count += (uint32_t)std::popcount(r & ~(r << 1));  // -X
+                    count += (uint32_t)std::popcount(r & ~Row(y + 1, z));
+                    count += (uint32_t)std::popcount(r & ~Row(y - 1, z));
+                    count += (uint32_t)std::popcount(r & ~Row(y, z + 1));
+                    count += (uint32_t)std::popcount(r & ~Row(y, z - 1));
+                }
+            }
+            return count;
+        }
+    };
+}
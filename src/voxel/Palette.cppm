@@ -63,8 +63,12 @@ namespace vortex::voxel {
         const PhysicalMaterial& Get(uint8_t index) const {
             if (index >= m_Materials.size()) {
                 // Return Error Pink on invalid index
-                static PhysicalMaterial errorMat{}; 
-                errorMat.color = glm::vec4(1.0f, 0.0f, 1.0f, 1.0f);
+                // Initialized once so concurrent readers (parallel SHRED) never write to it.
+                static const PhysicalMaterial errorMat = [] {
+                    PhysicalMaterial m{};
+                    m.color = glm::vec4(1.0f, 0.0f, 1.0f, 1.0f);
+                    return m;
+                }();
                 return errorMat;
             }
             return m_Materials[index];
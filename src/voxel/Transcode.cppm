@@ -0,0 +1,42 @@
+module;
+
+#include <cstdint>
+#include <span>
+
+export module vortex.voxel:transcode;
+
+import :config;
+
+namespace vortex::voxel {
+
+    /**
+     * @brief Implementation used by ChunkTranscoder.
+     */
+    export enum class TranscodeKernel : uint8_t {
+        Scalar = 0,
+        SSE4,   ///< SSSE3 byte shuffles + SSE4.1 extracts.
+        AVX2    ///< AVX2 shuffles, BMI2 pext for block coordinates.
+    };
+
+    /**
+     * @brief Converts whole chunk voxel arrays between storage order (ActiveLayout) and linear X-major order.
+     * @details Linear index = x + y * CHUNK_SIZE + z * CHUNK_AREA, one byte per voxel.
+     * Works one 4x4x4 block (64 bytes) at a time: in Morton layout each block is permuted in registers with
+     * byte shuffles and moved as 16 four-byte row segments, so no per-voxel Morton encoding is done.
+     * The fastest kernel supported by the CPU is picked on first use.
+     * Brick layout needs no permutation (16 row copies per block) and Linear layout is a plain copy.
+     */
+    export class ChunkTranscoder {
+    public:
+        static void StorageToLinear(std::span<const uint32_t, CHUNK_WORDS> voxelIDs, std::span<uint8_t, CHUNK_VOXELS> linear);
+        static void LinearToStorage(std::span<const uint8_t, CHUNK_VOXELS> linear, std::span<uint32_t, CHUNK_WORDS> voxelIDs);
+
+        static bool IsSupported(TranscodeKernel kernel);
+        static TranscodeKernel GetKernel();
+
+        /**
+         * @brief Forces a kernel (tests, benchmarks). Falls back to Scalar if unsupported.
+         */
+        static void SetKernel(TranscodeKernel kernel);
+    };
+}
@@ -8,7 +8,12 @@ export import :hierarchy;
 export import :object;
 export import :world;
 export import :shapebuilder;
+export import :config;
 export import :chunk;
+export import :occupancy;
+export import :stats;
+export import :transcode;
+export import :compressed;
 export import :entity;
 
 export import :mesh_converter;
@@ -0,0 +1,496 @@
+module;
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <span>
+#include <bit>
+#include <algorithm>
+#include <vector>
+#include <glm/glm.hpp>
+
+module vortex.voxel;
+
+import :config;
+import :chunk;
+import :occupancy;
+import :stats;
+import :transcode;
+
+namespace vortex::voxel {
+
+    // --- Block Helpers ---
+    // A 4x4x4 block is 64 voxels = 16 words. In block-contiguous layouts (Morton, Brick) its voxels
+    // start at ActiveLayout::BlockIndex(bx, by, bz) * 64, and the low 6 bits of the index are the local index.
+
+    static constexpr uint32_t BLOCK_WORDS = 16;
+
+    struct BlockTables {
+        // Storage block index -> linear hierarchy bit (HierarchyBit(bx, by, bz))
+        std::array<uint16_t, CHUNK_BLOCK_COUNT> blockToHierarchyBit{};
+        // Local storage index (0..63) -> packed local coordinate (lx | ly << 2 | lz << 4)
+        std::array<uint8_t, 64> localToCoord{};
+    };
+
+    static constexpr BlockTables BuildBlockTables() {
+        BlockTables t{};
+        for (uint32_t bz = 0; bz < CHUNK_BLOCKS; ++bz)
+            for (uint32_t by = 0; by < CHUNK_BLOCKS; ++by)
+                for (uint32_t bx = 0; bx < CHUNK_BLOCKS; ++bx)
+                    t.blockToHierarchyBit[ActiveLayout::BlockIndex(bx, by, bz)] = (uint16_t)HierarchyBit(bx, by, bz);
+
+        for (uint32_t lz = 0; lz < 4; ++lz)
+            for (uint32_t ly = 0; ly < 4; ++ly)
+                for (uint32_t lx = 0; lx < 4; ++lx)
+                    t.localToCoord[ActiveLayout::LocalIndex(lx, ly, lz)] = (uint8_t)(lx | (ly << 2) | (lz << 4));
+        return t;
+    }
+
+    static constexpr BlockTables s_BlockTables = BuildBlockTables();
+
+    static glm::ivec3 ClampToChunk(const glm::ivec3& v) {
+        return glm::clamp(v, glm::ivec3(0), glm::ivec3(CHUNK_SIZE));
+    }
+
+    static bool IsEmptyRange(const glm::ivec3& lo, const glm::ivec3& hi) {
+        return lo.x >= hi.x || lo.y >= hi.y || lo.z >= hi.z;
+    }
+
+    static bool BlockInside(const glm::ivec3& base, const glm::ivec3& lo, const glm::ivec3& hi) {
+        return base.x >= lo.x && base.y >= lo.y && base.z >= lo.z &&
+               base.x + 4 <= hi.x && base.y + 4 <= hi.y && base.z + 4 <= hi.z;
+    }
+
+    /**
+     * @brief Visits every 4^3 block overlapping [lo, hi) (already clipped).
+     * @details fn(bx, by, bz, base, isFull), isFull = block lies entirely inside the range.
+     */
+    template<typename Fn>
+    static void ForEachBlockInRange(const glm::ivec3& lo, const glm::ivec3& hi, const Fn& fn) {
+        glm::ivec3 blo = lo >> 2;
+        glm::ivec3 bhi = (hi + 3) >> 2;
+        for (int bz = blo.z; bz < bhi.z; ++bz) {
+            for (int by = blo.y; by < bhi.y; ++by) {
+                for (int bx = blo.x; bx < bhi.x; ++bx) {
+                    glm::ivec3 base(bx * 4, by * 4, bz * 4);
+                    fn((uint32_t)bx, (uint32_t)by, (uint32_t)bz, base, BlockInside(base, lo, hi));
+                }
+            }
+        }
+    }
+
+    // --- Statistics Helpers ---
+
+    // Sum of set bit positions of a row: each bit plane of the index contributes popcount * 2^k.
+    static uint32_t SumBitPositions(uint64_t m) {
+        return (uint32_t)std::popcount(m & 0xAAAAAAAAAAAAAAAAull) +
+               ((uint32_t)std::popcount(m & 0xCCCCCCCCCCCCCCCCull) << 1) +
+               ((uint32_t)std::popcount(m & 0xF0F0F0F0F0F0F0F0ull) << 2) +
+               ((uint32_t)std::popcount(m & 0xFF00FF00FF00FF00ull) << 3) +
+               ((uint32_t)std::popcount(m & 0xFFFF0000FFFF0000ull) << 4) +
+               ((uint32_t)std::popcount(m & 0xFFFFFFFF00000000ull) << 5);
+    }
+
+    struct SolidSums {
+        uint32_t count = 0;
+        glm::uvec3 positionSum{0u};
+    };
+
+    // Count and coordinate sums of solid voxels in [lo, hi) (already clipped), from occupancy rows only.
+    static SolidSums SumSolidInBox(const OccupancyMask& occupancy, const glm::ivec3& lo, const glm::ivec3& hi) {
+        const int width = hi.x - lo.x;
+        const OccupancyRow xMask = (width == (int)(sizeof(OccupancyRow) * 8)) ? ~OccupancyRow(0) : (((OccupancyRow(1) << width) - 1) << lo.x);
+
+        SolidSums sums;
+        for (int z = lo.z; z < hi.z; ++z) {
+            for (int y = lo.y; y < hi.y; ++y) {
+                OccupancyRow row = occupancy.rows[OccupancyMask::RowIndex(y, z)] & xMask;
+                if (row == 0) continue;
+                uint32_t n = (uint32_t)std::popcount(row);
+                sums.count += n;
+                sums.positionSum += glm::uvec3(SumBitPositions(row), n * (uint32_t)y, n * (uint32_t)z);
+            }
+        }
+        return sums;
+    }
+
+    // Adds delta (1 or uint32_t(-1)) to counts[id] for every voxel in [lo, hi), skipping empty blocks.
+    static void AccumulateMaterials(const Chunk& chunk, const glm::ivec3& lo, const glm::ivec3& hi, uint32_t delta, std::array<uint32_t, 256>& counts) {
+        ForEachBlockInRange(lo, hi, [&](uint32_t bx, uint32_t by, uint32_t bz, const glm::ivec3& base, bool full) {
+            uint32_t hBit = HierarchyBit(bx, by, bz);
+            if ((chunk.hierarchy[hBit >> 5] & (1u << (hBit & 31))) == 0) return;
+
+            if (ActiveLayout::BLOCK_CONTIGUOUS && full) {
+                const uint32_t* words = chunk.voxelIDs + ActiveLayout::BlockIndex(bx, by, bz) * BLOCK_WORDS;
+                for (uint32_t w = 0; w < BLOCK_WORDS; ++w) {
+                    uint32_t word = words[w];
+                    if (word == 0) continue;
+                    for (uint32_t b = 0; b < 4; ++b) counts[(word >> (b * 8)) & 0xFF] += delta;
+                }
+                return;
+            }
+
+            glm::ivec3 s = glm::max(base, lo), e = glm::min(base + 4, hi);
+            for (int z = s.z; z < e.z; ++z)
+                for (int y = s.y; y < e.y; ++y)
+                    for (int x = s.x; x < e.x; ++x)
+                        counts[chunk.ReadRaw(Chunk::VoxelIndex(x, y, z))] += delta;
+        });
+        counts[0] = 0;
+    }
+
+    // Adds (after a write) or removes (before a write) the contents of [lo, hi) to the chunk's stats.
+    // Needs an exact hierarchy and occupancy. Bounds are only invalidated, GetStats recomputes them.
+    static void ApplyRegionStats(Chunk& chunk, const glm::ivec3& lo, const glm::ivec3& hi, bool add) {
+        ChunkStats& stats = chunk.stats;
+        SolidSums sums = SumSolidInBox(chunk.occupancy, lo, hi);
+        if (sums.count == 0) return;
+
+        if (add) {
+            stats.solidCount += sums.count;
+            stats.positionSum += sums.positionSum;
+        } else {
+            stats.solidCount -= sums.count;
+            stats.positionSum -= sums.positionSum;
+        }
+        AccumulateMaterials(chunk, lo, hi, add ? 1u : ~0u, stats.materialCounts);
+
+        if (stats.solidCount == 0) {
+            stats.boundsMin = stats.boundsMax = glm::ivec3(0);
+            stats.boundsDirty = false;
+        } else {
+            stats.boundsDirty = true;
+        }
+    }
+
+    // --- Region API ---
+
+    void Chunk::FillBox(const glm::ivec3& min, const glm::ivec3& max, uint8_t id) {
+        glm::ivec3 lo = ClampToChunk(min), hi = ClampToChunk(max);
+        if (IsEmptyRange(lo, hi)) return;
+
+        const uint32_t pattern = static_cast<uint32_t>(id) * 0x01010101u;
+
+        ApplyRegionStats(*this, lo, hi, false);
+        MarkBoxDirty(lo, hi);
+
+        ForEachBlockInRange(lo, hi, [&](uint32_t bx, uint32_t by, uint32_t bz, const glm::ivec3& base, bool full) {
+            if (ActiveLayout::BLOCK_CONTIGUOUS && full) {
+                uint32_t* words = voxelIDs + ActiveLayout::BlockIndex(bx, by, bz) * BLOCK_WORDS;
+                for (uint32_t i = 0; i < BLOCK_WORDS; ++i) words[i] = pattern;
+                return;
+            }
+
+            glm::ivec3 s = glm::max(base, lo), e = glm::min(base + 4, hi);
+            for (int z = s.z; z < e.z; ++z)
+                for (int y = s.y; y < e.y; ++y)
+                    for (int x = s.x; x < e.x; ++x)
+                        WriteRaw(VoxelIndex(x, y, z), id);
+        });
+
+        RebuildHierarchy();
+        RebuildOccupancy();
+
+        // The new contents are known analytically: the whole box is `id`.
+        if (id != 0) {
+            glm::uvec3 n(hi - lo);
+            uint32_t count = n.x * n.y * n.z;
+            // Per axis: sum of lo..hi-1 (n * (lo + hi - 1) / 2, always even), times the other two extents.
+            glm::uvec3 axisSum = n * glm::uvec3(lo + hi - 1) / 2u;
+            stats.positionSum += glm::uvec3(axisSum.x * n.y * n.z, axisSum.y * n.x * n.z, axisSum.z * n.x * n.y);
+            stats.materialCounts[id] += count;
+
+            if (stats.solidCount == 0) {
+                stats.boundsMin = lo;
+                stats.boundsMax = hi;
+                stats.boundsDirty = false;
+            } else {
+                stats.boundsMin = glm::min(stats.boundsMin, lo);
+                stats.boundsMax = glm::max(stats.boundsMax, hi);
+            }
+            stats.solidCount += count;
+        }
+    }
+
+    void Chunk::CopyRegion(const Chunk& src, const glm::ivec3& srcMin, const glm::ivec3& dstMin, const glm::ivec3& size, bool skipEmpty) {
+        // Clip against both chunks, expressed in destination space.
+        glm::ivec3 offset = srcMin - dstMin; // dst + offset = src
+        glm::ivec3 lo = glm::max(ClampToChunk(dstMin), glm::max(-offset, glm::ivec3(0)));
+        glm::ivec3 hi = glm::min(ClampToChunk(dstMin + size), glm::min(glm::ivec3(CHUNK_SIZE) - offset, glm::ivec3(CHUNK_SIZE)));
+        if (IsEmptyRange(lo, hi)) return;
+
+        // Whole blocks can be copied as 64-byte runs when source and destination share block alignment.
+        bool alignedBlocks = ActiveLayout::BLOCK_CONTIGUOUS && !skipEmpty && (offset.x & 3) == 0 && (offset.y & 3) == 0 && (offset.z & 3) == 0;
+
+        ApplyRegionStats(*this, lo, hi, false);
+        MarkBoxDirty(lo, hi);
+
+        ForEachBlockInRange(lo, hi, [&](uint32_t bx, uint32_t by, uint32_t bz, const glm::ivec3& base, bool full) {
+            if (alignedBlocks && full) {
+                glm::ivec3 srcBlock = (base + offset) >> 2;
+                std::memcpy(voxelIDs + ActiveLayout::BlockIndex(bx, by, bz) * BLOCK_WORDS,
+                            src.voxelIDs + ActiveLayout::BlockIndex(srcBlock.x, srcBlock.y, srcBlock.z) * BLOCK_WORDS,
+                            BLOCK_WORDS * sizeof(uint32_t));
+                return;
+            }
+
+            glm::ivec3 s = glm::max(base, lo), e = glm::min(base + 4, hi);
+            for (int z = s.z; z < e.z; ++z) {
+                for (int y = s.y; y < e.y; ++y) {
+                    for (int x = s.x; x < e.x; ++x) {
+                        uint8_t id = src.ReadRaw(VoxelIndex(x + offset.x, y + offset.y, z + offset.z));
+                        if (skipEmpty && id == 0) continue;
+                        WriteRaw(VoxelIndex(x, y, z), id);
+                    }
+                }
+            }
+        });
+
+        RebuildHierarchy();
+        RebuildOccupancy();
+        ApplyRegionStats(*this, lo, hi, true);
+    }
+
+    void Chunk::WriteLinear(std::span<const uint8_t> data, const glm::ivec3& min, const glm::ivec3& size) {
+        if (size.x <= 0 || size.y <= 0 || size.z <= 0) return;
+        if (data.size() < (size_t)size.x * size.y * size.z) return;
+
+        if (min == glm::ivec3(0) && size == glm::ivec3(CHUNK_SIZE)) {
+            ChunkTranscoder::LinearToStorage(data.first<CHUNK_VOXELS>(), voxelIDs);
+            dirtyBlocks.SetAll();
+            RebuildHierarchy();
+            RebuildOccupancy();
+            RebuildStats();
+            return;
+        }
+
+        glm::ivec3 lo = ClampToChunk(min), hi = ClampToChunk(min + size);
+        if (IsEmptyRange(lo, hi)) return;
+
+        ApplyRegionStats(*this, lo, hi, false);
+        MarkBoxDirty(lo, hi);
+
+        const size_t strideY = (size_t)size.x;
+        const size_t strideZ = (size_t)size.x * size.y;
+        auto srcIndex = [&](int x, int y, int z) {
+            return (size_t)(x - min.x) + (size_t)(y - min.y) * strideY + (size_t)(z - min.z) * strideZ;
+        };
+
+        ForEachBlockInRange(lo, hi, [&](uint32_t bx, uint32_t by, uint32_t bz, const glm::ivec3& base, bool full) {
+            if (ActiveLayout::BLOCK_CONTIGUOUS && full) {
+                // Gather the block in storage order and store it as 16 whole words.
+                uint32_t* words = voxelIDs + ActiveLayout::BlockIndex(bx, by, bz) * BLOCK_WORDS;
+                for (uint32_t w = 0; w < BLOCK_WORDS; ++w) {
+                    uint32_t packed = 0;
+                    for (uint32_t b = 0; b < 4; ++b) {
+                        uint8_t c = s_BlockTables.localToCoord[w * 4 + b];
+                        uint8_t id = data[srcIndex(base.x + (c & 3), base.y + ((c >> 2) & 3), base.z + (c >> 4))];
+                        packed |= static_cast<uint32_t>(id) << (b * 8);
+                    }
+                    words[w] = packed;
+                }
+                return;
+            }
+
+            glm::ivec3 s = glm::max(base, lo), e = glm::min(base + 4, hi);
+            for (int z = s.z; z < e.z; ++z)
+                for (int y = s.y; y < e.y; ++y)
+                    for (int x = s.x; x < e.x; ++x)
+                        WriteRaw(VoxelIndex(x, y, z), data[srcIndex(x, y, z)]);
+        });
+
+        RebuildHierarchy();
+        RebuildOccupancy();
+        ApplyRegionStats(*this, lo, hi, true);
+    }
+
+    void Chunk::ReadLinear(std::span<uint8_t, CHUNK_VOXELS> out) const {
+        ChunkTranscoder::StorageToLinear(voxelIDs, out);
+    }
+
+    void Chunk::ApplyMask(std::span<const OccupancyRow, CHUNK_AREA> rows, uint8_t id) {
+        const uint32_t pattern = static_cast<uint32_t>(id) * 0x01010101u;
+
+        for (uint32_t bz = 0; bz < CHUNK_BLOCKS; ++bz) {
+            for (uint32_t by = 0; by < CHUNK_BLOCKS; ++by) {
+                for (uint32_t bx = 0; bx < CHUNK_BLOCKS; ++bx) {
+                    // Gather the block's 64 mask bits (bit = lx + ly * 4 + lz * 16).
+                    uint64_t blockMask = 0;
+                    for (uint32_t lz = 0; lz < 4; ++lz) {
+                        for (uint32_t ly = 0; ly < 4; ++ly) {
+                            uint64_t nibble = (rows[(bz * 4 + lz) * CHUNK_SIZE + by * 4 + ly] >> (bx * 4)) & 0xFu;
+                            blockMask |= nibble << (ly * 4 + lz * 16);
+                        }
+                    }
+                    if (blockMask == 0) continue;
+                    dirtyBlocks.Set(HierarchyBit(bx, by, bz));
+
+                    if (ActiveLayout::BLOCK_CONTIGUOUS && blockMask == ~0ull) {
+                        uint32_t* words = voxelIDs + ActiveLayout::BlockIndex(bx, by, bz) * BLOCK_WORDS;
+                        for (uint32_t i = 0; i < BLOCK_WORDS; ++i) words[i] = pattern;
+                        continue;
+                    }
+
+                    while (blockMask) {
+                        uint32_t bit = (uint32_t)std::countr_zero(blockMask);
+                        blockMask &= blockMask - 1;
+                        WriteRaw(VoxelIndex(bx * 4 + (bit & 3), by * 4 + ((bit >> 2) & 3), bz * 4 + (bit >> 4)), id);
+                    }
+                }
+            }
+        }
+
+        RebuildHierarchy();
+        RebuildOccupancy();
+        RebuildStats();
+    }
+
+    uint32_t Chunk::CountSolidInBox(const glm::ivec3& min, const glm::ivec3& max, glm::vec3* centerSum) const {
+        glm::ivec3 lo = ClampToChunk(min), hi = ClampToChunk(max);
+        if (IsEmptyRange(lo, hi)) return 0;
+
+        SolidSums sums = SumSolidInBox(occupancy, lo, hi);
+        if (centerSum) *centerSum = glm::vec3(sums.positionSum) + 0.5f * (float)sums.count;
+        return sums.count;
+    }
+
+    const ChunkStats& Chunk::GetStats() {
+        if (!stats.boundsDirty) return stats;
+
+        // Y/Z extents from non-empty rows, X extent from the OR of all rows.
+        OccupancyRow columns = 0;
+        glm::ivec3 lo(CHUNK_SIZE), hi(0);
+        for (int z = 0; z < CHUNK_SIZE; ++z) {
+            for (int y = 0; y < CHUNK_SIZE; ++y) {
+                OccupancyRow row = occupancy.rows[OccupancyMask::RowIndex(y, z)];
+                if (row == 0) continue;
+                columns |= row;
+                lo.y = std::min(lo.y, y); hi.y = std::max(hi.y, y + 1);
+                lo.z = std::min(lo.z, z); hi.z = std::max(hi.z, z + 1);
+            }
+        }
+
+        if (columns == 0) {
+            stats.boundsMin = stats.boundsMax = glm::ivec3(0);
+        } else {
+            lo.x = std::countr_zero(columns);
+            hi.x = std::bit_width(columns);
+            stats.boundsMin = lo;
+            stats.boundsMax = hi;
+        }
+        stats.boundsDirty = false;
+        return stats;
+    }
+
+    void Chunk::RebuildStats() {
+        stats.Clear();
+        ApplyRegionStats(*this, glm::ivec3(0), glm::ivec3(CHUNK_SIZE), true);
+    }
+
+    void Chunk::MarkBoxDirty(const glm::ivec3& min, const glm::ivec3& max) {
+        glm::ivec3 lo = ClampToChunk(min), hi = ClampToChunk(max);
+        if (IsEmptyRange(lo, hi)) return;
+
+        ForEachBlockInRange(lo, hi, [&](uint32_t bx, uint32_t by, uint32_t bz, const glm::ivec3&, bool) {
+            dirtyBlocks.Set(HierarchyBit(bx, by, bz));
+        });
+    }
+
+    void Chunk::CollectDirtyRanges(std::vector<ChunkByteRange>& out) const {
+        if (!dirtyBlocks.Any()) return;
+
+        // Ranges are emitted in ascending offset order, so merging only ever looks at the last one of this chunk.
+        const size_t first = out.size();
+        auto append = [&](uint32_t offset, uint32_t size) {
+            if (out.size() > first && out.back().offset + out.back().size == offset) out.back().size += size;
+            else out.push_back({offset, size});
+        };
+
+        if constexpr (ActiveLayout::BLOCK_CONTIGUOUS) {
+            // Walk storage order, not hierarchy order (they differ in Morton layout).
+            for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block) {
+                if (dirtyBlocks.Test(s_BlockTables.blockToHierarchyBit[block])) {
+                    append(block * BLOCK_WORDS * sizeof(uint32_t), BLOCK_WORDS * sizeof(uint32_t));
+                }
+            }
+        } else {
+            // Linear layout: each voxel row of a block is one word, rows of a block are CHUNK_SIZE / 4 words apart.
+            for (uint32_t bz = 0; bz < CHUNK_BLOCKS; ++bz) {
+                for (uint32_t by = 0; by < CHUNK_BLOCKS; ++by) {
+                    uint32_t rowBit = HierarchyBit(0, by, bz);
+                    bool anyInRow = false;
+                    for (uint32_t bx = 0; bx < CHUNK_BLOCKS; ++bx) anyInRow |= dirtyBlocks.Test(rowBit + bx);
+                    if (!anyInRow) continue;
+
+                    for (uint32_t lz = 0; lz < 4; ++lz) {
+                        for (uint32_t ly = 0; ly < 4; ++ly) {
+                            uint32_t rowWord = ((bz * 4 + lz) * CHUNK_AREA + (by * 4 + ly) * CHUNK_SIZE) / 4;
+                            for (uint32_t bx = 0; bx < CHUNK_BLOCKS; ++bx) {
+                                if (dirtyBlocks.Test(rowBit + bx)) append((rowWord + bx) * sizeof(uint32_t), sizeof(uint32_t));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        append((uint32_t)(sizeof(voxelIDs) + sizeof(voxelFlags)), (uint32_t)sizeof(hierarchy));
+    }
+
+    void Chunk::RebuildHierarchy() {
+        std::memset(hierarchy, 0, sizeof(hierarchy));
+
+        if constexpr (ActiveLayout::BLOCK_CONTIGUOUS) {
+            // OR-reduce each block's 16 contiguous words; written branch-free so the inner loop vectorizes.
+            for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block) {
+                const uint32_t* words = voxelIDs + block * BLOCK_WORDS;
+                uint32_t any = 0;
+                for (uint32_t i = 0; i < BLOCK_WORDS; ++i) any |= words[i];
+
+                uint32_t hBit = s_BlockTables.blockToHierarchyBit[block];
+                hierarchy[hBit >> 5] |= (any != 0 ? 1u : 0u) << (hBit & 31);
+            }
+        } else {
+            // Linear layout: a word holds 4 voxels along X of one row, i.e. exactly one block row.
+            for (uint32_t z = 0; z < CHUNK_SIZE; ++z) {
+                for (uint32_t y = 0; y < CHUNK_SIZE; ++y) {
+                    for (uint32_t wx = 0; wx < CHUNK_BLOCKS; ++wx) {
+                        if (voxelIDs[(z * CHUNK_AREA + y * CHUNK_SIZE) / 4 + wx] == 0) continue;
+                        uint32_t hBit = HierarchyBit(wx, y >> 2, z >> 2);
+                        hierarchy[hBit >> 5] |= 1u << (hBit & 31);
+                    }
+                }
+            }
+        }
+    }
+
+    void Chunk::RebuildOccupancy() {
+        occupancy.Clear();
+
+        // Gather each occupied block into a 64-bit mask (bit = lx + ly * 4 + lz * 16), then scatter nibbles into rows.
+        ForEachSolidBlock([&](int bx, int by, int bz) {
+            uint64_t blockMask = 0;
+            if constexpr (ActiveLayout::BLOCK_CONTIGUOUS) {
+                const uint32_t* words = voxelIDs + ActiveLayout::BlockIndex((uint32_t)bx, (uint32_t)by, (uint32_t)bz) * BLOCK_WORDS;
+                for (uint32_t w = 0; w < BLOCK_WORDS; ++w) {
+                    uint32_t word = words[w];
+                    if (word == 0) continue;
+                    for (uint32_t b = 0; b < 4; ++b) {
+                        if (((word >> (b * 8)) & 0xFF) != 0) blockMask |= 1ull << s_BlockTables.localToCoord[w * 4 + b];
+                    }
+                }
+            } else {
+                for (uint32_t l = 0; l < 64; ++l) {
+                    if (ReadRaw(VoxelIndex(bx * 4 + (l & 3), by * 4 + ((l >> 2) & 3), bz * 4 + (l >> 4))) != 0) blockMask |= 1ull << l;
+                }
+            }
+
+            for (uint32_t lz = 0; lz < 4; ++lz) {
+                for (uint32_t ly = 0; ly < 4; ++ly) {
+                    uint32_t nibble = (uint32_t)(blockMask >> (ly * 4 + lz * 16)) & 0xFu;
+                    occupancy.rows[OccupancyMask::RowIndex(by * 4 + ly, bz * 4 + lz)] |= (OccupancyRow)nibble << (bx * 4);
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,234 @@
+module;
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define VORTEX_PALETTE_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #define VORTEX_TARGET(features)
+    #else
+        #define VORTEX_TARGET(features) __attribute__((target(features)))
+    #endif
+#endif
+
+module vortex.voxel;
+
+import :config;
+import :chunk;
+import :compressed;
+import :transcode;
+
+namespace vortex::voxel {
+
+    static uint32_t BitsPerIndex(CompressedChunk::Encoding encoding) {
+        switch (encoding) {
+            case CompressedChunk::Encoding::Palette1: return 1;
+            case CompressedChunk::Encoding::Palette2: return 2;
+            case CompressedChunk::Encoding::Palette4: return 4;
+            default: return 0;
+        }
+    }
+
+#if defined(VORTEX_PALETTE_X86)
+
+    // --- SSSE3 Palette Expansion ---
+    // Packed indices are split in halves (4 -> 2 -> 1 bit) with byte unpacks, which keeps them in voxel order,
+    // until each byte holds one index; pshufb then maps 16 indices to IDs through the palette register.
+
+    template<int BITS>
+    VORTEX_TARGET("ssse3,sse4.1")
+    static inline void SplitIndices(__m128i v, __m128i& first, __m128i& second) {
+        const __m128i mask = _mm_set1_epi8((char)((1 << BITS) - 1));
+        __m128i lo = _mm_and_si128(v, mask);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, BITS), mask);
+        first = _mm_unpacklo_epi8(lo, hi);
+        second = _mm_unpackhi_epi8(lo, hi);
+    }
+
+    template<int BITS_PER_INDEX>
+    VORTEX_TARGET("ssse3,sse4.1")
+    static void ExpandPaletteSSE(const uint32_t* src, size_t srcWords, const uint8_t* palette, uint32_t* dst) {
+        const __m128i table = _mm_loadu_si128((const __m128i*)palette);
+        const uint8_t* in = (const uint8_t*)src;
+        const uint8_t* end = in + srcWords * sizeof(uint32_t);
+        __m128i* out = (__m128i*)dst;
+
+        for (; in < end; in += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)in);
+            __m128i n[2];
+            SplitIndices<4>(v, n[0], n[1]);
+
+            if constexpr (BITS_PER_INDEX == 4) {
+                for (int i = 0; i < 2; ++i) _mm_storeu_si128(out++, _mm_shuffle_epi8(table, n[i]));
+            } else {
+                __m128i q[4];
+                for (int i = 0; i < 2; ++i) SplitIndices<2>(n[i], q[i * 2], q[i * 2 + 1]);
+
+                if constexpr (BITS_PER_INDEX == 2) {
+                    for (int i = 0; i < 4; ++i) _mm_storeu_si128(out++, _mm_shuffle_epi8(table, q[i]));
+                } else {
+                    for (int i = 0; i < 4; ++i) {
+                        __m128i b0, b1;
+                        SplitIndices<1>(q[i], b0, b1);
+                        _mm_storeu_si128(out++, _mm_shuffle_epi8(table, b0));
+                        _mm_storeu_si128(out++, _mm_shuffle_epi8(table, b1));
+                    }
+                }
+            }
+        }
+    }
+
+#endif
+
+    CompressedChunk CompressedChunk::Compress(const Chunk& chunk) {
+        CompressedChunk result;
+        std::memcpy(result.m_Hierarchy, chunk.hierarchy, sizeof(result.m_Hierarchy));
+
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(chunk.voxelIDs);
+
+        // --- Collect distinct IDs ---
+        // From the voxel bytes rather than chunk.stats: stats are public and may be stale, and an ID missing from
+        // the palette would silently turn into palette entry 0.
+        uint32_t seen[8] = {};
+        for (uint32_t i = 0; i < CHUNK_VOXELS; ++i) seen[bytes[i] >> 5] |= 1u << (bytes[i] & 31);
+
+        uint32_t distinct = 0;
+        for (uint32_t w = 0; w < 8; ++w) distinct += (uint32_t)std::popcount(seen[w]);
+
+        if (distinct > 16) {
+            result.m_Encoding = Encoding::Raw;
+            result.m_PaletteSize = 0;
+            result.m_Data.assign(chunk.voxelIDs, chunk.voxelIDs + CHUNK_WORDS);
+            return result;
+        }
+
+        uint8_t toIndex[256] = {};
+        uint32_t count = 0;
+        for (uint32_t w = 0; w < 8; ++w) {
+            uint32_t bits = seen[w];
+            while (bits) {
+                uint8_t id = (uint8_t)(w * 32 + (uint32_t)std::countr_zero(bits));
+                bits &= bits - 1;
+                toIndex[id] = (uint8_t)count;
+                result.m_Palette[count++] = id;
+            }
+        }
+        result.m_PaletteSize = (uint8_t)count;
+
+        if (count == 1) {
+            result.m_Encoding = Encoding::Uniform;
+            return result;
+        }
+
+        result.m_Encoding = count <= 2 ? Encoding::Palette1 : (count <= 4 ? Encoding::Palette2 : Encoding::Palette4);
+
+        // --- Pack indices in storage order ---
+        const uint32_t bitsPerIndex = BitsPerIndex(result.m_Encoding);
+        const uint32_t perWord = 32 / bitsPerIndex;
+        result.m_Data.assign(CHUNK_VOXELS / perWord, 0);
+
+        for (uint32_t i = 0; i < CHUNK_VOXELS; ++i) {
+            result.m_Data[i / perWord] |= (uint32_t)toIndex[bytes[i]] << ((i % perWord) * bitsPerIndex);
+        }
+        return result;
+    }
+
+    void CompressedChunk::DecodeVoxelIDs(std::span<uint32_t, CHUNK_WORDS> out) const {
+        // Locals, so stores to dst cannot be assumed to alias the vector's pointer or size.
+        uint32_t* dst = out.data();
+        const uint32_t* src = m_Data.data();
+        const size_t srcWords = m_Data.size();
+
+        switch (m_Encoding) {
+            case Encoding::Uniform: {
+                const uint32_t pattern = static_cast<uint32_t>(m_Palette[0]) * 0x01010101u;
+                for (uint32_t i = 0; i < CHUNK_WORDS; ++i) dst[i] = pattern;
+                return;
+            }
+            case Encoding::Raw:
+                std::memcpy(dst, src, CHUNK_WORDS * sizeof(uint32_t));
+                return;
+            default:
+                break;
+        }
+
+    #if defined(VORTEX_PALETTE_X86)
+        // Both SIMD transcoder kernels imply SSSE3 / SSE4.1.
+        if (ChunkTranscoder::GetKernel() != TranscodeKernel::Scalar) {
+            switch (m_Encoding) {
+                case Encoding::Palette1: ExpandPaletteSSE<1>(src, srcWords, m_Palette, dst); return;
+                case Encoding::Palette2: ExpandPaletteSSE<2>(src, srcWords, m_Palette, dst); return;
+                case Encoding::Palette4: ExpandPaletteSSE<4>(src, srcWords, m_Palette, dst); return;
+                default: break;
+            }
+        }
+    #endif
+
+        switch (m_Encoding) {
+            // Each case expands a group of packed indices to voxel bytes through a small table,
+            // built once per call from the local palette.
+            case Encoding::Palette1: {
+                // 4 indices (a nibble) -> 1 output word.
+                uint32_t table[16];
+                for (uint32_t n = 0; n < 16; ++n) {
+                    table[n] = 0;
+                    for (uint32_t k = 0; k < 4; ++k) table[n] |= (uint32_t)m_Palette[(n >> k) & 1] << (k * 8);
+                }
+                for (size_t d = 0; d < srcWords; ++d) {
+                    uint32_t packed = src[d];
+                    for (uint32_t k = 0; k < 8; ++k) dst[d * 8 + k] = table[(packed >> (k * 4)) & 0xF];
+                }
+                return;
+            }
+            case Encoding::Palette2: {
+                // 4 indices (a byte) -> 1 output word.
+                uint32_t table[256];
+                for (uint32_t b = 0; b < 256; ++b) {
+                    table[b] = 0;
+                    for (uint32_t k = 0; k < 4; ++k) table[b] |= (uint32_t)m_Palette[(b >> (k * 2)) & 3] << (k * 8);
+                }
+                for (size_t d = 0; d < srcWords; ++d) {
+                    uint32_t packed = src[d];
+                    for (uint32_t k = 0; k < 4; ++k) dst[d * 4 + k] = table[(packed >> (k * 8)) & 0xFF];
+                }
+                return;
+            }
+            case Encoding::Palette4: {
+                // 2 indices (a byte) -> half an output word.
+                uint16_t table[256];
+                for (uint32_t b = 0; b < 256; ++b) {
+                    table[b] = (uint16_t)(m_Palette[b & 0xF] | (m_Palette[b >> 4] << 8));
+                }
+                for (size_t d = 0; d < srcWords; ++d) {
+                    uint32_t packed = src[d];
+                    dst[d * 2]     = table[packed & 0xFF] | ((uint32_t)table[(packed >> 8) & 0xFF] << 16);
+                    dst[d * 2 + 1] = table[(packed >> 16) & 0xFF] | ((uint32_t)table[packed >> 24] << 16);
+                }
+                return;
+            }
+            default:
+                return;
+        }
+    }
+
+    void CompressedChunk::Decompress(Chunk& out) const {
+        DecodeVoxelIDs(out.voxelIDs);
+        std::memset(out.voxelFlags, 0, sizeof(out.voxelFlags));
+        std::memcpy(out.hierarchy, m_Hierarchy, sizeof(m_Hierarchy));
+        out.RebuildOccupancy();
+        out.RebuildStats();
+        out.dirtyBlocks.SetAll();
+    }
+
+    void CompressedChunk::WriteGPU(void* dst) const {
+        uint8_t* bytes = static_cast<uint8_t*>(dst);
+        DecodeVoxelIDs(std::span<uint32_t, CHUNK_WORDS>(reinterpret_cast<uint32_t*>(bytes), CHUNK_WORDS));
+        std::memset(bytes + sizeof(Chunk::voxelIDs), 0, sizeof(Chunk::voxelFlags));
+        std::memcpy(bytes + sizeof(Chunk::voxelIDs) + sizeof(Chunk::voxelFlags), m_Hierarchy, sizeof(m_Hierarchy));
+    }
+}
@@ -15,6 +15,7 @@ module vortex.voxel;
 
 import :destruction;
 import :entity;
+import :config;
 import :chunk;
 import :object;
 import :palette;
@@ -54,18 +55,11 @@ namespace vortex::voxel {
             if (!part->chunk) continue;
             
             glm::ivec3 offset = glm::ivec3(part->position);
-            for (int z = 0; z < 32; ++z) {
-                for (int y = 0; y < 32; ++y) {
-                    for (int x = 0; x < 32; ++x) {
-                        uint8_t mat = part->chunk->GetVoxel(x, y, z);
-                        if (mat != 0) {
-                            glm::ivec3 localPos = offset + glm::ivec3(x, y, z);
-                            unvisited.insert(localPos);
-                            voxelData[localPos] = mat;
-                        }
-                    }
-                }
-            }
+            part->chunk->ForEachSolidVoxel([&](int x, int y, int z, uint8_t mat) {
+                glm::ivec3 localPos = offset + glm::ivec3(x, y, z);
+                unvisited.insert(localPos);
+                voxelData[localPos] = mat;
+            });
         }
 
         while (!unvisited.empty()) {
@@ -132,20 +126,23 @@ namespace vortex::voxel {
             // Move the part position to the bottom-left of the island
             part->position = glm::vec3(minB);
 
+            // Scatter into a dense buffer first and hand the chunk a single bulk write.
+            std::vector<uint8_t> dense(CHUNK_VOXELS, 0);
             for (size_t v = 0; v < island.voxelPositions.size(); ++v) {
                 glm::ivec3 relativePos = island.voxelPositions[v] - minB;
-                // Bounds check logic: if island is > 32 voxels, this will clip.
+                // Bounds check logic: if island is > CHUNK_SIZE voxels, this will clip.
                 // TODO: Support multi-chunk entities in future.
-                if (relativePos.x >= 0 && relativePos.x < 32 && 
-                    relativePos.y >= 0 && relativePos.y < 32 && 
-                    relativePos.z >= 0 && relativePos.z < 32) 
+                if (relativePos.x >= 0 && relativePos.x < (int)CHUNK_SIZE && 
+                    relativePos.y >= 0 && relativePos.y < (int)CHUNK_SIZE && 
+                    relativePos.z >= 0 && relativePos.z < (int)CHUNK_SIZE) 
                 {
-                    part->chunk->SetVoxel(relativePos.x, relativePos.y, relativePos.z, island.materialIDs[v]);
+                    dense[relativePos.x + relativePos.y * CHUNK_SIZE + relativePos.z * CHUNK_AREA] = island.materialIDs[v];
                 } else {
                     // Log warning if voxel is lost due to single-chunk limit
                     // Log::Warn("Voxel clipped during split! Island too big for single chunk.");
                 }
             }
+            part->chunk->WriteLinear(dense, glm::ivec3(0), glm::ivec3(CHUNK_SIZE));
 
             newFrag->parts.push_back(part);
             newFrag->RecalculateStats();
@@ -164,28 +161,21 @@ namespace vortex::voxel {
         for (const auto& part : entity->parts) {
             if (!part->chunk) continue;
             glm::ivec3 offset = glm::ivec3(part->position);
-            for (int z = 0; z < 32; ++z) {
-                for (int y = 0; y < 32; ++y) {
-                    for (int x = 0; x < 32; ++x) {
-                        uint8_t matID = part->chunk->GetVoxel(x, y, z);
-                        if (matID != 0) {
-                            glm::ivec3 localPos = offset + glm::ivec3(x, y, z);
-                            VoxelNode node;
-                            node.pos = localPos;
-                            node.materialID = matID;
-                            node.distanceToAnchor = -1;
-                            node.currentLoad = 0.0f;
-                            
-                            nodes[localPos] = node;
-
-                            glm::vec3 worldPos = glm::vec3(entity->transform * glm::vec4(localPos, 1.0f));
-                            if (CheckAnchoring(worldPos)) {
-                                anchors.push_back(localPos);
-                            }
-                        }
-                    }
+            part->chunk->ForEachSolidVoxel([&](int x, int y, int z, uint8_t matID) {
+                glm::ivec3 localPos = offset + glm::ivec3(x, y, z);
+                VoxelNode node;
+                node.pos = localPos;
+                node.materialID = matID;
+                node.distanceToAnchor = -1;
+                node.currentLoad = 0.0f;
+                
+                nodes[localPos] = node;
+
+                glm::vec3 worldPos = glm::vec3(entity->transform * glm::vec4(localPos, 1.0f));
+                if (CheckAnchoring(worldPos)) {
+                    anchors.push_back(localPos);
                 }
-            }
+            });
         }
 
         if (anchors.empty()) return false; 
@@ -251,9 +241,9 @@ namespace vortex::voxel {
                     for (auto& part : entity->parts) {
                          glm::ivec3 offset = glm::ivec3(part->position);
                          glm::ivec3 localInPart = pos - offset;
-                         if (localInPart.x >= 0 && localInPart.x < 32 &&
-                             localInPart.y >= 0 && localInPart.y < 32 &&
-                             localInPart.z >= 0 && localInPart.z < 32) {
+                         if (localInPart.x >= 0 && localInPart.x < (int)CHUNK_SIZE &&
+                             localInPart.y >= 0 && localInPart.y < (int)CHUNK_SIZE &&
+                             localInPart.z >= 0 && localInPart.z < (int)CHUNK_SIZE) {
                                  part->chunk->SetVoxel(localInPart.x, localInPart.y, localInPart.z, 0); 
                                  hasBrokenVoxels = true;
                                  break;
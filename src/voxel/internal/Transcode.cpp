@@ -0,0 +1,348 @@
+module;
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <atomic>
+#include <span>
+#include <glm/glm.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define VORTEX_TRANSCODE_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define VORTEX_TARGET(features)
+    #else
+        #define VORTEX_TARGET(features) __attribute__((target(features)))
+    #endif
+#endif
+
+module vortex.voxel;
+
+import :config;
+import :chunk;
+import :transcode;
+
+namespace vortex::voxel {
+
+    // --- Block Geometry ---
+    // A 4x4x4 block is 64 contiguous bytes in Morton and Brick layouts. In Morton order the local index l
+    // has bits (x0 y0 z0 x1 y1 z1); in Brick order it is lx + ly * 4 + lz * 16, i.e. already 16 linear rows.
+    // In linear order the same block is 16 row segments of 4 bytes: row (ly, lz) starts at
+    // (bz * 4 + lz) * CHUNK_AREA + (by * 4 + ly) * CHUNK_SIZE + bx * 4.
+
+    static constexpr uint32_t LINEAR_ROW = CHUNK_SIZE;
+    static constexpr uint32_t LINEAR_SLICE = CHUNK_AREA;
+
+    static constexpr std::array<uint16_t, 64> BuildLocalToLinear() {
+        std::array<uint16_t, 64> t{};
+        for (uint32_t lz = 0; lz < 4; ++lz)
+            for (uint32_t ly = 0; ly < 4; ++ly)
+                for (uint32_t lx = 0; lx < 4; ++lx)
+                    t[ActiveLayout::LocalIndex(lx, ly, lz)] = (uint16_t)(lx + ly * LINEAR_ROW + lz * LINEAR_SLICE);
+        return t;
+    }
+
+    // Local storage index -> offset from the block's linear origin.
+    static constexpr std::array<uint16_t, 64> s_LocalToLinear = BuildLocalToLinear();
+
+    static uint32_t BlockOrigin(uint32_t bx, uint32_t by, uint32_t bz) {
+        return bz * 4 * LINEAR_SLICE + by * 4 * LINEAR_ROW + bx * 4;
+    }
+
+    static uint32_t StorageBlockOrigin(uint32_t block) {
+        glm::ivec3 b = ActiveLayout::BlockCoord(block);
+        return BlockOrigin((uint32_t)b.x, (uint32_t)b.y, (uint32_t)b.z);
+    }
+
+    // --- Scalar ---
+
+    static void StorageToLinearScalar(const uint32_t* words, uint8_t* linear) {
+        for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block) {
+            uint8_t* dst = linear + StorageBlockOrigin(block);
+            const uint32_t* src = words + block * 16;
+            for (uint32_t l = 0; l < 64; ++l) {
+                dst[s_LocalToLinear[l]] = (uint8_t)(src[l >> 2] >> ((l & 3) * 8));
+            }
+        }
+    }
+
+    static void LinearToStorageScalar(const uint8_t* linear, uint32_t* words) {
+        for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block) {
+            const uint8_t* src = linear + StorageBlockOrigin(block);
+            uint32_t* dst = words + block * 16;
+            for (uint32_t w = 0; w < 16; ++w) {
+                uint32_t l = w * 4;
+                dst[w] = (uint32_t)src[s_LocalToLinear[l]] |
+                         ((uint32_t)src[s_LocalToLinear[l + 1]] << 8) |
+                         ((uint32_t)src[s_LocalToLinear[l + 2]] << 16) |
+                         ((uint32_t)src[s_LocalToLinear[l + 3]] << 24);
+            }
+        }
+    }
+
+    // --- Brick ---
+    // Bricks are stored row by row, so each block is 16 plain 4-byte copies.
+
+    static void BrickToLinear(const uint32_t* words, uint8_t* linear) {
+        for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block) {
+            uint8_t* dst = linear + StorageBlockOrigin(block);
+            const uint32_t* src = words + block * 16;
+            for (uint32_t row = 0; row < 16; ++row) {
+                std::memcpy(dst + (row >> 2) * LINEAR_SLICE + (row & 3) * LINEAR_ROW, src + row, 4);
+            }
+        }
+    }
+
+    static void LinearToBrick(const uint8_t* linear, uint32_t* words) {
+        for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block) {
+            const uint8_t* src = linear + StorageBlockOrigin(block);
+            uint32_t* dst = words + block * 16;
+            for (uint32_t row = 0; row < 16; ++row) {
+                std::memcpy(dst + row, src + (row >> 2) * LINEAR_SLICE + (row & 3) * LINEAR_ROW, 4);
+            }
+        }
+    }
+
+#if defined(VORTEX_TRANSCODE_X86)
+
+    // --- Shuffle Tables ---
+    // A 16-byte Morton quarter (fixed y1, z1) holds bytes (x0 y0 z0 x1). The forward shuffle reorders it to
+    // [z0 = 0: x0 + 2 x1 + 4 y0 | z0 = 1: ...], so 64-bit unpacks of the y1 = 0 and y1 = 1 quarters
+    // yield two linear layers of 4 rows x 4 bytes (one per z0).
+
+    struct ShuffleTables {
+        alignas(16) uint8_t forward[16];
+        alignas(16) uint8_t inverse[16];
+    };
+
+    static constexpr ShuffleTables BuildShuffleTables() {
+        ShuffleTables t{};
+        for (uint32_t k = 0; k < 16; ++k) {
+            uint32_t z0 = k >> 3, x0 = k & 1, x1 = (k >> 1) & 1, y0 = (k >> 2) & 1;
+            uint32_t src = x0 | (y0 << 1) | (z0 << 2) | (x1 << 3);
+            t.forward[k] = (uint8_t)src;
+            t.inverse[src] = (uint8_t)k;
+        }
+        return t;
+    }
+
+    static constexpr ShuffleTables s_Shuffle = BuildShuffleTables();
+
+    static inline uint32_t LoadRow(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    static inline void StoreRow(uint8_t* p, uint32_t v) {
+        std::memcpy(p, &v, 4);
+    }
+
+    // --- SSE4 ---
+
+    VORTEX_TARGET("ssse3,sse4.1")
+    static inline void StoreLayer(uint8_t* dst, __m128i layer) {
+        StoreRow(dst + 0 * LINEAR_ROW, (uint32_t)_mm_cvtsi128_si32(layer));
+        StoreRow(dst + 1 * LINEAR_ROW, (uint32_t)_mm_extract_epi32(layer, 1));
+        StoreRow(dst + 2 * LINEAR_ROW, (uint32_t)_mm_extract_epi32(layer, 2));
+        StoreRow(dst + 3 * LINEAR_ROW, (uint32_t)_mm_extract_epi32(layer, 3));
+    }
+
+    VORTEX_TARGET("ssse3,sse4.1")
+    static inline __m128i LoadLayer(const uint8_t* src) {
+        return _mm_setr_epi32((int)LoadRow(src), (int)LoadRow(src + LINEAR_ROW),
+                              (int)LoadRow(src + 2 * LINEAR_ROW), (int)LoadRow(src + 3 * LINEAR_ROW));
+    }
+
+    VORTEX_TARGET("ssse3,sse4.1")
+    static void MortonToLinearSSE4(const uint32_t* words, uint8_t* linear) {
+        const __m128i forward = _mm_load_si128((const __m128i*)s_Shuffle.forward);
+        const uint8_t* src = (const uint8_t*)words;
+
+        for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block, src += 64) {
+            uint8_t* dst = linear + BlockOrigin(CompactBits(block), CompactBits(block >> 1), CompactBits(block >> 2));
+            for (uint32_t z1 = 0; z1 < 2; ++z1) {
+                __m128i a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + z1 * 32)), forward);
+                __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + z1 * 32 + 16)), forward);
+                StoreLayer(dst + (z1 * 2) * LINEAR_SLICE, _mm_unpacklo_epi64(a, b));
+                StoreLayer(dst + (z1 * 2 + 1) * LINEAR_SLICE, _mm_unpackhi_epi64(a, b));
+            }
+        }
+    }
+
+    VORTEX_TARGET("ssse3,sse4.1")
+    static void LinearToMortonSSE4(const uint8_t* linear, uint32_t* words) {
+        const __m128i inverse = _mm_load_si128((const __m128i*)s_Shuffle.inverse);
+        uint8_t* dst = (uint8_t*)words;
+
+        for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block, dst += 64) {
+            const uint8_t* src = linear + BlockOrigin(CompactBits(block), CompactBits(block >> 1), CompactBits(block >> 2));
+            for (uint32_t z1 = 0; z1 < 2; ++z1) {
+                __m128i layer0 = LoadLayer(src + (z1 * 2) * LINEAR_SLICE);
+                __m128i layer1 = LoadLayer(src + (z1 * 2 + 1) * LINEAR_SLICE);
+                _mm_storeu_si128((__m128i*)(dst + z1 * 32), _mm_shuffle_epi8(_mm_unpacklo_epi64(layer0, layer1), inverse));
+                _mm_storeu_si128((__m128i*)(dst + z1 * 32 + 16), _mm_shuffle_epi8(_mm_unpackhi_epi64(layer0, layer1), inverse));
+            }
+        }
+    }
+
+    // --- AVX2 ---
+    // One 32-byte load covers both y1 quarters of a z1 half. After an in-lane shuffle the qwords are
+    // [a.z0=0, a.z0=1, b.z0=0, b.z0=1]; permuting them to (0, 2, 1, 3) gives [layer z0=0 | layer z0=1].
+    // The permutation is its own inverse, so the reverse direction uses the same immediate.
+
+    static constexpr int QWORD_INTERLEAVE = 0xD8; // _MM_SHUFFLE(3, 1, 2, 0)
+
+    // Per-axis bit masks of a Morton block index, truncated to the chunk's block count.
+    static constexpr uint32_t MORTON_MASK_X = 0x49249249u & (CHUNK_BLOCK_COUNT - 1);
+    static constexpr uint32_t MORTON_MASK_Y = 0x92492492u & (CHUNK_BLOCK_COUNT - 1);
+    static constexpr uint32_t MORTON_MASK_Z = 0x24924924u & (CHUNK_BLOCK_COUNT - 1);
+
+    VORTEX_TARGET("avx2,bmi2")
+    static inline uint32_t LinearBlockOrigin(uint32_t block) {
+        return BlockOrigin(_pext_u32(block, MORTON_MASK_X), _pext_u32(block, MORTON_MASK_Y), _pext_u32(block, MORTON_MASK_Z));
+    }
+
+    VORTEX_TARGET("avx2,bmi2")
+    static void MortonToLinearAVX2(const uint32_t* words, uint8_t* linear) {
+        const __m256i forward = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)s_Shuffle.forward));
+        const uint8_t* src = (const uint8_t*)words;
+
+        for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block, src += 64) {
+            uint8_t* dst = linear + LinearBlockOrigin(block);
+            for (uint32_t z1 = 0; z1 < 2; ++z1) {
+                __m256i v = _mm256_loadu_si256((const __m256i*)(src + z1 * 32));
+                __m256i layers = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, forward), QWORD_INTERLEAVE);
+
+                uint8_t* out = dst + (z1 * 2) * LINEAR_SLICE;
+                StoreRow(out + 0 * LINEAR_ROW, (uint32_t)_mm256_extract_epi32(layers, 0));
+                StoreRow(out + 1 * LINEAR_ROW, (uint32_t)_mm256_extract_epi32(layers, 1));
+                StoreRow(out + 2 * LINEAR_ROW, (uint32_t)_mm256_extract_epi32(layers, 2));
+                StoreRow(out + 3 * LINEAR_ROW, (uint32_t)_mm256_extract_epi32(layers, 3));
+                out += LINEAR_SLICE;
+                StoreRow(out + 0 * LINEAR_ROW, (uint32_t)_mm256_extract_epi32(layers, 4));
+                StoreRow(out + 1 * LINEAR_ROW, (uint32_t)_mm256_extract_epi32(layers, 5));
+                StoreRow(out + 2 * LINEAR_ROW, (uint32_t)_mm256_extract_epi32(layers, 6));
+                StoreRow(out + 3 * LINEAR_ROW, (uint32_t)_mm256_extract_epi32(layers, 7));
+            }
+        }
+    }
+
+    VORTEX_TARGET("avx2,bmi2")
+    static void LinearToMortonAVX2(const uint8_t* linear, uint32_t* words) {
+        const __m256i inverse = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)s_Shuffle.inverse));
+        uint8_t* dst = (uint8_t*)words;
+
+        for (uint32_t block = 0; block < CHUNK_BLOCK_COUNT; ++block, dst += 64) {
+            const uint8_t* src = linear + LinearBlockOrigin(block);
+            for (uint32_t z1 = 0; z1 < 2; ++z1) {
+                const uint8_t* in = src + (z1 * 2) * LINEAR_SLICE;
+                __m256i layers = _mm256_inserti128_si256(_mm256_castsi128_si256(LoadLayer(in)), LoadLayer(in + LINEAR_SLICE), 1);
+
+                __m256i v = _mm256_shuffle_epi8(_mm256_permute4x64_epi64(layers, QWORD_INTERLEAVE), inverse);
+                _mm256_storeu_si256((__m256i*)(dst + z1 * 32), v);
+            }
+        }
+    }
+
+    // --- CPU Detection ---
+
+    static bool CpuHasSSE4() {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 9)) && (info[2] & (1 << 19)); // SSSE3, SSE4.1
+    #else
+        return __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1");
+    #endif
+    }
+
+    static bool CpuHasAVX2() {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false; // OS saves YMM state
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) && (info[1] & (1 << 8)); // AVX2, BMI2
+    #else
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2");
+    #endif
+    }
+
+#endif
+
+    // --- Dispatch ---
+
+    static TranscodeKernel DetectKernel() {
+    #if defined(VORTEX_TRANSCODE_X86)
+        if (CpuHasAVX2()) return TranscodeKernel::AVX2;
+        if (CpuHasSSE4()) return TranscodeKernel::SSE4;
+    #endif
+        return TranscodeKernel::Scalar;
+    }
+
+    static std::atomic<TranscodeKernel>& ActiveKernel() {
+        static std::atomic<TranscodeKernel> kernel{ DetectKernel() };
+        return kernel;
+    }
+
+    bool ChunkTranscoder::IsSupported(TranscodeKernel kernel) {
+        switch (kernel) {
+            case TranscodeKernel::Scalar: return true;
+    #if defined(VORTEX_TRANSCODE_X86)
+            case TranscodeKernel::SSE4: return CpuHasSSE4();
+            case TranscodeKernel::AVX2: return CpuHasAVX2();
+    #endif
+            default: return false;
+        }
+    }
+
+    TranscodeKernel ChunkTranscoder::GetKernel() {
+        return ActiveKernel().load(std::memory_order_relaxed);
+    }
+
+    void ChunkTranscoder::SetKernel(TranscodeKernel kernel) {
+        ActiveKernel().store(IsSupported(kernel) ? kernel : TranscodeKernel::Scalar, std::memory_order_relaxed);
+    }
+
+    void ChunkTranscoder::StorageToLinear(std::span<const uint32_t, CHUNK_WORDS> voxelIDs, std::span<uint8_t, CHUNK_VOXELS> linear) {
+        if constexpr (CHUNK_LAYOUT == ChunkLayout::Linear) {
+            std::memcpy(linear.data(), voxelIDs.data(), linear.size());
+            return;
+        } else if constexpr (CHUNK_LAYOUT == ChunkLayout::Brick) {
+            BrickToLinear(voxelIDs.data(), linear.data());
+            return;
+        }
+
+        switch (GetKernel()) {
+    #if defined(VORTEX_TRANSCODE_X86)
+            case TranscodeKernel::AVX2: MortonToLinearAVX2(voxelIDs.data(), linear.data()); return;
+            case TranscodeKernel::SSE4: MortonToLinearSSE4(voxelIDs.data(), linear.data()); return;
+    #endif
+            default: StorageToLinearScalar(voxelIDs.data(), linear.data()); return;
+        }
+    }
+
+    void ChunkTranscoder::LinearToStorage(std::span<const uint8_t, CHUNK_VOXELS> linear, std::span<uint32_t, CHUNK_WORDS> voxelIDs) {
+        if constexpr (CHUNK_LAYOUT == ChunkLayout::Linear) {
+            std::memcpy(voxelIDs.data(), linear.data(), linear.size());
+            return;
+        } else if constexpr (CHUNK_LAYOUT == ChunkLayout::Brick) {
+            LinearToBrick(linear.data(), voxelIDs.data());
+            return;
+        }
+
+        switch (GetKernel()) {
+    #if defined(VORTEX_TRANSCODE_X86)
+            case TranscodeKernel::AVX2: LinearToMortonAVX2(linear.data(), voxelIDs.data()); return;
+            case TranscodeKernel::SSE4: LinearToMortonSSE4(linear.data(), voxelIDs.data()); return;
+    #endif
+            default: LinearToStorageScalar(linear.data(), voxelIDs.data()); return;
+        }
+    }
+}
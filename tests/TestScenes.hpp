@@ -0,0 +1,89 @@
+#pragma once
+
+// Scene generators shared by the unit tests (test_main.cpp) and the benchmarks (benchmark_main.cpp).
+// Include after importing vortex.voxel and vortex.graphics.
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+
+// Fills a chunk with `materials` distinct IDs (0 counts as one of them) in a pattern that touches every block.
+inline void FillWithMaterials(vortex::voxel::Chunk& c, uint32_t materials) {
+    using vortex::voxel::CHUNK_SIZE;
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+        for (int y = 0; y < CHUNK_SIZE; ++y)
+            for (int x = 0; x < CHUNK_SIZE; ++x)
+                c.SetVoxel(x, y, z, (uint8_t)(((x * 7 + y * 3 + z) % materials) * 5));
+}
+
+// --- TLAS ---
+
+struct InstanceBox { glm::vec3 min, max; };
+
+// Chunk-sized boxes: half spread over the world, half packed around a few clusters (debris piles).
+inline std::vector<InstanceBox> RandomInstances(uint32_t count, uint32_t seed) {
+    uint32_t state = seed * 747796405u + 2891336453u;
+    auto next = [&]() { state = state * 1664525u + 1013904223u; return (float)(state >> 8) / (float)(1u << 24); };
+    float world = 64.0f * std::sqrt((float)count);
+    glm::vec3 clusters[8];
+    for (auto& c : clusters) c = glm::vec3(next(), next() * 0.1f, next()) * world;
+
+    std::vector<InstanceBox> boxes(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        glm::vec3 p = (i & 1) ? clusters[i % 8] + glm::vec3(next(), next(), next()) * 128.0f
+                              : glm::vec3(next(), next() * 0.1f, next()) * world;
+        glm::vec3 size = glm::vec3(next(), next(), next()) * 28.0f + 4.0f;
+        boxes[i] = {p, p + size};
+    }
+    return boxes;
+}
+
+inline std::vector<vortex::graphics::GPUBVHNode> BuildTLAS(vortex::graphics::TLASBuilder& builder, const std::vector<InstanceBox>& boxes) {
+    using vortex::graphics::TLASBuilder;
+    builder.Reset((uint32_t)boxes.size());
+    for (uint32_t i = 0; i < boxes.size(); ++i) builder.SetBounds(i, boxes[i].min, boxes[i].max);
+    std::vector<vortex::graphics::GPUBVHNode> nodes(TLASBuilder::NodeCount((uint32_t)boxes.size()));
+    builder.Build(nodes.data());
+    return nodes;
+}
+
+// --- Frustum Culling ---
+
+// Camera at `eye` looking down +z: 90 degree fov, square aspect, near 1, depth 0..1.
+inline vortex::graphics::Frustum TestFrustum(glm::vec3 eye, float far) {
+    glm::mat4 m(1.0f);
+    m[2][2] = far / (far - 1.0f);
+    m[3][2] = -far / (far - 1.0f);
+    m[2][3] = 1.0f;
+    m[3][3] = 0.0f;
+    // Translate by -eye (view matrix) folded into the last column: clip = M * (p - eye).
+    for (int r = 0; r < 4; ++r) m[3][r] -= m[0][r] * eye.x + m[1][r] * eye.y + m[2][r] * eye.z;
+    return vortex::graphics::Frustum::FromViewProj(m);
+}
+
+// Looks across a RandomInstances scene from its front edge and sees about a quarter of it.
+inline vortex::graphics::Frustum SceneFrustum(uint32_t count) {
+    float world = 64.0f * std::sqrt((float)count);
+    return TestFrustum({world * 0.5f, world * 0.05f, 0.0f}, world * 0.6f);
+}
+
+// --- Depth Sort ---
+
+// Distances from a camera inside a RandomInstances scene; every seventh one repeats an earlier distance.
+inline std::vector<float> RandomDepths(uint32_t count, uint32_t seed) {
+    auto boxes = RandomInstances(count, seed);
+    glm::vec3 eye = boxes.empty() ? glm::vec3(0.0f) : boxes[0].min;
+    std::vector<float> depths(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        glm::vec3 d = boxes[i].min - eye;
+        depths[i] = (i % 7 == 6) ? depths[i / 2] : std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+    }
+    return depths;
+}
+
+inline std::vector<uint32_t> Iota(uint32_t count) {
+    std::vector<uint32_t> items(count);
+    for (uint32_t i = 0; i < count; ++i) items[i] = i;
+    return items;
+}
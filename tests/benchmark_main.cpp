@@ -0,0 +1,268 @@
+#include <benchmark/benchmark.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <span>
+#include <algorithm>
+
+import vortex.voxel;
+import vortex.graphics;
+import vortex.jobs;
+
+using vortex::voxel::Chunk;
+using vortex::voxel::CompressedChunk;
+using vortex::voxel::CHUNK_SIZE;
+using vortex::voxel::CHUNK_VOXELS;
+using vortex::voxel::CHUNK_WORDS;
+using vortex::graphics::GPUBVHNode;
+using vortex::graphics::TLASBuilder;
+using vortex::graphics::Frustum;
+using vortex::graphics::FrustumCuller;
+using vortex::graphics::DepthSorter;
+using vortex::graphics::DepthSortMode;
+
+#include "TestScenes.hpp"
+
+// Run with VortexBenchmarks (benchmark_main owns main()); they are kept out of ctest so unit tests stay fast.
+
+// --- Chunk ---
+// Full chunk = CHUNK_SIZE^3 solid; half chunk = lower half of the Y layers.
+
+static void BM_SetVoxel_Full(benchmark::State& state) {
+    for (auto _ : state) {
+        Chunk c;
+        for (int z = 0; z < CHUNK_SIZE; ++z)
+            for (int y = 0; y < CHUNK_SIZE; ++y)
+                for (int x = 0; x < CHUNK_SIZE; ++x)
+                    c.SetVoxel(x, y, z, 1);
+        benchmark::DoNotOptimize(c.voxelIDs);
+    }
+}
+BENCHMARK(BM_SetVoxel_Full);
+
+static void BM_FillBox_Full(benchmark::State& state) {
+    for (auto _ : state) {
+        Chunk c;
+        c.FillBox({0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE}, 1);
+        benchmark::DoNotOptimize(c.voxelIDs);
+    }
+}
+BENCHMARK(BM_FillBox_Full);
+
+static void BM_SetVoxel_Half(benchmark::State& state) {
+    for (auto _ : state) {
+        Chunk c;
+        for (int z = 0; z < CHUNK_SIZE; ++z)
+            for (int y = 0; y < CHUNK_SIZE / 2; ++y)
+                for (int x = 0; x < CHUNK_SIZE; ++x)
+                    c.SetVoxel(x, y, z, 1);
+        benchmark::DoNotOptimize(c.voxelIDs);
+    }
+}
+BENCHMARK(BM_SetVoxel_Half);
+
+static void BM_FillBox_Half(benchmark::State& state) {
+    for (auto _ : state) {
+        Chunk c;
+        c.FillBox({0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE / 2, CHUNK_SIZE}, 1);
+        benchmark::DoNotOptimize(c.voxelIDs);
+    }
+}
+BENCHMARK(BM_FillBox_Half);
+
+static void BM_WriteLinear_Full(benchmark::State& state) {
+    std::vector<uint8_t> data(CHUNK_VOXELS, 1);
+    for (auto _ : state) {
+        Chunk c;
+        c.WriteLinear(data, glm::ivec3(0), glm::ivec3(CHUNK_SIZE));
+        benchmark::DoNotOptimize(c.voxelIDs);
+    }
+}
+BENCHMARK(BM_WriteLinear_Full);
+
+static void BM_RebuildHierarchy(benchmark::State& state) {
+    Chunk c;
+    c.FillBox({0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE / 2, CHUNK_SIZE}, 1);
+    for (auto _ : state) {
+        c.RebuildHierarchy();
+        benchmark::DoNotOptimize(c.hierarchy);
+    }
+}
+BENCHMARK(BM_RebuildHierarchy);
+
+// Traversal cost of the configured layout (compare builds with different VORTEX_CHUNK_LAYOUT).
+static void BM_ForEachSolidVoxel_Half(benchmark::State& state) {
+    Chunk c;
+    c.FillBox({0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE / 2, CHUNK_SIZE}, 1);
+    for (auto _ : state) {
+        uint32_t sum = 0;
+        c.ForEachSolidVoxel([&](int x, int y, int z, uint8_t id) { sum += x + y + z + id; });
+        benchmark::DoNotOptimize(sum);
+    }
+}
+BENCHMARK(BM_ForEachSolidVoxel_Half);
+
+static void BM_ReadLinear(benchmark::State& state) {
+    Chunk c;
+    c.FillBox({0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE / 2, CHUNK_SIZE}, 1);
+    std::vector<uint8_t> out(CHUNK_VOXELS);
+    for (auto _ : state) {
+        c.ReadLinear(std::span<uint8_t, CHUNK_VOXELS>(out.data(), CHUNK_VOXELS));
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+BENCHMARK(BM_ReadLinear);
+
+// Arg = number of distinct IDs: 1 uniform, 2/4/16 palette widths, 64 raw.
+static void BM_CompressedDecode(benchmark::State& state) {
+    Chunk c;
+    FillWithMaterials(c, (uint32_t)state.range(0));
+    CompressedChunk packed = CompressedChunk::Compress(c);
+    std::vector<uint32_t> out(CHUNK_WORDS);
+    for (auto _ : state) {
+        packed.DecodeVoxelIDs(std::span<uint32_t, CHUNK_WORDS>(out.data(), CHUNK_WORDS));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed((int64_t)state.iterations() * CHUNK_VOXELS);
+    state.counters["compressedBytes"] = (double)packed.GetMemoryUsage();
+}
+BENCHMARK(BM_CompressedDecode)->Arg(1)->Arg(2)->Arg(4)->Arg(16)->Arg(64);
+
+// --- TLAS ---
+
+// Arg 0 = instances, arg 1 = 1 to build with the job system. The "sah" counter is the tree's SAH cost.
+static void BM_TLASBuild(benchmark::State& state) {
+    auto boxes = RandomInstances((uint32_t)state.range(0), 1);
+    if (state.range(1)) vortex::jobs::JobSystem::Initialize();
+    TLASBuilder builder;
+    std::vector<GPUBVHNode> nodes;
+    for (auto _ : state) {
+        nodes = BuildTLAS(builder, boxes);
+        benchmark::DoNotOptimize(nodes.data());
+    }
+    if (state.range(1)) vortex::jobs::JobSystem::Shutdown();
+    state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+    state.counters["sah"] = TLASBuilder::SAHCost(nodes.data(), (uint32_t)nodes.size());
+}
+BENCHMARK(BM_TLASBuild)->ArgsProduct({{1000, 10000, 50000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+// Arg = instances moved per frame out of 10k; each moves back and forth by a few voxels.
+static void BM_TLASRefit(benchmark::State& state) {
+    auto boxes = RandomInstances(10000, 1);
+    TLASBuilder builder;
+    auto nodes = BuildTLAS(builder, boxes);
+    const uint32_t moved = (uint32_t)state.range(0);
+    const uint32_t stride = (uint32_t)boxes.size() / moved;
+    std::vector<uint32_t> touched;
+    size_t totalTouched = 0;
+    float step = 2.0f;
+    for (auto _ : state) {
+        touched.clear();
+        for (uint32_t k = 0; k < moved; ++k) {
+            InstanceBox& b = boxes[k * stride];
+            b = {b.min + glm::vec3(step, 0.0f, 0.0f), b.max + glm::vec3(step, 0.0f, 0.0f)};
+            builder.Refit(nodes.data(), k * stride, b.min, b.max, touched);
+        }
+        step = -step;
+        totalTouched += touched.size();
+        benchmark::DoNotOptimize(nodes.data());
+    }
+    state.counters["nodesTouched"] = benchmark::Counter((double)totalTouched, benchmark::Counter::kAvgIterations);
+    state.counters["degradation"] = builder.GetRefitDegradation();
+}
+BENCHMARK(BM_TLASRefit)->Arg(10)->Arg(100)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+// Spatial-midpoint split (the previous builder) on the same scenes, for SAH cost comparison.
+static uint32_t BuildMidpointRecursive(const std::vector<InstanceBox>& boxes, std::vector<uint32_t>& ids, std::vector<GPUBVHNode>& nodes) {
+    glm::vec3 mn(FLT_MAX), mx(-FLT_MAX);
+    for (uint32_t i : ids) { mn = glm::min(mn, boxes[i].min); mx = glm::max(mx, boxes[i].max); }
+    uint32_t index = (uint32_t)nodes.size();
+    nodes.push_back({mn, ids[0], mx, TLASBuilder::LEAF_SENTINEL});
+    if (ids.size() == 1) return index;
+
+    glm::vec3 extent = mx - mn;
+    int axis = extent.y > extent.x ? 1 : 0;
+    if (extent.z > extent[axis]) axis = 2;
+    float split = (mn[axis] + mx[axis]) * 0.5f;
+    std::vector<uint32_t> left, right;
+    for (uint32_t i : ids) ((boxes[i].min[axis] + boxes[i].max[axis]) * 0.5f < split ? left : right).push_back(i);
+    if (left.empty() || right.empty()) {
+        left.assign(ids.begin(), ids.begin() + ids.size() / 2);
+        right.assign(ids.begin() + ids.size() / 2, ids.end());
+    }
+    uint32_t l = BuildMidpointRecursive(boxes, left, nodes);
+    uint32_t r = BuildMidpointRecursive(boxes, right, nodes);
+    nodes[index].leftChildOrInstance = l;
+    nodes[index].rightChildOrCount = r;
+    return index;
+}
+
+static void BM_TLASBuildMidpoint(benchmark::State& state) {
+    auto boxes = RandomInstances((uint32_t)state.range(0), 1);
+    std::vector<GPUBVHNode> nodes;
+    for (auto _ : state) {
+        std::vector<uint32_t> ids(boxes.size());
+        for (uint32_t i = 0; i < ids.size(); ++i) ids[i] = i;
+        nodes.clear();
+        BuildMidpointRecursive(boxes, ids, nodes);
+        benchmark::DoNotOptimize(nodes.data());
+    }
+    state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+    state.counters["sah"] = TLASBuilder::SAHCost(nodes.data(), (uint32_t)nodes.size());
+}
+BENCHMARK(BM_TLASBuildMidpoint)->Arg(1000)->Arg(10000)->Arg(50000)->Unit(benchmark::kMicrosecond);
+
+// --- Frustum Culling ---
+
+// Arg 0 = objects, arg 1 = 1 for the SIMD path. The "visible" counter is the share of objects kept.
+static void BM_FrustumCull(benchmark::State& state) {
+    auto boxes = RandomInstances((uint32_t)state.range(0), 1);
+    FrustumCuller culler;
+    culler.Reset((uint32_t)boxes.size());
+    for (uint32_t i = 0; i < boxes.size(); ++i) culler.SetBounds(i, boxes[i].min, boxes[i].max);
+    Frustum frustum = SceneFrustum((uint32_t)boxes.size());
+    std::vector<uint32_t> visible;
+    for (auto _ : state) {
+        if (state.range(1)) culler.Cull(frustum, visible);
+        else culler.CullScalar(frustum, visible);
+        benchmark::DoNotOptimize(visible.data());
+    }
+    state.SetItemsProcessed((int64_t)state.iterations() * state.range(0));
+    state.counters["visible"] = (double)visible.size() / (double)boxes.size();
+}
+BENCHMARK(BM_FrustumCull)->ArgsProduct({{10000, 100000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+// --- Depth Sort ---
+
+// Arg 0 = objects, arg 1 = DepthSortMode. Each iteration sorts a fresh identity order, like a frame does.
+static void BM_DepthSort(benchmark::State& state) {
+    const uint32_t count = (uint32_t)state.range(0);
+    auto depths = RandomDepths(count, 1);
+    DepthSorter sorter;
+    std::vector<uint32_t> items;
+    for (auto _ : state) {
+        items = Iota(count);
+        sorter.Sort(items, depths, (DepthSortMode)state.range(1));
+        benchmark::DoNotOptimize(items.data());
+    }
+    state.SetItemsProcessed((int64_t)state.iterations() * count);
+}
+BENCHMARK(BM_DepthSort)->ArgsProduct({{1000, 10000, 100000}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+// The previous draw order: comparison sort recomputing squared distances from the transforms.
+static void BM_DepthSortComparison(benchmark::State& state) {
+    const uint32_t count = (uint32_t)state.range(0);
+    auto boxes = RandomInstances(count, 1);
+    glm::vec3 eye = boxes[0].min;
+    std::vector<uint32_t> items;
+    for (auto _ : state) {
+        items = Iota(count);
+        std::sort(items.begin(), items.end(), [&](uint32_t a, uint32_t b) {
+            glm::vec3 da = boxes[a].min - eye, db = boxes[b].min - eye;
+            return da.x * da.x + da.y * da.y + da.z * da.z < db.x * db.x + db.y * db.y + db.z * db.z;
+        });
+        benchmark::DoNotOptimize(items.data());
+    }
+    state.SetItemsProcessed((int64_t)state.iterations() * count);
+}
+BENCHMARK(BM_DepthSortComparison)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
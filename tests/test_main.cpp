@@ -0,0 +1,1475 @@
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <bit>
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <map>
+#include <memory>
+#include <queue>
+
+import vortex.voxel;
+import vortex.graphics;
+import vortex.jobs;
+import vortex.physics;
+
+using vortex::voxel::Chunk;
+using vortex::voxel::CHUNK_SIZE;
+using vortex::voxel::CHUNK_AREA;
+using vortex::voxel::CHUNK_VOXELS;
+using vortex::voxel::CHUNK_WORDS;
+using vortex::voxel::HIERARCHY_WORDS;
+using vortex::graphics::GPUBVHNode;
+using vortex::graphics::TLASBuilder;
+using vortex::graphics::Frustum;
+using vortex::graphics::FrustumCuller;
+using vortex::graphics::DepthSorter;
+using vortex::graphics::DepthSortMode;
+using vortex::graphics::ChunkSlotAllocator;
+using vortex::jobs::JobSystem;
+using vortex::jobs::TaskGroup;
+
+#include "TestScenes.hpp"
+
+// --- Helpers ---
+
+static bool SameVoxels(const Chunk& a, const Chunk& b) {
+    return std::memcmp(a.voxelIDs, b.voxelIDs, sizeof(a.voxelIDs)) == 0;
+}
+
+static bool SameHierarchy(const Chunk& a, const Chunk& b) {
+    return std::memcmp(a.hierarchy, b.hierarchy, sizeof(a.hierarchy)) == 0;
+}
+
+// Reference hierarchy: one bit per non-empty 4x4x4 block, computed through GetVoxel.
+static void ReferenceHierarchy(const Chunk& c, uint32_t (&out)[HIERARCHY_WORDS]) {
+    std::memset(out, 0, sizeof(out));
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+        for (int y = 0; y < CHUNK_SIZE; ++y)
+            for (int x = 0; x < CHUNK_SIZE; ++x)
+                if (c.GetVoxel(x, y, z) != 0) {
+                    uint32_t h = vortex::voxel::HierarchyBit(x >> 2, y >> 2, z >> 2);
+                    out[h >> 5] |= 1u << (h & 31);
+                }
+}
+
+// --- Chunk Region API ---
+
+TEST(ChunkRegion, FillBoxMatchesSetVoxel) {
+    const glm::ivec3 boxes[][2] = {
+        { {0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE} },
+        { {3, 5, 7}, {29, 18, 31} },
+        { {-4, 10, 2}, {6, 40, 3} },
+    };
+
+    for (const auto& box : boxes) {
+        Chunk ref, bulk;
+        for (int z = box[0].z; z < box[1].z; ++z)
+            for (int y = box[0].y; y < box[1].y; ++y)
+                for (int x = box[0].x; x < box[1].x; ++x)
+                    ref.SetVoxel(x, y, z, 7);
+
+        bulk.FillBox(box[0], box[1], 7);
+        EXPECT_TRUE(SameVoxels(ref, bulk));
+        EXPECT_TRUE(SameHierarchy(ref, bulk));
+    }
+}
+
+TEST(ChunkRegion, EraseRebuildsHierarchyExactly) {
+    Chunk c;
+    c.FillBox({0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE}, 3);
+    c.FillBox({4, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE}, 0);
+
+    uint32_t expected[HIERARCHY_WORDS];
+    ReferenceHierarchy(c, expected);
+    EXPECT_EQ(std::memcmp(expected, c.hierarchy, sizeof(expected)), 0);
+}
+
+TEST(ChunkRegion, SetVoxelEraseKeepsHierarchyExact) {
+    Chunk c;
+    c.SetVoxel(5, 9, 13, 1);
+    c.SetVoxel(6, 9, 13, 1);
+
+    c.SetVoxel(5, 9, 13, 0);
+    uint32_t expected[HIERARCHY_WORDS];
+    ReferenceHierarchy(c, expected);
+    EXPECT_EQ(std::memcmp(expected, c.hierarchy, sizeof(expected)), 0);
+
+    c.SetVoxel(6, 9, 13, 0);
+    ReferenceHierarchy(c, expected);
+    EXPECT_EQ(std::memcmp(expected, c.hierarchy, sizeof(expected)), 0);
+    EXPECT_TRUE(c.IsBlockEmpty(1, 2, 3));
+}
+
+TEST(ChunkRegion, CopyRegionAndWriteLinear) {
+    Chunk src;
+    for (int i = 0; i < (int)CHUNK_VOXELS; i += 3) src.SetVoxel(i % CHUNK_SIZE, (i / CHUNK_SIZE) % CHUNK_SIZE, i / CHUNK_AREA, (uint8_t)(1 + i % 250));
+
+    // Aligned copy (block fast path) and unaligned copy (per-voxel path).
+    for (glm::ivec3 dstMin : { glm::ivec3(8, 4, 0), glm::ivec3(5, 3, 1) }) {
+        Chunk ref, bulk;
+        glm::ivec3 srcMin(4, 0, 8), size(16, 20, 12);
+        for (int z = 0; z < size.z; ++z)
+            for (int y = 0; y < size.y; ++y)
+                for (int x = 0; x < size.x; ++x)
+                    ref.SetVoxel(dstMin.x + x, dstMin.y + y, dstMin.z + z, src.GetVoxel(srcMin.x + x, srcMin.y + y, srcMin.z + z));
+
+        bulk.CopyRegion(src, srcMin, dstMin, size);
+        EXPECT_TRUE(SameVoxels(ref, bulk));
+    }
+
+    std::vector<uint8_t> linear(CHUNK_VOXELS);
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+        for (int y = 0; y < CHUNK_SIZE; ++y)
+            for (int x = 0; x < CHUNK_SIZE; ++x)
+                linear[x + y * CHUNK_SIZE + z * CHUNK_AREA] = src.GetVoxel(x, y, z);
+
+    Chunk written;
+    written.WriteLinear(linear, glm::ivec3(0), glm::ivec3(CHUNK_SIZE));
+    EXPECT_TRUE(SameVoxels(src, written));
+}
+
+TEST(ChunkRegion, ApplyMask) {
+    using vortex::voxel::OccupancyRow;
+    std::array<OccupancyRow, CHUNK_AREA> rows{};
+    Chunk ref;
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+        for (int y = 0; y < CHUNK_SIZE; ++y)
+            for (int x = 0; x < CHUNK_SIZE; ++x)
+                if ((x + y + z) % 5 == 0 || (x < 8 && y < 8 && z < 8)) {
+                    rows[z * CHUNK_SIZE + y] |= OccupancyRow(1) << x;
+                    ref.SetVoxel(x, y, z, 9);
+                }
+
+    Chunk bulk;
+    bulk.ApplyMask(rows, 9);
+    EXPECT_TRUE(SameVoxels(ref, bulk));
+    EXPECT_TRUE(SameHierarchy(ref, bulk));
+}
+
+// --- Layout ---
+
+// Whatever VORTEX_CHUNK_LAYOUT is configured: the index must be a bijection, and block-contiguous
+// layouts must keep each 4x4x4 block in its own 64-byte run.
+TEST(ChunkLayout, VoxelIndexIsBijective) {
+    using vortex::voxel::ActiveLayout;
+    std::vector<uint8_t> seen(CHUNK_VOXELS, 0);
+    for (uint32_t z = 0; z < CHUNK_SIZE; ++z)
+        for (uint32_t y = 0; y < CHUNK_SIZE; ++y)
+            for (uint32_t x = 0; x < CHUNK_SIZE; ++x) {
+                uint32_t index = Chunk::VoxelIndex(x, y, z);
+                ASSERT_LT(index, CHUNK_VOXELS);
+                seen[index]++;
+                if constexpr (ActiveLayout::BLOCK_CONTIGUOUS) {
+                    EXPECT_EQ(index >> 6, ActiveLayout::BlockIndex(x >> 2, y >> 2, z >> 2));
+                }
+            }
+    for (uint8_t count : seen) ASSERT_EQ(count, 1);
+}
+
+// --- Occupancy ---
+
+static bool OccupancyMatchesIDs(const Chunk& c) {
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+        for (int y = 0; y < CHUNK_SIZE; ++y)
+            for (int x = 0; x < CHUNK_SIZE; ++x)
+                if (c.IsSolid(x, y, z) != (c.GetVoxel(x, y, z) != 0)) return false;
+    return true;
+}
+
+TEST(ChunkOccupancy, TracksVoxelWrites) {
+    Chunk c;
+    c.FillBox({2, 3, 4}, {30, 17, 21}, 5);
+    c.FillBox({8, 8, 8}, {12, 12, 12}, 0);
+    c.SetVoxel(0, 0, 0, 1);
+    c.SetVoxel(2, 3, 4, 0);
+    EXPECT_TRUE(OccupancyMatchesIDs(c));
+
+    glm::vec3 sum;
+    uint32_t count = c.CountSolidInBox({0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE}, &sum);
+    EXPECT_EQ(count, c.occupancy.PopCount());
+    glm::ivec3 extent = glm::min(glm::ivec3(30, 17, 21), glm::ivec3(CHUNK_SIZE)) - glm::ivec3(2, 3, 4);
+    EXPECT_EQ(count, (uint32_t)(extent.x * extent.y * extent.z - 64));
+}
+
+TEST(ChunkOccupancy, ShiftsAndFaces) {
+    Chunk c;
+    c.FillBox({4, 5, 6}, {10, 9, 16}, 1); // 6 x 4 x 10 box
+
+    vortex::voxel::OccupancyMask shifted;
+    c.occupancy.ShiftX(1, shifted);
+    EXPECT_TRUE(shifted.Get(3, 5, 6));
+    EXPECT_FALSE(shifted.Get(9, 5, 6));
+
+    EXPECT_EQ(c.occupancy.CountExposedFaces(), 2u * (6 * 4 + 6 * 10 + 4 * 10));
+
+    vortex::voxel::OccupancyMask top;
+    c.occupancy.FaceMask(vortex::voxel::VoxelFace::PosY, top);
+    EXPECT_EQ(top.PopCount(), 6u * 10u);
+}
+
+// --- Storage <-> Linear Transcoding ---
+// Exhaustive over all CHUNK_SIZE^3 positions: one pass per byte of each voxel's Morton code,
+// which together identify every position uniquely.
+
+using vortex::voxel::ChunkTranscoder;
+using vortex::voxel::TranscodeKernel;
+
+TEST(ChunkTranscode, RoundTripAllKernels) {
+    const TranscodeKernel previous = ChunkTranscoder::GetKernel();
+    std::vector<uint32_t> words(CHUNK_WORDS), back(CHUNK_WORDS);
+    std::vector<uint8_t> linear(CHUNK_VOXELS);
+    std::span<uint32_t, CHUNK_WORDS> wordSpan(words.data(), CHUNK_WORDS), backSpan(back.data(), CHUNK_WORDS);
+    std::span<uint8_t, CHUNK_VOXELS> linearSpan(linear.data(), CHUNK_VOXELS);
+    const int mortonBits = 3 * std::countr_zero((unsigned)CHUNK_SIZE);
+
+    for (TranscodeKernel kernel : { TranscodeKernel::Scalar, TranscodeKernel::SSE4, TranscodeKernel::AVX2 }) {
+        if (!ChunkTranscoder::IsSupported(kernel)) continue;
+        ChunkTranscoder::SetKernel(kernel);
+        ASSERT_EQ(ChunkTranscoder::GetKernel(), kernel);
+
+        for (int shift = 0; shift < mortonBits; shift += 8) {
+            Chunk c;
+            for (uint32_t z = 0; z < CHUNK_SIZE; ++z)
+                for (uint32_t y = 0; y < CHUNK_SIZE; ++y)
+                    for (uint32_t x = 0; x < CHUNK_SIZE; ++x)
+                        c.WriteRaw(Chunk::VoxelIndex(x, y, z), (uint8_t)(vortex::voxel::Morton3D(x, y, z) >> shift));
+            std::memcpy(words.data(), c.voxelIDs, sizeof(c.voxelIDs));
+
+            ChunkTranscoder::StorageToLinear(wordSpan, linearSpan);
+            int mismatches = 0;
+            for (uint32_t z = 0; z < CHUNK_SIZE; ++z)
+                for (uint32_t y = 0; y < CHUNK_SIZE; ++y)
+                    for (uint32_t x = 0; x < CHUNK_SIZE; ++x)
+                        mismatches += linear[x + y * CHUNK_SIZE + z * CHUNK_AREA] != c.GetVoxel(x, y, z);
+            EXPECT_EQ(mismatches, 0) << "kernel " << (int)kernel << " shift " << shift;
+
+            ChunkTranscoder::LinearToStorage(linearSpan, backSpan);
+            EXPECT_EQ(words, back) << "kernel " << (int)kernel << " shift " << shift;
+        }
+    }
+
+    ChunkTranscoder::SetKernel(previous);
+}
+
+// --- Compressed Chunks ---
+
+using vortex::voxel::CompressedChunk;
+
+TEST(CompressedChunk, RoundTripAllEncodings) {
+    const std::pair<uint32_t, CompressedChunk::Encoding> cases[] = {
+        { 1, CompressedChunk::Encoding::Uniform },
+        { 2, CompressedChunk::Encoding::Palette1 },
+        { 3, CompressedChunk::Encoding::Palette2 },
+        { 16, CompressedChunk::Encoding::Palette4 },
+        { 40, CompressedChunk::Encoding::Raw },
+    };
+
+    for (const auto& [materials, encoding] : cases) {
+        Chunk c;
+        FillWithMaterials(c, materials);
+        CompressedChunk packed = CompressedChunk::Compress(c);
+        EXPECT_EQ(packed.GetEncoding(), encoding) << materials;
+
+        Chunk restored;
+        packed.Decompress(restored);
+        EXPECT_TRUE(SameVoxels(c, restored)) << materials;
+        EXPECT_TRUE(SameHierarchy(c, restored)) << materials;
+        EXPECT_EQ(std::memcmp(c.occupancy.rows, restored.occupancy.rows, sizeof(c.occupancy.rows)), 0) << materials;
+
+        std::vector<uint8_t> gpu(Chunk::GPU_SIZE, 0xCD);
+        packed.WriteGPU(gpu.data());
+        EXPECT_EQ(std::memcmp(gpu.data(), &c, Chunk::GPU_SIZE), 0) << materials;
+    }
+
+    Chunk solid;
+    solid.FillBox({0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE}, 4);
+    CompressedChunk packed = CompressedChunk::Compress(solid);
+    EXPECT_EQ(packed.GetEncoding(), CompressedChunk::Encoding::Uniform);
+    Chunk restored;
+    packed.Decompress(restored);
+    EXPECT_TRUE(SameVoxels(solid, restored));
+}
+
+TEST(CompressedChunk, PaletteComesFromVoxelsNotStats) {
+    // voxelIDs is public: writes that bypass the write APIs leave chunk.stats stale.
+    Chunk c;
+    FillWithMaterials(c, 3);
+    reinterpret_cast<uint8_t*>(c.voxelIDs)[100] = 77;
+    Chunk restored;
+    CompressedChunk::Compress(c).Decompress(restored);
+    EXPECT_TRUE(SameVoxels(c, restored));
+
+    Chunk solid;
+    solid.FillBox({0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE}, 4);
+    reinterpret_cast<uint8_t*>(solid.voxelIDs)[CHUNK_VOXELS - 1] = 9;
+    CompressedChunk packed = CompressedChunk::Compress(solid);
+    EXPECT_EQ(packed.GetEncoding(), CompressedChunk::Encoding::Palette1);
+    packed.Decompress(restored);
+    EXPECT_TRUE(SameVoxels(solid, restored));
+}
+
+// --- Incremental Stats ---
+
+// Brute-force recount through GetVoxel, compared field by field with the incrementally maintained stats.
+static void ExpectStatsMatchRecount(Chunk& c) {
+    uint32_t count = 0;
+    glm::uvec3 sum(0u);
+    std::array<uint32_t, 256> materials{};
+    glm::ivec3 lo(CHUNK_SIZE), hi(0);
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+        for (int y = 0; y < CHUNK_SIZE; ++y)
+            for (int x = 0; x < CHUNK_SIZE; ++x) {
+                uint8_t id = c.GetVoxel(x, y, z);
+                if (id == 0) continue;
+                count++;
+                sum += glm::uvec3(x, y, z);
+                materials[id]++;
+                lo = glm::min(lo, glm::ivec3(x, y, z));
+                hi = glm::max(hi, glm::ivec3(x, y, z) + 1);
+            }
+    if (count == 0) lo = hi = glm::ivec3(0);
+
+    const vortex::voxel::ChunkStats& stats = c.GetStats();
+    EXPECT_EQ(stats.solidCount, count);
+    EXPECT_EQ(stats.positionSum, sum);
+    EXPECT_EQ(stats.materialCounts, materials);
+    EXPECT_EQ(stats.boundsMin, lo);
+    EXPECT_EQ(stats.boundsMax, hi);
+}
+
+TEST(ChunkStats, MatchRecountAfterEveryWriteApi) {
+    Chunk c;
+    ExpectStatsMatchRecount(c);
+
+    c.SetVoxel(5, 6, 7, 3);
+    c.SetVoxel(9, 2, 1, 4);
+    ExpectStatsMatchRecount(c);
+    c.SetVoxel(9, 2, 1, 0); // erase on the bounds -> lazy shrink
+    ExpectStatsMatchRecount(c);
+
+    c.FillBox({2, 3, 4}, {12, 10, 9}, 7);
+    ExpectStatsMatchRecount(c);
+    c.FillBox({4, 4, 4}, {8, 8, 8}, 0);
+    ExpectStatsMatchRecount(c);
+    c.FillBox({0, 0, 0}, {6, 6, 6}, 2);
+    ExpectStatsMatchRecount(c);
+
+    Chunk src;
+    FillWithMaterials(src, 5);
+    c.CopyRegion(src, {1, 1, 1}, {3, 0, 2}, {9, 7, 5});
+    ExpectStatsMatchRecount(c);
+    c.CopyRegion(src, {0, 0, 0}, {8, 4, 0}, {8, 8, 8}, true);
+    ExpectStatsMatchRecount(c);
+
+    std::vector<uint8_t> linear(5 * 6 * 7, 0);
+    for (size_t i = 0; i < linear.size(); i += 2) linear[i] = (uint8_t)(i % 11);
+    c.WriteLinear(linear, {1, 2, 3}, {5, 6, 7});
+    ExpectStatsMatchRecount(c);
+
+    c.FillBox({0, 0, 0}, {CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE}, 0);
+    ExpectStatsMatchRecount(c);
+    EXPECT_EQ(c.stats.solidCount, 0u);
+}
+
+// --- Dirty Block Tracking ---
+
+// Brings a stale GPU image of the chunk up to date using only its dirty ranges, then clears the mask.
+static size_t ReplayDirtyRanges(Chunk& c, std::vector<uint8_t>& image) {
+    std::vector<vortex::voxel::ChunkByteRange> ranges;
+    c.CollectDirtyRanges(ranges);
+    size_t bytes = 0;
+    for (const auto& r : ranges) {
+        EXPECT_LE((size_t)r.offset + r.size, Chunk::GPU_SIZE);
+        std::memcpy(image.data() + r.offset, reinterpret_cast<const uint8_t*>(&c) + r.offset, r.size);
+        bytes += r.size;
+    }
+    c.ClearDirty();
+    return bytes;
+}
+
+static bool MatchesImage(const Chunk& c, const std::vector<uint8_t>& image) {
+    return std::memcmp(&c, image.data(), Chunk::GPU_SIZE) == 0;
+}
+
+TEST(ChunkDirty, RangesReproduceGpuImage) {
+    Chunk c;
+    EXPECT_TRUE(c.IsDirty());
+    std::vector<uint8_t> image(Chunk::GPU_SIZE);
+    std::memcpy(image.data(), &c, Chunk::GPU_SIZE);
+    c.ClearDirty();
+    EXPECT_FALSE(c.IsDirty());
+
+    // One voxel: at most one block's words plus the hierarchy.
+    c.SetVoxel(5, 6, 7, 3);
+    size_t bytes = ReplayDirtyRanges(c, image);
+    EXPECT_LE(bytes, 64 + sizeof(c.hierarchy));
+    EXPECT_TRUE(MatchesImage(c, image));
+
+    c.SetVoxel(5, 6, 7, 3); // unchanged value -> nothing to send
+    EXPECT_FALSE(c.IsDirty());
+
+    c.FillBox({2, 3, 4}, {12, 10, 9}, 7);
+    ReplayDirtyRanges(c, image);
+    EXPECT_TRUE(MatchesImage(c, image));
+
+    Chunk src;
+    FillWithMaterials(src, 5);
+    c.CopyRegion(src, {1, 1, 1}, {3, 0, 2}, {9, 7, 5});
+    ReplayDirtyRanges(c, image);
+    EXPECT_TRUE(MatchesImage(c, image));
+
+    std::vector<uint8_t> linear(5 * 6 * 7, 0);
+    for (size_t i = 0; i < linear.size(); i += 3) linear[i] = (uint8_t)(i % 13);
+    c.WriteLinear(linear, {CHUNK_SIZE - 5, 2, 3}, {5, 6, 7});
+    ReplayDirtyRanges(c, image);
+    EXPECT_TRUE(MatchesImage(c, image));
+
+    std::array<vortex::voxel::OccupancyRow, CHUNK_AREA> rows{};
+    rows[3 * CHUNK_SIZE + 9] = 0xF0F0;
+    c.ApplyMask(rows, 9);
+    ReplayDirtyRanges(c, image);
+    EXPECT_TRUE(MatchesImage(c, image));
+
+    c.SetVoxel(5, 6, 7, 0);
+    ReplayDirtyRanges(c, image);
+    EXPECT_TRUE(MatchesImage(c, image));
+
+    // A copy has never been uploaded anywhere.
+    Chunk copy = c;
+    EXPECT_TRUE(copy.IsDirty());
+}
+
+// --- Solid Iteration ---
+// Whatever VORTEX_CHUNK_LAYOUT is configured, the iterators must visit exactly what a GetVoxel scan finds.
+
+enum class SolidPattern { Empty, Sparse, FullUniform, FullMixed, Edges };
+
+static void FillPattern(Chunk& c, SolidPattern pattern) {
+    const int n = (int)CHUNK_SIZE;
+    switch (pattern) {
+        case SolidPattern::Empty: break;
+        case SolidPattern::Sparse: {
+            uint32_t state = 12345;
+            for (int i = 0; i < 300; ++i) {
+                state = state * 1664525u + 1013904223u;
+                uint32_t v = state >> 8;
+                c.SetVoxel((int)(v % n), (int)((v / n) % n), (int)((v / (n * n)) % n), (uint8_t)(1 + (state >> 24) % 255));
+            }
+            break;
+        }
+        case SolidPattern::FullUniform: c.FillBox({0, 0, 0}, {n, n, n}, 3); break;
+        case SolidPattern::FullMixed: FillWithMaterials(c, 40); c.FillBox({0, 0, 0}, {n, 1, n}, 200); break;
+        case SolidPattern::Edges:
+            // The 12 cube edges: first and last voxel of every row, column and block on the boundary.
+            for (int i = 0; i < n; ++i) {
+                uint8_t id = (uint8_t)(1 + i % 7);
+                const int p[12][3] = {{i, 0, 0}, {i, n - 1, 0}, {i, 0, n - 1}, {i, n - 1, n - 1},
+                                      {0, i, 0}, {n - 1, i, 0}, {0, i, n - 1}, {n - 1, i, n - 1},
+                                      {0, 0, i}, {n - 1, 0, i}, {0, n - 1, i}, {n - 1, n - 1, i}};
+                for (const auto& q : p) c.SetVoxel(q[0], q[1], q[2], id);
+            }
+            break;
+    }
+}
+
+static const SolidPattern ALL_PATTERNS[] = {SolidPattern::Empty, SolidPattern::Sparse, SolidPattern::FullUniform,
+                                            SolidPattern::FullMixed, SolidPattern::Edges};
+
+// (z, y, x, id) in GetVoxel scan order.
+using SolidVoxel = std::array<int, 4>;
+
+static std::vector<SolidVoxel> ScanSolids(const Chunk& c) {
+    std::vector<SolidVoxel> out;
+    for (int z = 0; z < (int)CHUNK_SIZE; ++z)
+        for (int y = 0; y < (int)CHUNK_SIZE; ++y)
+            for (int x = 0; x < (int)CHUNK_SIZE; ++x)
+                if (uint8_t id = c.GetVoxel(x, y, z)) out.push_back({z, y, x, id});
+    return out;
+}
+
+TEST(ChunkIteration, SolidVoxelsMatchGetVoxelScan) {
+    for (SolidPattern pattern : ALL_PATTERNS) {
+        auto c = std::make_unique<Chunk>();
+        FillPattern(*c, pattern);
+
+        std::vector<SolidVoxel> visited;
+        c->ForEachSolidVoxel([&](int x, int y, int z, uint8_t id) { visited.push_back({z, y, x, id}); });
+        std::sort(visited.begin(), visited.end());
+        EXPECT_TRUE(std::adjacent_find(visited.begin(), visited.end()) == visited.end()) << "pattern " << (int)pattern;
+        EXPECT_EQ(visited, ScanSolids(*c)) << "pattern " << (int)pattern;
+
+        std::vector<std::array<int, 3>> blocks, expectedBlocks;
+        c->ForEachSolidBlock([&](int bx, int by, int bz) { blocks.push_back({bz, by, bx}); });
+        for (const auto& v : visited) expectedBlocks.push_back({v[0] >> 2, v[1] >> 2, v[2] >> 2});
+        std::sort(blocks.begin(), blocks.end());
+        std::sort(expectedBlocks.begin(), expectedBlocks.end());
+        expectedBlocks.erase(std::unique(expectedBlocks.begin(), expectedBlocks.end()), expectedBlocks.end());
+        EXPECT_EQ(blocks, expectedBlocks) << "pattern " << (int)pattern;
+    }
+}
+
+// The collider builder as it was before the port: a GetVoxel scan seeding greedy merges.
+static std::vector<vortex::physics::ColliderBox> ReferenceColliderBoxes(const Chunk& c) {
+    const int n = (int)CHUNK_SIZE;
+    auto index = [n](int x, int y, int z) { return x + y * n + z * n * n; };
+    std::vector<bool> visited(CHUNK_VOXELS, false);
+    std::vector<vortex::physics::ColliderBox> boxes;
+    for (int z = 0; z < n; ++z)
+        for (int y = 0; y < n; ++y)
+            for (int x = 0; x < n; ++x) {
+                uint8_t id = c.GetVoxel(x, y, z);
+                if (visited[index(x, y, z)] || id == 0) continue;
+                auto fits = [&](int px, int py, int pz) { return !visited[index(px, py, pz)] && c.GetVoxel(px, py, pz) == id; };
+                int w = 1, h = 1, d = 1;
+                while (x + w < n && fits(x + w, y, z)) w++;
+                for (bool grow = true; grow && y + h < n; ) {
+                    for (int i = 0; i < w && grow; ++i) grow = fits(x + i, y + h, z);
+                    if (grow) h++;
+                }
+                for (bool grow = true; grow && z + d < n; ) {
+                    for (int j = 0; j < h && grow; ++j)
+                        for (int i = 0; i < w && grow; ++i) grow = fits(x + i, y + j, z + d);
+                    if (grow) d++;
+                }
+                for (int k = 0; k < d; ++k)
+                    for (int j = 0; j < h; ++j)
+                        for (int i = 0; i < w; ++i) visited[index(x + i, y + j, z + k)] = true;
+                boxes.push_back({glm::vec3((float)x, (float)y, (float)z), glm::vec3((float)w, (float)h, (float)d), id});
+            }
+    return boxes;
+}
+
+TEST(ChunkIteration, ColliderBoxesMatchScanBuilder) {
+    for (SolidPattern pattern : ALL_PATTERNS) {
+        auto c = std::make_unique<Chunk>();
+        FillPattern(*c, pattern);
+        auto expected = ReferenceColliderBoxes(*c);
+        auto boxes = vortex::physics::VoxelColliderBuilder::Build(*c);
+        ASSERT_EQ(boxes.size(), expected.size()) << "pattern " << (int)pattern;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            EXPECT_TRUE(boxes[i].min == expected[i].min && boxes[i].size == expected[i].size &&
+                        boxes[i].materialID == expected[i].materialID) << "pattern " << (int)pattern << ", box " << i;
+        }
+    }
+}
+
+// Islands as sorted (x, y, z, id) lists plus the anchored flag, in a canonical order.
+using IslandKey = std::pair<std::vector<std::array<int, 4>>, bool>;
+
+static std::vector<IslandKey> CanonicalIslands(const std::vector<vortex::voxel::Island>& islands) {
+    std::vector<IslandKey> keys;
+    for (const auto& island : islands) {
+        IslandKey key{{}, island.isAnchored};
+        for (size_t v = 0; v < island.voxelPositions.size(); ++v) {
+            const glm::ivec3& p = island.voxelPositions[v];
+            key.first.push_back({p.x, p.y, p.z, island.materialIDs[v]});
+        }
+        std::sort(key.first.begin(), key.first.end());
+        keys.push_back(std::move(key));
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+TEST(ChunkIteration, ConnectivityMatchesScanFloodFill) {
+    using vortex::voxel::VoxelEntity;
+    using vortex::voxel::VoxelObject;
+    using vortex::voxel::SHREDSystem;
+
+    // Two parts side by side along x, so islands also connect across the part boundary.
+    auto entity = std::make_shared<VoxelEntity>();
+    for (int i = 0; i < 2; ++i) {
+        auto part = std::make_shared<VoxelObject>();
+        part->chunk = std::make_shared<Chunk>();
+        part->position = glm::vec3((float)(i * (int)CHUNK_SIZE), 0.0f, 0.0f);
+        FillPattern(*part->chunk, i == 0 ? SolidPattern::Sparse : SolidPattern::Edges);
+        part->chunk->FillBox({0, 4, 4}, {(int)CHUNK_SIZE, 6, 6}, 9);
+        entity->parts.push_back(part);
+    }
+
+    // Reference: GetVoxel scan of every part into entity space, then a 6-connected flood fill.
+    std::map<std::array<int, 3>, uint8_t> solids;
+    for (const auto& part : entity->parts) {
+        glm::ivec3 offset = glm::ivec3(part->position);
+        for (const auto& v : ScanSolids(*part->chunk)) solids[{offset.x + v[2], offset.y + v[1], offset.z + v[0]}] = (uint8_t)v[3];
+    }
+    std::vector<vortex::voxel::Island> expected;
+    std::map<std::array<int, 3>, bool> seen;
+    for (const auto& [start, id] : solids) {
+        if (seen[start]) continue;
+        vortex::voxel::Island island;
+        std::queue<std::array<int, 3>> queue;
+        queue.push(start);
+        seen[start] = true;
+        while (!queue.empty()) {
+            auto p = queue.front();
+            queue.pop();
+            island.voxelPositions.push_back(glm::ivec3(p[0], p[1], p[2]));
+            island.materialIDs.push_back(solids[p]);
+            if (SHREDSystem::CheckAnchoring(glm::vec3((float)p[0], (float)p[1], (float)p[2]))) island.isAnchored = true;
+            const int dirs[6][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+            for (const auto& d : dirs) {
+                std::array<int, 3> q = {p[0] + d[0], p[1] + d[1], p[2] + d[2]};
+                if (solids.count(q) && !seen[q]) {
+                    seen[q] = true;
+                    queue.push(q);
+                }
+            }
+        }
+        expected.push_back(std::move(island));
+    }
+    ASSERT_GT(expected.size(), 2u);
+
+    EXPECT_EQ(CanonicalIslands(SHREDSystem::AnalyzeConnectivity(entity)), CanonicalIslands(expected));
+}
+
+// --- TLAS ---
+
+// Walks the tree from the root: every node reached once, every instance in exactly one leaf with its exact
+// bounds, parents enclosing children, depth within the shader's stack.
+static void ExpectValidTLAS(const std::vector<GPUBVHNode>& nodes, const std::vector<InstanceBox>& boxes) {
+    std::vector<uint32_t> seenNode(nodes.size(), 0), seenInstance(boxes.size(), 0);
+    uint32_t maxDepth = 0;
+    std::function<void(uint32_t, uint32_t)> visit = [&](uint32_t n, uint32_t depth) {
+        ASSERT_LT(n, nodes.size());
+        seenNode[n]++;
+        maxDepth = std::max(maxDepth, depth);
+        const GPUBVHNode& node = nodes[n];
+        if (node.rightChildOrCount == TLASBuilder::LEAF_SENTINEL) {
+            ASSERT_LT(node.leftChildOrInstance, boxes.size());
+            seenInstance[node.leftChildOrInstance]++;
+            EXPECT_EQ(node.aabbMin, boxes[node.leftChildOrInstance].min);
+            EXPECT_EQ(node.aabbMax, boxes[node.leftChildOrInstance].max);
+            return;
+        }
+        for (uint32_t child : {node.leftChildOrInstance, node.rightChildOrCount}) {
+            ASSERT_LT(child, nodes.size());
+            for (int a = 0; a < 3; ++a) {
+                EXPECT_LE(node.aabbMin[a], nodes[child].aabbMin[a]);
+                EXPECT_GE(node.aabbMax[a], nodes[child].aabbMax[a]);
+            }
+            visit(child, depth + 1);
+        }
+    };
+    visit(0, 0);
+    for (uint32_t s : seenNode) EXPECT_EQ(s, 1u);
+    for (uint32_t s : seenInstance) EXPECT_EQ(s, 1u);
+    EXPECT_LE(maxDepth, TLASBuilder::MAX_DEPTH);
+}
+
+TEST(TLASBuilder, ValidTreeForEveryShape) {
+    TLASBuilder builder;
+    for (uint32_t count : {1u, 2u, 3u, 17u, 1000u, 5000u}) {
+        auto boxes = RandomInstances(count, count);
+        ExpectValidTLAS(BuildTLAS(builder, boxes), boxes);
+    }
+
+    // Identical instances: every split falls back to the median.
+    std::vector<InstanceBox> stacked(300, InstanceBox{glm::vec3(1.0f), glm::vec3(5.0f)});
+    ExpectValidTLAS(BuildTLAS(builder, stacked), stacked);
+
+    // Exponentially spaced instances make SAH peel one at a time; depth must still stay bounded.
+    std::vector<InstanceBox> line(200);
+    for (uint32_t i = 0; i < line.size(); ++i) {
+        float x = std::pow(1.25f, (float)i);
+        line[i] = {glm::vec3(x, 0.0f, 0.0f), glm::vec3(x + 1.0f, 1.0f, 1.0f)};
+    }
+    ExpectValidTLAS(BuildTLAS(builder, line), line);
+}
+
+TEST(TLASBuilder, ParallelBuildMatchesSerial) {
+    auto boxes = RandomInstances(20000, 7);
+    TLASBuilder builder;
+    auto serial = BuildTLAS(builder, boxes);
+    vortex::jobs::JobSystem::Initialize(4);
+    auto parallel = BuildTLAS(builder, boxes);
+    vortex::jobs::JobSystem::Shutdown();
+    ASSERT_EQ(serial.size(), parallel.size());
+    EXPECT_EQ(std::memcmp(serial.data(), parallel.data(), serial.size() * sizeof(GPUBVHNode)), 0);
+    ExpectValidTLAS(parallel, boxes);
+}
+
+TEST(TLASBuilder, RefitKeepsTreeValid) {
+    auto boxes = RandomInstances(5000, 3);
+    TLASBuilder builder;
+    auto nodes = BuildTLAS(builder, boxes);
+    const float builtCost = TLASBuilder::SAHCost(nodes.data(), (uint32_t)nodes.size());
+    EXPECT_FLOAT_EQ(builder.GetRefitDegradation(), 1.0f);
+
+    // Same bounds: nothing to write.
+    std::vector<uint32_t> touched;
+    builder.Refit(nodes.data(), 42, boxes[42].min, boxes[42].max, touched);
+    EXPECT_TRUE(touched.empty());
+
+    // Every tenth instance drifts a little (settling debris), then a few are flung across the world.
+    for (uint32_t i = 0; i < boxes.size(); i += 10) {
+        glm::vec3 offset((float)(i % 7) - 3.0f, 1.5f, (float)(i % 5) - 2.0f);
+        boxes[i] = {boxes[i].min + offset, boxes[i].max + offset};
+        builder.Refit(nodes.data(), i, boxes[i].min, boxes[i].max, touched);
+    }
+    ExpectValidTLAS(nodes, boxes);
+    // The incrementally tracked cost matches a recount.
+    EXPECT_NEAR(builder.GetRefitDegradation(), TLASBuilder::SAHCost(nodes.data(), (uint32_t)nodes.size()) / builtCost, 1e-3f);
+
+    float drifted = builder.GetRefitDegradation();
+    for (uint32_t i = 5; i < boxes.size(); i += 100) {
+        glm::vec3 offset = boxes[(i * 31) % boxes.size()].min - boxes[i].min;
+        boxes[i] = {boxes[i].min + offset, boxes[i].max + offset};
+        builder.Refit(nodes.data(), i, boxes[i].min, boxes[i].max, touched);
+    }
+    ExpectValidTLAS(nodes, boxes);
+    EXPECT_GT(builder.GetRefitDegradation(), drifted);
+}
+
+// --- Frustum Culling ---
+
+static std::vector<uint32_t> CullBoxes(const std::vector<InstanceBox>& boxes, const Frustum& frustum, bool simd) {
+    FrustumCuller culler;
+    culler.Reset((uint32_t)boxes.size());
+    for (uint32_t i = 0; i < boxes.size(); ++i) culler.SetBounds(i, boxes[i].min, boxes[i].max);
+    std::vector<uint32_t> visible;
+    if (simd) culler.Cull(frustum, visible);
+    else culler.CullScalar(frustum, visible);
+    return visible;
+}
+
+TEST(FrustumCuller, KnownBoxes) {
+    Frustum frustum = TestFrustum(glm::vec3(0.0f), 100.0f);
+    auto box = [](glm::vec3 c, float h) { return InstanceBox{c - glm::vec3(h), c + glm::vec3(h)}; };
+    std::vector<InstanceBox> boxes = {
+        box({0.0f, 0.0f, 50.0f}, 1.0f),     // 0: straight ahead
+        box({0.0f, 0.0f, -10.0f}, 1.0f),    // behind
+        box({0.0f, 0.0f, 150.0f}, 1.0f),    // past the far plane
+        box({60.0f, 0.0f, 50.0f}, 1.0f),    // right of the frustum
+        box({0.0f, -60.0f, 50.0f}, 1.0f),   // below it
+        box({50.5f, 0.0f, 50.0f}, 1.0f),    // 5: straddles the right plane
+        box({0.0f, 0.0f, 0.5f}, 1.0f),      // 6: straddles the near plane
+        box({0.0f, 0.0f, 100.5f}, 1.0f),    // 7: straddles the far plane
+    };
+    std::vector<uint32_t> expected = {0, 5, 6, 7};
+    EXPECT_EQ(CullBoxes(boxes, frustum, true), expected);
+    EXPECT_EQ(CullBoxes(boxes, frustum, false), expected);
+
+    // Counts that are not a multiple of the SIMD width must not report padding lanes.
+    for (size_t count : {0u, 1u, 3u, 5u}) {
+        std::vector<InstanceBox> prefix(boxes.begin(), boxes.begin() + count);
+        EXPECT_EQ(CullBoxes(prefix, frustum, true), CullBoxes(prefix, frustum, false));
+    }
+}
+
+TEST(FrustumCuller, SimdMatchesScalar) {
+    // A scene larger than the frustum, so a good share of boxes land on each side and on the planes.
+    auto boxes = RandomInstances(10001, 5);
+    Frustum frustum = SceneFrustum((uint32_t)boxes.size());
+    auto simd = CullBoxes(boxes, frustum, true);
+    EXPECT_EQ(simd, CullBoxes(boxes, frustum, false));
+    EXPECT_GT(simd.size(), 0u);
+    EXPECT_LT(simd.size(), boxes.size());
+
+    // Growing keeps earlier bounds, so only new or moved objects need SetBounds.
+    FrustumCuller culler;
+    culler.Reset(100);
+    for (uint32_t i = 0; i < 100; ++i) culler.SetBounds(i, boxes[i].min, boxes[i].max);
+    culler.Reset(200);
+    for (uint32_t i = 100; i < 200; ++i) culler.SetBounds(i, boxes[i].min, boxes[i].max);
+    std::vector<uint32_t> visible;
+    culler.Cull(frustum, visible);
+    EXPECT_EQ(visible, CullBoxes(std::vector<InstanceBox>(boxes.begin(), boxes.begin() + 200), frustum, false));
+}
+
+// --- Depth Sort ---
+
+TEST(DepthSorter, ExactMatchesStableSort) {
+    DepthSorter sorter;
+    for (uint32_t count : {0u, 1u, 5u, 64u, 65u, 1000u, 20000u}) {
+        auto depths = RandomDepths(count, count + 1);
+        if (count > 2) depths[2] = -1.0f;  // Clamped to 0.
+        auto items = Iota(count);
+        sorter.Sort(items, depths, DepthSortMode::Exact);
+
+        auto expected = Iota(count);
+        std::stable_sort(expected.begin(), expected.end(), [&](uint32_t a, uint32_t b) {
+            return std::max(depths[a], 0.0f) < std::max(depths[b], 0.0f);
+        });
+        EXPECT_EQ(items, expected) << count << " items";
+    }
+}
+
+TEST(DepthSorter, BucketsAreOrderedAndStable) {
+    DepthSorter sorter;
+    for (uint32_t count : {3u, 64u, 5000u}) {
+        auto depths = RandomDepths(count, count);
+        auto items = Iota(count);
+        sorter.Sort(items, depths, DepthSortMode::Buckets);
+
+        float lo = *std::min_element(depths.begin(), depths.end());
+        float hi = *std::max_element(depths.begin(), depths.end());
+        float bucket = (hi - lo) / (float)DepthSorter::BUCKET_COUNT;
+        auto sorted = items;
+        std::sort(sorted.begin(), sorted.end());
+        EXPECT_EQ(sorted, Iota(count));
+        for (uint32_t k = 1; k < count; ++k) {
+            // Out of order only within one bucket, and then in input order.
+            if (depths[items[k]] < depths[items[k - 1]]) {
+                EXPECT_LT(depths[items[k - 1]] - depths[items[k]], bucket * 1.001f);
+                EXPECT_GT(items[k], items[k - 1]);
+            }
+        }
+    }
+
+    // All depths equal: nothing moves.
+    std::vector<float> flat(100, 3.0f);
+    auto items = Iota(100);
+    sorter.Sort(items, flat, DepthSortMode::Buckets);
+    EXPECT_EQ(items, Iota(100));
+}
+
+// --- Chunk Slots ---
+
+// Chunks are identified by address only; the allocator never reads them.
+static std::vector<Chunk*> Pick(std::vector<Chunk>& pool, std::initializer_list<int> indices) {
+    std::vector<Chunk*> live;
+    for (int i : indices) live.push_back(&pool[i]);
+    return live;
+}
+
+TEST(ChunkSlotAllocator, ReusesLowestHole) {
+    std::vector<Chunk> pool(8);
+    ChunkSlotAllocator slots;
+    slots.SetCapacity(8);
+    std::vector<uint32_t> out;
+    std::vector<uint8_t> resident;
+
+    slots.Assign(Pick(pool, {0, 1, 2, 3}), out, resident);
+    EXPECT_EQ(out, (std::vector<uint32_t>{0, 1, 2, 3}));
+    EXPECT_EQ(resident, (std::vector<uint8_t>{0, 0, 0, 0}));
+
+    // Chunks 1 and 2 are gone; their slots are holes below the still used slot 3.
+    slots.Assign(Pick(pool, {0, 3}), out, resident);
+    EXPECT_EQ(out, (std::vector<uint32_t>{0, 3}));
+    EXPECT_EQ(resident, (std::vector<uint8_t>{1, 1}));
+    EXPECT_EQ(slots.SlotOf(&pool[1]), ChunkSlotAllocator::INVALID_SLOT);
+    EXPECT_EQ(slots.GetStats().used, 2u);
+    EXPECT_EQ(slots.GetStats().end, 4u);
+    EXPECT_FLOAT_EQ(slots.GetStats().Fragmentation(), 0.5f);
+
+    // New chunks fill the holes lowest first, then extend the range; a returning chunk is new again.
+    slots.Assign(Pick(pool, {4, 0, 5, 3, 1}), out, resident);
+    EXPECT_EQ(out, (std::vector<uint32_t>{1, 0, 2, 3, 4}));
+    EXPECT_EQ(resident, (std::vector<uint8_t>{0, 1, 0, 1, 0}));
+    EXPECT_EQ(slots.GetStats().end, 5u);
+}
+
+TEST(ChunkSlotAllocator, DuplicateChunkSharesSlot) {
+    std::vector<Chunk> pool(2);
+    ChunkSlotAllocator slots;
+    slots.SetCapacity(4);
+    std::vector<uint32_t> out;
+    std::vector<uint8_t> resident;
+
+    // Only the first entry of a repeated chunk is written whole.
+    slots.Assign(Pick(pool, {0, 0, 1}), out, resident);
+    EXPECT_EQ(out, (std::vector<uint32_t>{0, 0, 1}));
+    EXPECT_EQ(resident, (std::vector<uint8_t>{0, 1, 0}));
+    EXPECT_EQ(slots.GetStats().used, 2u);
+
+    slots.Assign(Pick(pool, {1, 0, 1}), out, resident);
+    EXPECT_EQ(out, (std::vector<uint32_t>{1, 0, 1}));
+    EXPECT_EQ(resident, (std::vector<uint8_t>{1, 1, 1}));
+    EXPECT_EQ(slots.GetStats().end, 2u);
+}
+
+TEST(ChunkSlotAllocator, TrimsFreeSlotsAtTheEnd) {
+    std::vector<Chunk> pool(4);
+    ChunkSlotAllocator slots;
+    slots.SetCapacity(4);
+    std::vector<uint32_t> out;
+    std::vector<uint8_t> resident;
+
+    slots.Assign(Pick(pool, {0, 1, 2, 3}), out, resident);
+    // Slot 3 is free at the top and is trimmed; slot 1 stays a hole below slot 2.
+    slots.Assign(Pick(pool, {0, 2}), out, resident);
+    EXPECT_EQ(slots.GetStats().end, 3u);
+    EXPECT_EQ(slots.GetStats().used, 2u);
+    // Freeing slot 2 exposes the hole at 1, which is trimmed with it.
+    slots.Assign(Pick(pool, {0}), out, resident);
+    EXPECT_EQ(slots.GetStats().end, 1u);
+    EXPECT_FLOAT_EQ(slots.GetStats().Fragmentation(), 0.0f);
+    // Trimmed slots are handed out in order again.
+    slots.Assign(Pick(pool, {0, 3, 1}), out, resident);
+    EXPECT_EQ(out, (std::vector<uint32_t>{0, 1, 2}));
+
+    slots.Assign({}, out, resident);
+    EXPECT_EQ(slots.GetStats().end, 0u);
+    EXPECT_EQ(slots.GetStats().used, 0u);
+}
+
+TEST(ChunkSlotAllocator, FullBufferAndCapacity) {
+    std::vector<Chunk> pool(3);
+    ChunkSlotAllocator slots;
+    slots.SetCapacity(2);
+    std::vector<uint32_t> out;
+    std::vector<uint8_t> resident;
+
+    slots.Assign(Pick(pool, {0, 1, 2}), out, resident);
+    EXPECT_EQ(out, (std::vector<uint32_t>{0, 1, ChunkSlotAllocator::INVALID_SLOT}));
+    EXPECT_EQ(slots.GetStats().used, 2u);
+
+    // Shrinking below the used range is refused; growing keeps every slot.
+    EXPECT_FALSE(slots.SetCapacity(1));
+    EXPECT_EQ(slots.GetStats().capacity, 2u);
+    EXPECT_TRUE(slots.SetCapacity(3));
+    slots.Assign(Pick(pool, {0, 1, 2}), out, resident);
+    EXPECT_EQ(out, (std::vector<uint32_t>{0, 1, 2}));
+    EXPECT_EQ(resident, (std::vector<uint8_t>{1, 1, 0}));
+
+    slots.Clear();
+    EXPECT_EQ(slots.SlotOf(&pool[0]), ChunkSlotAllocator::INVALID_SLOT);
+    EXPECT_TRUE(slots.SetCapacity(1));
+}
+
+TEST(ChunkSlotAllocator, CompactMovesTopChunksIntoHoles) {
+    const uint32_t count = 300;
+    std::vector<Chunk> pool(count);
+    std::vector<Chunk*> all, odd;
+    for (uint32_t i = 0; i < count; ++i) {
+        all.push_back(&pool[i]);
+        if (i & 1) odd.push_back(&pool[i]);
+    }
+    ChunkSlotAllocator slots;
+    slots.SetCapacity(count);
+    std::vector<uint32_t> out;
+    std::vector<uint8_t> resident;
+    slots.Assign(all, out, resident);
+
+    // Every even slot is a hole; packing the 150 survivors takes 75 moves of top chunks.
+    slots.Assign(odd, out, resident);
+    EXPECT_EQ(slots.GetStats().end, count);
+    float fragmentation = slots.GetStats().Fragmentation();
+    EXPECT_FLOAT_EQ(fragmentation, 0.5f);
+
+    auto check = [&](uint32_t moved) {
+        uint32_t rewritten = 0;
+        std::vector<uint8_t> taken(slots.GetStats().end, 0);
+        for (size_t i = 0; i < odd.size(); ++i) {
+            ASSERT_LT(out[i], slots.GetStats().end);
+            EXPECT_EQ(out[i], slots.SlotOf(odd[i]));
+            EXPECT_FALSE(taken[out[i]]) << "slot " << out[i] << " assigned twice";
+            taken[out[i]] = 1;
+            rewritten += resident[i] ? 0 : 1;
+        }
+        // Exactly the moved chunks must be written whole.
+        EXPECT_EQ(rewritten, moved);
+    };
+
+    uint32_t moved = slots.Compact(odd, 64, out, resident);
+    EXPECT_EQ(moved, 64u);
+    check(moved);
+    EXPECT_LT(slots.GetStats().Fragmentation(), fragmentation);
+    EXPECT_GT(slots.GetStats().Fragmentation(), 0.0f);
+
+    slots.Assign(odd, out, resident);
+    moved = slots.Compact(odd, 64, out, resident);
+    EXPECT_EQ(moved, 11u);
+    check(moved);
+    EXPECT_EQ(slots.GetStats().end, 150u);
+    EXPECT_FLOAT_EQ(slots.GetStats().Fragmentation(), 0.0f);
+
+    // Packed: nothing left to move.
+    slots.Assign(odd, out, resident);
+    EXPECT_EQ(slots.Compact(odd, 64, out, resident), 0u);
+}
+
+TEST(ChunkSlotAllocator, ShrinksAtAQuarter) {
+    std::vector<Chunk> pool(17);
+    std::vector<Chunk*> live;
+    for (auto& chunk : pool) live.push_back(&chunk);
+    ChunkSlotAllocator slots;
+    slots.SetCapacity(64);
+    std::vector<uint32_t> out;
+    std::vector<uint8_t> resident;
+
+    // 17 slots of 64 is over a quarter: no shrink. At 16 the capacity halves.
+    slots.Assign(live, out, resident);
+    EXPECT_EQ(slots.ShrinkTarget(8), 64u);
+    live.pop_back();
+    slots.Assign(live, out, resident);
+    EXPECT_EQ(slots.ShrinkTarget(8), 32u);
+    EXPECT_TRUE(slots.SetCapacity(slots.ShrinkTarget(8)));
+    EXPECT_EQ(slots.SlotOf(live.back()), 15u);
+
+    // Never below the floor, and not at all once at it.
+    slots.Assign({}, out, resident);
+    EXPECT_EQ(slots.ShrinkTarget(24), 24u);
+    EXPECT_EQ(slots.ShrinkTarget(32), 32u);
+    EXPECT_EQ(slots.ShrinkTarget(64), 32u);
+}
+
+// --- Job System ---
+
+// Runs fn with a pool of `workers`, shutting it down afterwards even if an assertion fails.
+template<typename Fn>
+static void WithJobSystem(uint32_t workers, const Fn& fn) {
+    JobSystem::Initialize(workers);
+    struct Guard { ~Guard() { JobSystem::Shutdown(); } } guard;
+    fn();
+}
+
+TEST(JobSystem, InlineWhenNotInitialized) {
+    ASSERT_FALSE(JobSystem::IsInitialized());
+    EXPECT_EQ(JobSystem::GetCurrentWorkerIndex(), -1);
+
+    std::thread::id ranOn;
+    TaskGroup group;
+    group.Run([&] { ranOn = std::this_thread::get_id(); });
+    EXPECT_EQ(ranOn, std::this_thread::get_id());
+    EXPECT_TRUE(group.IsDone());
+    EXPECT_FALSE(JobSystem::RunPendingTask());
+
+    std::vector<std::pair<size_t, size_t>> ranges;
+    JobSystem::ParallelFor(100, 10, [&](size_t begin, size_t end) { ranges.push_back({begin, end}); });
+    EXPECT_EQ(ranges, (std::vector<std::pair<size_t, size_t>>{{0, 100}}));
+}
+
+TEST(JobSystem, ParallelForCoversEveryIndexOnce) {
+    WithJobSystem(4, [] {
+        for (size_t count : {0u, 1u, 7u, 1000u, 4097u}) {
+            for (size_t grain : {0u, 1u, 16u, 5000u}) {
+                std::vector<std::atomic<uint32_t>> hits(count);
+                std::atomic<bool> emptyRange{false};
+                JobSystem::ParallelFor(count, grain, [&](size_t begin, size_t end) {
+                    if (begin >= end) emptyRange = true;
+                    for (size_t i = begin; i < end; ++i) hits[i].fetch_add(1, std::memory_order_relaxed);
+                });
+                EXPECT_FALSE(emptyRange) << count << " / " << grain;
+                for (size_t i = 0; i < count; ++i) ASSERT_EQ(hits[i].load(), 1u) << "index " << i << " of " << count << " / " << grain;
+            }
+        }
+    });
+}
+
+TEST(JobSystem, NestedWaitInsideTasks) {
+    // More waiting tasks than workers: waits must run other tasks instead of blocking.
+    WithJobSystem(2, [] {
+        std::atomic<uint32_t> done{0};
+        TaskGroup outer;
+        for (int i = 0; i < 16; ++i) {
+            outer.Run([&] {
+                TaskGroup inner;
+                for (int j = 0; j < 16; ++j) inner.Run([&] { done.fetch_add(1, std::memory_order_relaxed); });
+                inner.Wait();
+                EXPECT_TRUE(inner.IsDone());
+            });
+        }
+        outer.Wait();
+        EXPECT_EQ(done.load(), 256u);
+
+        // Nested ParallelFor, as the TLAS builder and collider cooking do.
+        std::atomic<size_t> sum{0};
+        JobSystem::ParallelFor(64, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                JobSystem::ParallelFor(64, 8, [&](size_t b, size_t e) { sum.fetch_add(e - b, std::memory_order_relaxed); });
+            }
+        });
+        EXPECT_EQ(sum.load(), 64u * 64u);
+    });
+}
+
+TEST(JobSystem, SubmitFromWorkersAndExternalThreads) {
+    WithJobSystem(3, [] {
+        std::atomic<uint32_t> external{0}, nested{0};
+        TaskGroup group;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                EXPECT_EQ(JobSystem::GetCurrentWorkerIndex(), -1);
+                for (int i = 0; i < 250; ++i) {
+                    group.Run([&] {
+                        external.fetch_add(1, std::memory_order_relaxed);
+                        // Submitted from whichever thread runs this task: a worker's own queue, or the injection queue.
+                        group.Run([&] { nested.fetch_add(1, std::memory_order_relaxed); });
+                    });
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        group.Wait();
+        EXPECT_EQ(external.load(), 1000u);
+        EXPECT_EQ(nested.load(), 1000u);
+
+        // The main thread spins without running tasks, so this one surely lands on a worker and its
+        // submissions go to that worker's own queue.
+        std::atomic<int32_t> worker{-2};
+        std::atomic<bool> submitted{false};
+        JobSystem::Submit([&] {
+            worker = JobSystem::GetCurrentWorkerIndex();
+            for (int i = 0; i < 100; ++i) group.Run([&] { nested.fetch_add(1, std::memory_order_relaxed); });
+            submitted = true;
+        });
+        while (!submitted) std::this_thread::yield();
+        group.Wait();
+        EXPECT_GE(worker.load(), 0);
+        EXPECT_LT(worker.load(), 3);
+        EXPECT_EQ(nested.load(), 1100u);
+    });
+}
+
+TEST(JobSystem, ShutdownDrainsQueuedTasks) {
+    std::atomic<uint32_t> done{0}, followUps{0};
+    JobSystem::Initialize(2);
+    EXPECT_EQ(JobSystem::GetWorkerCount(), 2u);
+    for (int i = 0; i < 2000; ++i) {
+        JobSystem::Submit([&, i] {
+            done.fetch_add(1, std::memory_order_relaxed);
+            // Follow-up work queued while the pool is shutting down still runs.
+            if (i % 100 == 0) JobSystem::Submit([&] { followUps.fetch_add(1, std::memory_order_relaxed); });
+        });
+    }
+    JobSystem::Shutdown();
+    EXPECT_FALSE(JobSystem::IsInitialized());
+    EXPECT_EQ(JobSystem::GetWorkerCount(), 0u);
+    EXPECT_EQ(done.load(), 2000u);
+    EXPECT_EQ(followUps.load(), 20u);
+
+    // The pool can start again afterwards.
+    WithJobSystem(1, [&] {
+        TaskGroup group;
+        group.Run([&] { done = 7; });
+        group.Wait();
+        EXPECT_EQ(done.load(), 7u);
+    });
+}
+
+
+// --- Physics Queries ---
+
+using vortex::physics::PhysicsSystem;
+using vortex::physics::PhysicsConfig;
+using vortex::physics::BodyHandle;
+
+struct PartBox { glm::ivec3 position, min, max; };
+
+// Entity at `position` with one part per box, each filling [min, max) of its own chunk.
+static std::shared_ptr<vortex::voxel::VoxelEntity> BoxEntity(glm::vec3 position, std::initializer_list<PartBox> boxes) {
+    auto entity = std::make_shared<vortex::voxel::VoxelEntity>();
+    entity->transform[3] = glm::vec4(position, 1.0f);
+    for (const PartBox& box : boxes) {
+        auto part = std::make_shared<vortex::voxel::VoxelObject>();
+        part->chunk = std::make_shared<Chunk>();
+        part->position = glm::vec3(box.position);
+        part->chunk->FillBox(box.min, box.max, 1);
+        entity->parts.push_back(part);
+    }
+    entity->RecalculateStats();
+    return entity;
+}
+
+static std::vector<uint32_t> SortedIds(std::span<const BodyHandle> bodies) {
+    std::vector<uint32_t> ids;
+    for (const BodyHandle& b : bodies) ids.push_back(b.id);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+// Runs fn with a physics world on a two-worker pool. Jolt runs headless, so this needs no device.
+template<typename Fn>
+static void WithPhysics(const PhysicsConfig& config, const Fn& fn) {
+    WithJobSystem(2, [&] {
+        PhysicsSystem physics;
+        physics.Initialize(config);
+        fn(physics);
+        physics.Shutdown();
+    });
+}
+
+TEST(PhysicsQueries, RayHitsResolveBodyPointNormalAndVoxel) {
+    using vortex::physics::Ray;
+    using vortex::physics::RayHit;
+
+    WithPhysics({}, [](PhysicsSystem& physics) {
+        // A: 4^3 cube at world x 10..14. B: two parts, the second offset by 8 along x (world x 9..11, z 20..22).
+        BodyHandle a = physics.AddBody(BoxEntity({10, 0, 0}, {{{0, 0, 0}, {0, 0, 0}, {4, 4, 4}}}), true);
+        BodyHandle b = physics.AddBody(BoxEntity({0, 0, 20}, {{{0, 0, 0}, {0, 0, 0}, {2, 2, 2}},
+                                                              {{8, 0, 0}, {1, 0, 0}, {3, 2, 2}}}), true);
+        ASSERT_TRUE(a.IsValid());
+        ASSERT_TRUE(b.IsValid());
+
+        std::vector<Ray> rays = {
+            {{0.0f, 2.5f, 2.5f}, {1, 0, 0}, 100.0f},   // Front face of A.
+            {{10.5f, 10.0f, 21.5f}, {0, -1, 0}, 100.0f}, // Top of B's offset part.
+            {{0.0f, 50.0f, 0.0f}, {0, 1, 0}, 100.0f},  // Pointing away from everything.
+            {{0.0f, 2.5f, 2.5f}, {1, 0, 0}, 5.0f},     // Toward A, but too short to reach it.
+        };
+        std::vector<RayHit> hits;
+        physics.CastRays(rays, hits);
+        ASSERT_EQ(hits.size(), rays.size());
+
+        ASSERT_TRUE(hits[0].IsHit());
+        EXPECT_EQ(hits[0].body.id, a.id);
+        EXPECT_NEAR(hits[0].distance, 10.0f, 1e-3f);
+        EXPECT_NEAR(hits[0].point.x, 10.0f, 1e-3f);
+        EXPECT_NEAR(hits[0].point.y, 2.5f, 1e-3f);
+        EXPECT_NEAR(hits[0].point.z, 2.5f, 1e-3f);
+        EXPECT_NEAR(hits[0].normal.x, -1.0f, 1e-3f);
+        EXPECT_NEAR(hits[0].normal.y, 0.0f, 1e-3f);
+        EXPECT_NEAR(hits[0].normal.z, 0.0f, 1e-3f);
+        EXPECT_EQ(hits[0].partIndex, 0);
+        EXPECT_EQ(hits[0].voxel, glm::ivec3(0, 2, 2));
+
+        ASSERT_TRUE(hits[1].IsHit());
+        EXPECT_EQ(hits[1].body.id, b.id);
+        EXPECT_NEAR(hits[1].distance, 8.0f, 1e-3f);
+        EXPECT_NEAR(hits[1].point.y, 2.0f, 1e-3f);
+        EXPECT_NEAR(hits[1].normal.y, 1.0f, 1e-3f);
+        EXPECT_EQ(hits[1].partIndex, 1);
+        EXPECT_EQ(hits[1].voxel, glm::ivec3(2, 1, 1)); // Part-local: entity x 10.5 minus the part offset 8.
+
+        for (size_t i : {size_t(2), size_t(3)}) {
+            EXPECT_FALSE(hits[i].IsHit()) << "ray " << i;
+            EXPECT_EQ(hits[i].partIndex, -1);
+            EXPECT_EQ(hits[i].voxel, glm::ivec3(-1));
+        }
+    });
+}
+
+TEST(PhysicsQueries, OverlapsReportEachBodyOnce) {
+    using vortex::physics::SphereQuery;
+    using vortex::physics::BoxQuery;
+    using vortex::physics::OverlapResults;
+
+    WithPhysics({}, [](PhysicsSystem& physics) {
+        BodyHandle a = physics.AddBody(BoxEntity({10, 0, 0}, {{{0, 0, 0}, {0, 0, 0}, {4, 4, 4}}}), true);
+        // Two parts far enough apart to be separate sub shapes of one compound body.
+        BodyHandle b = physics.AddBody(BoxEntity({0, 0, 20}, {{{0, 0, 0}, {0, 0, 0}, {2, 2, 2}},
+                                                              {{8, 0, 0}, {1, 0, 0}, {3, 2, 2}}}), true);
+        ASSERT_TRUE(a.IsValid());
+        ASSERT_TRUE(b.IsValid());
+        const std::vector<uint32_t> none, onlyA = {a.id}, onlyB = {b.id}, both = SortedIds(std::vector<BodyHandle>{a, b});
+
+        std::vector<SphereQuery> spheres = {
+            {{12.0f, 2.0f, 2.0f}, 1.0f},   // Inside A.
+            {{10.0f, 1.0f, 21.0f}, 0.5f},  // Inside B's offset part.
+            {{-20.0f, 0.0f, 0.0f}, 2.0f},  // Empty space.
+            {{8.0f, 2.0f, 10.0f}, 20.0f},  // Everything.
+        };
+        OverlapResults sphereHits;
+        physics.OverlapSphere(spheres, sphereHits);
+        ASSERT_EQ(sphereHits.QueryCount(), spheres.size());
+        EXPECT_EQ(SortedIds(sphereHits.Get(0)), onlyA);
+        EXPECT_EQ(SortedIds(sphereHits.Get(1)), onlyB);
+        EXPECT_EQ(SortedIds(sphereHits.Get(2)), none);
+        EXPECT_EQ(SortedIds(sphereHits.Get(3)), both);
+
+        // 90 degrees about y: swaps the box's x and z extents.
+        const glm::quat quarterTurn(std::sqrt(0.5f), 0.0f, std::sqrt(0.5f), 0.0f);
+        std::vector<BoxQuery> boxes = {
+            {{5.5f, 1.0f, 21.0f}, {5.0f, 0.5f, 0.5f}},            // Spans both parts of B: B once.
+            {{7.5f, 1.0f, 1.0f}, {3.0f, 0.5f, 0.5f}},             // x 4.5..10.5 reaches into A.
+            {{7.5f, 1.0f, 1.0f}, {3.0f, 0.5f, 0.5f}, quarterTurn}, // Same box turned along z: x 7..8 misses A.
+        };
+        OverlapResults boxHits;
+        physics.OverlapBox(boxes, boxHits);
+        ASSERT_EQ(boxHits.QueryCount(), boxes.size());
+        EXPECT_EQ(SortedIds(boxHits.Get(0)), onlyB);
+        EXPECT_EQ(SortedIds(boxHits.Get(1)), onlyA);
+        EXPECT_EQ(SortedIds(boxHits.Get(2)), none);
+    });
+}
+
+// --- Physics Layers and Stats ---
+
+// Four bodies that all overlap each other: a static 2^3 cube, two dynamic 2^3 cubes (8 voxels, debris-sized)
+// and a dynamic 3^3 cube (27 voxels). Six body pairs, one of them debris vs debris.
+static std::vector<BodyHandle> AddOverlappingBodies(PhysicsSystem& physics) {
+    std::vector<BodyHandle> bodies = {
+        physics.AddBody(BoxEntity({0.0f, -1.0f, 0.0f}, {{{0, 0, 0}, {0, 0, 0}, {2, 2, 2}}}), true),
+        physics.AddBody(BoxEntity({0.0f, 0.0f, 0.0f}, {{{0, 0, 0}, {0, 0, 0}, {2, 2, 2}}}), false),
+        physics.AddBody(BoxEntity({1.0f, 0.5f, 0.0f}, {{{0, 0, 0}, {0, 0, 0}, {2, 2, 2}}}), false),
+        physics.AddBody(BoxEntity({0.5f, 0.5f, 0.5f}, {{{0, 0, 0}, {0, 0, 0}, {3, 3, 3}}}), false),
+    };
+    for (const BodyHandle& b : bodies) EXPECT_TRUE(b.IsValid());
+    return bodies;
+}
+
+TEST(PhysicsLayers, DebrisPairFiltering) {
+    struct Case { uint32_t debrisMaxVoxels; bool debrisVsDebris; uint32_t expectedPairs; };
+    const Case cases[] = {
+        {0, false, 6}, // Debris layer off: every dynamic body is regular.
+        {8, false, 5}, // The two small cubes are debris and skip each other, but still hit the others.
+        {8, true, 6},  // Debris vs debris enabled.
+    };
+
+    for (const Case& c : cases) {
+        PhysicsConfig config;
+        config.debrisMaxVoxels = c.debrisMaxVoxels;
+        config.debrisCollidesWithDebris = c.debrisVsDebris;
+        WithPhysics(config, [&](PhysicsSystem& physics) {
+            AddOverlappingBodies(physics);
+            physics.Update(1.0f / 60.0f); // One collision step, so the pairs are those of the starting overlap.
+
+            auto stats = physics.GetStats();
+            EXPECT_EQ(stats.bodyPairs, c.expectedPairs) << "debrisMaxVoxels " << c.debrisMaxVoxels << ", debrisVsDebris " << c.debrisVsDebris;
+            EXPECT_GE(stats.contactConstraints, c.expectedPairs);
+            EXPECT_EQ(stats.capacityErrors, 0u);
+        });
+    }
+}
+
+TEST(PhysicsStats, RuntimeCapacities) {
+    PhysicsConfig config;
+    config.maxBodies = 3;
+    config.tempAllocatorSize = 2 * 1024 * 1024;
+    WithPhysics(config, [&](PhysicsSystem& physics) {
+        EXPECT_EQ(physics.GetConfig().maxBodies, 3u);
+        EXPECT_EQ(physics.GetConfig().tempAllocatorSize, config.tempAllocatorSize);
+
+        auto cube = [] { return BoxEntity({0, 0, 0}, {{{0, 0, 0}, {0, 0, 0}, {1, 1, 1}}}); };
+        for (int i = 0; i < 3; ++i) EXPECT_TRUE(physics.AddBody(cube(), true).IsValid());
+        EXPECT_FALSE(physics.AddBody(cube(), true).IsValid()); // Body limit reached.
+
+        auto stats = physics.GetStats();
+        EXPECT_EQ(stats.bodyCount, 3u);
+        EXPECT_EQ(stats.tempAllocatorCapacity, config.tempAllocatorSize);
+    });
+
+    // Six overlapping pairs do not fit two contact constraints: reported, not fatal.
+    config = {};
+    config.maxBodyPairs = 2;
+    config.maxContactConstraints = 2;
+    WithPhysics(config, [&](PhysicsSystem& physics) {
+        AddOverlappingBodies(physics);
+        physics.Update(1.0f / 60.0f);
+        EXPECT_GE(physics.GetStats().capacityErrors, 1u);
+        physics.Update(1.0f / 60.0f);
+        EXPECT_GE(physics.GetStats().capacityErrors, 2u);
+    });
+}
+
+TEST(PhysicsStats, HighWaterMarks) {
+    WithPhysics({}, [](PhysicsSystem& physics) {
+        auto bodies = AddOverlappingBodies(physics);
+        physics.Update(1.0f / 60.0f);
+
+        auto busy = physics.GetStats();
+        EXPECT_EQ(busy.bodyCount, 4u);
+        EXPECT_EQ(busy.bodyPairs, 6u);
+        EXPECT_EQ(busy.bodyPairsPeak, busy.bodyPairs);
+        EXPECT_GT(busy.contactConstraints, 0u);
+        EXPECT_EQ(busy.contactConstraintsPeak, busy.contactConstraints);
+        EXPECT_GT(busy.tempAllocatorUsagePeak, 0u);
+        EXPECT_LE(busy.tempAllocatorUsagePeak, busy.tempAllocatorCapacity);
+        EXPECT_EQ(busy.tempAllocatorFallbacks, 0u);
+
+        // An empty world clears the per-step counters but keeps the peaks.
+        for (const BodyHandle& b : bodies) physics.RemoveBody(b);
+        physics.Update(1.0f / 60.0f);
+
+        auto idle = physics.GetStats();
+        EXPECT_EQ(idle.bodyCount, 0u);
+        EXPECT_EQ(idle.activeBodyCount, 0u);
+        EXPECT_EQ(idle.bodyPairs, 0u);
+        EXPECT_EQ(idle.contactConstraints, 0u);
+        EXPECT_EQ(idle.bodyPairsPeak, busy.bodyPairsPeak);
+        EXPECT_EQ(idle.contactConstraintsPeak, busy.contactConstraintsPeak);
+        EXPECT_GE(idle.tempAllocatorUsagePeak, busy.tempAllocatorUsagePeak);
+    });
+
+    // A temp allocator too small for one update overflows into malloc and counts it.
+    PhysicsConfig config;
+    config.tempAllocatorSize = 1024;
+    WithPhysics(config, [](PhysicsSystem& physics) {
+        AddOverlappingBodies(physics);
+        physics.Update(1.0f / 60.0f);
+
+        auto stats = physics.GetStats();
+        EXPECT_GT(stats.tempAllocatorFallbacks, 0u);
+        EXPECT_GT(stats.tempAllocatorUsagePeak, stats.tempAllocatorCapacity);
+        EXPECT_EQ(stats.capacityErrors, 0u);
+    });
+}
+
+// --- Physics Activation ---
+
+TEST(PhysicsActivation, SleepingBodiesReportFinalPoseOnce) {
+    using vortex::physics::ActiveTransformBuffer;
+
+    WithPhysics({}, [](PhysicsSystem& physics) {
+        // Floor slab with its top at y = 0, and three 2^3 cubes dropped from y = 1, apart from each other.
+        const int floorSize = (int)CHUNK_SIZE;
+        physics.AddBody(BoxEntity({-8, -1, -8}, {{{0, 0, 0}, {0, 0, 0}, {floorSize, 1, floorSize}}}), true);
+        auto entityA = BoxEntity({0, 1, 0}, {{{0, 0, 0}, {0, 0, 0}, {2, 2, 2}}});
+        BodyHandle a = physics.AddBody(entityA, false); // Sleeps and is read one last time.
+        BodyHandle c = physics.AddBody(BoxEntity({0, 1, 4}, {{{0, 0, 0}, {0, 0, 0}, {2, 2, 2}}}), false); // Removed while awake.
+        BodyHandle d = physics.AddBody(BoxEntity({4, 1, 0}, {{{0, 0, 0}, {0, 0, 0}, {2, 2, 2}}}), false); // Removed as it falls asleep.
+        ASSERT_TRUE(a.IsValid() && c.IsValid() && d.IsValid());
+
+        auto find = [](const ActiveTransformBuffer& snapshot, BodyHandle body, size_t& index) {
+            size_t found = 0;
+            for (size_t i = 0; i < snapshot.Size(); ++i) {
+                if (snapshot.bodies[i].id == body.id) { index = i; found++; }
+            }
+            return found;
+        };
+
+        ActiveTransformBuffer snapshot;
+        bool removedC = false, removedD = false;
+        int stepsAsleep = 0;
+        for (int step = 0; step < 600 && stepsAsleep < 30; ++step) {
+            physics.Update(1.0f / 60.0f);
+
+            if (step == 5) {
+                ASSERT_TRUE(physics.IsBodyActive(c));
+                physics.RemoveBody(c);
+                removedC = true;
+            }
+            // Fell asleep in this update, so the activation listener still holds it for the next read.
+            if (!removedD && !physics.IsBodyActive(d)) {
+                physics.RemoveBody(d);
+                removedD = true;
+            }
+
+            physics.ReadActiveTransforms(snapshot);
+            ASSERT_EQ(snapshot.positions.size(), snapshot.Size());
+            ASSERT_EQ(snapshot.rotations.size(), snapshot.Size());
+
+            size_t index = 0;
+            if (removedC) {
+                EXPECT_EQ(find(snapshot, c, index), 0u) << "step " << step;
+            }
+            if (removedD) {
+                EXPECT_EQ(find(snapshot, d, index), 0u) << "step " << step;
+            }
+
+            size_t seen = find(snapshot, a, index);
+            if (physics.IsBodyActive(a)) {
+                ASSERT_EQ(stepsAsleep, 0) << "woke up again at step " << step;
+                EXPECT_EQ(seen, 1u) << "step " << step;
+            } else if (stepsAsleep++ == 0) {
+                // The update it fell asleep in: its resting pose is read exactly once more.
+                ASSERT_EQ(seen, 1u) << "step " << step;
+                physics.SyncBodyTransform(entityA, a);
+                EXPECT_EQ(snapshot.positions[index], glm::vec3(entityA->transform[3]));
+                EXPECT_NEAR(snapshot.positions[index].y, 0.0f, 0.05f);
+            } else {
+                EXPECT_EQ(seen, 0u) << "step " << step;
+            }
+        }
+
+        EXPECT_EQ(stepsAsleep, 30) << "body never fell asleep";
+        EXPECT_TRUE(removedC);
+        EXPECT_TRUE(removedD);
+        EXPECT_EQ(physics.GetActiveBodyCount(), 0u);
+        EXPECT_EQ(physics.GetStats().bodyCount, 2u);
+    });
+}